@@ -57,6 +57,7 @@ uint Depth(SImage::EDataType Type)
       return 8;
    case SImage::U16:
    case SImage::S16:
+   case SImage::F16:
       return 16;
    case SImage::U32:
    case SImage::S32:
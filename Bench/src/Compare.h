@@ -30,7 +30,8 @@ bool AbsDiff(const CSimpleImage& Source1, const CSimpleImage& Source2, CSimpleIm
    if (Source1.Type != Dest.Type)
       return false;
 
-   IppiSize Roi = {Dest.Width, Dest.Height};
+   // The channels of packed multi-channel images are compared like a wider 1 channel image
+   IppiSize Roi = {Dest.Width * Dest.Channels, Dest.Height};
 
    switch (Source1.Type)
    {
@@ -58,7 +59,7 @@ bool AbsDiff(const CSimpleImage& Source1, const CSimpleImage& Source2, CSimpleIm
 
 float FindMax(const CSimpleImage& Source, SPoint Offset, SSize RoiSize, SPoint& Index)
 {
-   IppiSize Roi = {RoiSize.Width, RoiSize.Height};
+   IppiSize Roi = {RoiSize.Width * Source.Channels, RoiSize.Height};
    Ipp8u V8 = 0;
    Ipp16u V16 = 0;
    Ipp32f VF = 0;
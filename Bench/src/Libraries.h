@@ -24,6 +24,7 @@
 
 // OpenCLIPP
 #include <OpenCLIPP.h>
+#include <OpenCLIPP.hpp>   // C++ interface, for Fusion
 
 
 #ifdef HAS_NPP
@@ -27,6 +27,7 @@
 
 #include "benchBase.hpp"
 #include "benchArithmetic.hpp"
+#include "benchTreshold.hpp"
 #include "benchStatistics.hpp"
 #include "benchMorphoBase.hpp"
 #include "benchTopHat3x3.hpp"
@@ -40,10 +41,14 @@
 #include "benchLinearLut.hpp"
 #include "benchTransfer.hpp"
 #include "benchImageTransfer.hpp"
+#include "benchLaunchOverhead.hpp"
 #include "benchIntegral.hpp"
 #include "benchTransform.hpp"
 #include "benchResize.hpp"
 #include "benchFilters.hpp"
+#include "benchBatch.hpp"
+#include "benchHalf.hpp"
+#include "benchFusion.hpp"
 
 void RunBench()
 {
@@ -92,6 +97,19 @@ void RunBench()
    B(Log);
    B(Invert);*/
 
+   // F16 image buffers - compared with IPP on F32 images
+   Bench(AddBenchF16);
+   Bench(SubBenchF16);
+   Bench(AbsDiffBenchF16);
+   Bench(MulBenchF16);
+   Bench(AddCBenchF16);
+   Bench(SubCBenchF16);
+   Bench(AbsDiffCBenchF16);
+   Bench(MulCBenchF16);
+   Bench(AbsBenchF16);
+   Bench(SqrBenchF16);
+   Bench(SqrtBenchF16);
+
    B_NO_F(And);
    B_NO_F(Or);
    B_NO_F(Xor);
@@ -100,6 +118,10 @@ void RunBench()
    B_NO_F(XorC);
    //B_NO_F(Not);
 
+   B(TresholdGT);
+   B(TresholdLT);
+   B(TresholdGTLT);
+
    B(Min);
    B(Max);
    B(Sum);
@@ -107,6 +129,10 @@ void RunBench()
 
    Bench(ErodeBench);
    Bench(DilateBench);
+   Bench(ErodeC3Bench);
+   Bench(ErodeC4Bench);
+   Bench(DilateC3Bench);
+   Bench(DilateC4Bench);
 
    B(MirrorX);
    B(MirrorY);
@@ -160,10 +186,53 @@ void RunBench()
    Bench(SobelCross3Bench);
    Bench(SobelCross5Bench);
 
+   // Filters on F16 image buffers
+   Bench(Gauss3BenchF16);
+   Bench(Gauss5BenchF16);
+   Bench(Laplace3BenchF16);
+   Bench(ScharrVert3BenchF16);
+   Bench(PrewittHoriz3BenchF16);
+   Bench(SobelVert5BenchF16);
+
+   // Filters on packed 3 and 4 channel images
+   Bench(Sharpen3C3Bench);
+   Bench(SobelVert3C3Bench);
+   Bench(SobelHoriz3C3Bench);
+   Bench(Gauss3C3Bench);
+   Bench(Gauss5C3Bench);
+   Bench(Sharpen3C4Bench);
+   Bench(SobelVert3C4Bench);
+   Bench(SobelHoriz3C4Bench);
+   Bench(Gauss3C4Bench);
+   Bench(Gauss5C4Bench);
+
+   // Batches of images - compared with the results of each image processed separately
+   B(AbsDiffCBatch);
+   B(SqrtBatch);
+   B(Sobel3Batch);
+   B(Gauss5Batch);
+   B(Median3Batch);
+
+   B(MinBatch);
+   B(MaxBatch);
+   B(MinAbsBatch);
+   B(MaxAbsBatch);
+   B(SumBatch);
+   B(MeanBatch);
+   B(MeanSqrBatch);
+
+   // Fused chains of pointwise operations - compared with the separate primitives
+   B_NO_F(FusionLogic);
+   B_NO_F(FusionMixed);
+
 #else // FULL_TESTS
    // Benchmark mode
    Bench(TransferBench);
+   Bench(PinnedTransferBench);
+   Bench(MappedTransferBench);
    Bench(ImageTransferBench);
+   Bench(LaunchOverheadBench);
+   Bench(UncachedLaunchOverheadBench);
 
    Bench(AbsDiffCBenchU8);
    Bench(AbsDiffBenchU8);
@@ -68,8 +68,9 @@ public:
 class IBench1in0out : public IBench
 {
 public:
-   IBench1in0out(bool CLUsesBuffer = false)
+   IBench1in0out(bool CLUsesBuffer = false, uint Channels = 1)
    : m_UsesBuffer(CLUsesBuffer)
+   , m_Channels(Channels)
    , m_CLSrc(nullptr)
    , m_CLBufferSrc(nullptr)
    , m_CUDASrc(nullptr)
@@ -85,6 +86,7 @@ public:
 protected:
 
    bool m_UsesBuffer;
+   uint m_Channels;     // Number of channels of the images - multi-channel images are packed
 
    CSimpleImage m_ImgSrc;
 
@@ -106,8 +108,8 @@ protected:
 class IBench1in1out : public IBench1in0out
 {
 public:
-   IBench1in1out(bool CLUsesBuffer = false)
-   : IBench1in0out(CLUsesBuffer)
+   IBench1in1out(bool CLUsesBuffer = false, uint Channels = 1)
+   : IBench1in0out(CLUsesBuffer, Channels)
    , m_CLDst(nullptr)
    , m_CLBufferDst(nullptr)
    , m_CUDADst(nullptr)
@@ -178,8 +180,8 @@ template<typename DataType, bool UseBuffer>
 class BenchUnaryBase : public IBench1in1out
 {
 public:
-   BenchUnaryBase()
-   : IBench1in1out(UseBuffer)
+   BenchUnaryBase(uint Channels = 1)
+   : IBench1in1out(UseBuffer, Channels)
    { }
 
    void Create(uint Width, uint Height)
@@ -330,7 +332,7 @@ template<typename DataType>
 inline void IBench1in0out::Create(uint Width, uint Height, bool AllowNegative)
 {
    // Source image
-   m_ImgSrc.Create<DataType>(Width, Height);
+   m_ImgSrc.Create<DataType>(Width, Height, m_Channels);
    FillRandomImg(m_ImgSrc);
 
    if (!AllowNegative)
@@ -363,7 +365,7 @@ inline void IBench1in0out::Create(uint Width, uint Height, bool AllowNegative)
 
    // NPP
    NPP_CODE(
-      m_NPPSrc = NPP_Malloc<sizeof(DataType)>(Width, Height, m_NPPSrcStep);
+      m_NPPSrc = NPP_Malloc<sizeof(DataType)>(Width * m_Channels, Height, m_NPPSrcStep);
       m_NPPRoi.width = Width;
       m_NPPRoi.height = Height;
 
@@ -409,10 +411,10 @@ inline void IBench1in1out::Create(uint Width, uint Height, uint DstWidth, uint D
       DstHeight = Height;
 
    // CPU
-   m_ImgDstIPP.Create<DstType>(DstWidth, DstHeight);
+   m_ImgDstIPP.Create<DstType>(DstWidth, DstHeight, m_Channels);
 
    // CL
-   m_ImgDstCL.Create<DstType>(DstWidth, DstHeight);
+   m_ImgDstCL.Create<DstType>(DstWidth, DstHeight, m_Channels);
 
    if (m_UsesBuffer)
       ocipCreateImageBuffer(&m_CLBufferDst, m_ImgDstCL, m_ImgDstCL.Data(), CL_MEM_READ_WRITE);
@@ -421,8 +423,8 @@ inline void IBench1in1out::Create(uint Width, uint Height, uint DstWidth, uint D
 
    // NPP
    NPP_CODE(
-      m_ImgDstNPP.Create<DstType>(DstWidth, DstHeight);
-      m_NPPDst = NPP_Malloc<sizeof(DstType)>(DstWidth, DstHeight, m_NPPDstStep);
+      m_ImgDstNPP.Create<DstType>(DstWidth, DstHeight, m_Channels);
+      m_NPPDst = NPP_Malloc<sizeof(DstType)>(DstWidth * m_Channels, DstHeight, m_NPPDstStep);
       )
 
    // OpenCV
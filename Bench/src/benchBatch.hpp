@@ -0,0 +1,291 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: benchBatch.hpp
+//! @date   : Oct 2026
+//!
+//! @brief  : Benchmark classes for batches of image buffers
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+// These benches test the processing of batches of images (see ocipCreateImageBufferBatch).
+// The reference is not IPP : the result of the batch is compared with the results
+// of the same operation done on each image of the batch separately.
+
+const static uint BatchNbImages = 4;   // Number of images in the batches
+
+template<typename DataType>
+class BatchBenchBase : public IBench
+{
+public:
+   BatchBenchBase()
+   : m_ImageHeight(0)
+   , m_CLBatchSrc(nullptr)
+   { }
+
+   void Create(uint Width, uint Height);
+   void Free();
+
+   void RunIPP() { }    // The reference is computed by Create()
+
+   bool HasNPPTest() const { return false; }
+   bool HasCUDATest() const { return false; }
+   bool HasCVTest() const { return false; }
+
+   typedef DataType dataType;
+
+protected:
+   uint m_ImageHeight;     // Height of each image of the batch
+
+   CSimpleImage m_ImgSrc;  // All the images of the batch, one after the other
+
+   ocipBuffer m_CLBatchSrc;
+};
+
+template<typename DataType>
+class BatchUnaryBenchBase : public BatchBenchBase<DataType>
+{
+public:
+   BatchUnaryBenchBase()
+   : m_CLBatchDst(nullptr)
+   { }
+
+   void Create(uint Width, uint Height);
+   void Free();
+
+   void RunCL();
+
+   bool CompareCL(BatchUnaryBenchBase * This);
+
+protected:
+   virtual void Process(ocipBuffer Source, ocipBuffer Dest) = 0;
+
+   CSimpleImage m_ImgDstRef;  // Results of the operation done on each image separately
+   CSimpleImage m_ImgDstCL;   // Result of the operation done on the batch
+
+   ocipBuffer m_CLBatchDst;
+};
+
+template<typename DataType>
+class BatchReduceBenchBase : public BatchBenchBase<DataType>
+{
+public:
+   BatchReduceBenchBase()
+   : m_Program(nullptr)
+   { }
+
+   void Create(uint Width, uint Height);
+   void Free();
+
+   void RunCL();
+
+   bool CompareCL(BatchReduceBenchBase * This);
+
+   virtual float CompareTolerance() const { return SUCCESS_EPSILON; }
+
+protected:
+   virtual void Reduce(ocipBuffer Source, double * Result) = 0;         // Reduction of 1 image
+   virtual void ReduceBatch(ocipBuffer Source, double * Results) = 0;   // Reduction of each image of a batch
+
+   ocipProgram m_Program;
+
+   double m_DstRef[BatchNbImages];  // Results of the reduction done on each image separately
+   double m_DstCL[BatchNbImages];   // Results of the reduction done on the batch
+};
+//-----------------------------------------------------------------------------------------------------------------------------
+#define BATCH_BENCH(Name, Call) \
+template<typename DataType>\
+class CONCATENATE(Name, BatchBench) : public BatchUnaryBenchBase<DataType>\
+{\
+protected:\
+   void Process(ocipBuffer Source, ocipBuffer Dest)\
+   {\
+      Call;\
+   }\
+};
+
+#define BATCH_REDUCE_BENCH(Name, Tolerance) \
+template<typename DataType>\
+class CONCATENATE(Name, BatchBench) : public BatchReduceBenchBase<DataType>\
+{\
+public:\
+   float CompareTolerance() const { return Tolerance; }\
+protected:\
+   void Reduce(ocipBuffer Source, double * Result)\
+   {\
+      CONCATENATE(CONCATENATE(ocip, Name), _V)(this->m_Program, Source, Result);\
+   }\
+   void ReduceBatch(ocipBuffer Source, double * Results)\
+   {\
+      CONCATENATE(CONCATENATE(ocip, Name), Batch_V)(this->m_Program, Source, Results);\
+   }\
+};
+
+// Pointwise operations
+BATCH_BENCH(AbsDiffC, ocipAbsDiffC_V(Source, Dest, 12))
+BATCH_BENCH(Sqrt, ocipSqrt_V(Source, Dest))
+
+// Filters - each image of the batch must keep its own borders
+BATCH_BENCH(Sobel3, ocipSobel_V(Source, Dest, 3))
+BATCH_BENCH(Gauss5, ocipGauss_V(Source, Dest, 5))
+BATCH_BENCH(Median3, ocipMedian_V(Source, Dest, 3))
+
+// Reductions - one value per image of the batch
+BATCH_REDUCE_BENCH(Min, SUCCESS_EPSILON)
+BATCH_REDUCE_BENCH(Max, SUCCESS_EPSILON)
+BATCH_REDUCE_BENCH(MinAbs, SUCCESS_EPSILON)
+BATCH_REDUCE_BENCH(MaxAbs, SUCCESS_EPSILON)
+
+// The batch and the separate images are not summed in the same order, so allow slight variations
+BATCH_REDUCE_BENCH(Sum, 0.001f)
+BATCH_REDUCE_BENCH(Mean, 0.001f)
+BATCH_REDUCE_BENCH(MeanSqr, 0.001f)
+//-----------------------------------------------------------------------------------------------------------------------------
+template<typename DataType>
+void BatchBenchBase<DataType>::Create(uint Width, uint Height)
+{
+   m_ImageHeight = Height / BatchNbImages;
+
+   m_ImgSrc.Create<DataType>(Width, m_ImageHeight * BatchNbImages);
+   FillRandomImg(m_ImgSrc);
+
+   SImage Image = m_ImgSrc.ToSImage();
+   Image.Height = m_ImageHeight;
+
+   ocipCreateImageBufferBatch(&m_CLBatchSrc, Image, BatchNbImages, m_ImgSrc.Data(), CL_MEM_READ_ONLY);
+   ocipSendImageBuffer(m_CLBatchSrc);
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+template<typename DataType>
+void BatchBenchBase<DataType>::Free()
+{
+   ocipReleaseImageBuffer(m_CLBatchSrc);
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+template<typename DataType>
+void BatchUnaryBenchBase<DataType>::Create(uint Width, uint Height)
+{
+   BatchBenchBase<DataType>::Create(Width, Height);
+
+   uint ImageHeight = this->m_ImageHeight;
+
+   m_ImgDstRef.Create<DataType>(Width, ImageHeight * BatchNbImages);
+   m_ImgDstCL.Create<DataType>(Width, ImageHeight * BatchNbImages);
+
+   SImage Image = m_ImgDstCL.ToSImage();
+   Image.Height = ImageHeight;
+
+   ocipCreateImageBufferBatch(&m_CLBatchDst, Image, BatchNbImages, m_ImgDstCL.Data(), CL_MEM_READ_WRITE);
+
+   // Reference : the same operation done on each image separately
+   for (uint i = 0; i < BatchNbImages; i++)
+   {
+      CImageROI Src(this->m_ImgSrc, 0, i * ImageHeight, Width, ImageHeight);
+      CImageROI Dst(m_ImgDstRef, 0, i * ImageHeight, Width, ImageHeight);
+
+      ocipBuffer CLSrc = nullptr;
+      ocipBuffer CLDst = nullptr;
+      ocipCreateImageBuffer(&CLSrc, Src, Src.Data(), CL_MEM_READ_ONLY);
+      ocipCreateImageBuffer(&CLDst, Dst, Dst.Data(), CL_MEM_READ_WRITE);
+
+      ocipSendImageBuffer(CLSrc);
+      Process(CLSrc, CLDst);
+      ocipReadImageBuffer(CLDst);
+
+      ocipReleaseImageBuffer(CLSrc);
+      ocipReleaseImageBuffer(CLDst);
+   }
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+template<typename DataType>
+void BatchUnaryBenchBase<DataType>::Free()
+{
+   BatchBenchBase<DataType>::Free();
+
+   ocipReleaseImageBuffer(m_CLBatchDst);
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+template<typename DataType>
+void BatchUnaryBenchBase<DataType>::RunCL()
+{
+   Process(this->m_CLBatchSrc, m_CLBatchDst);
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+template<typename DataType>
+bool BatchUnaryBenchBase<DataType>::CompareCL(BatchUnaryBenchBase * This)
+{
+   ocipReadImageBuffer(m_CLBatchDst);
+
+   return CompareImages(m_ImgDstCL, m_ImgDstRef, this->m_ImgSrc, *This);
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+template<typename DataType>
+void BatchReduceBenchBase<DataType>::Create(uint Width, uint Height)
+{
+   BatchBenchBase<DataType>::Create(Width, Height);
+
+   uint ImageHeight = this->m_ImageHeight;
+
+   ocipPrepareImageBufferStatistics(&m_Program, this->m_CLBatchSrc);
+
+   // Reference : the same reduction done on each image separately
+   for (uint i = 0; i < BatchNbImages; i++)
+   {
+      CImageROI Src(this->m_ImgSrc, 0, i * ImageHeight, Width, ImageHeight);
+
+      ocipBuffer CLSrc = nullptr;
+      ocipCreateImageBuffer(&CLSrc, Src, Src.Data(), CL_MEM_READ_ONLY);
+
+      ocipSendImageBuffer(CLSrc);
+      Reduce(CLSrc, &m_DstRef[i]);
+
+      ocipReleaseImageBuffer(CLSrc);
+   }
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+template<typename DataType>
+void BatchReduceBenchBase<DataType>::Free()
+{
+   BatchBenchBase<DataType>::Free();
+
+   ocipReleaseProgram(m_Program);
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+template<typename DataType>
+void BatchReduceBenchBase<DataType>::RunCL()
+{
+   ReduceBatch(this->m_CLBatchSrc, m_DstCL);
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+template<typename DataType>
+bool BatchReduceBenchBase<DataType>::CompareCL(BatchReduceBenchBase *)
+{
+   for (uint i = 0; i < BatchNbImages; i++)
+   {
+      // Relative tolerance - absolute for values close to 0 (like the mean of float images)
+      double Diff = abs(m_DstCL[i] - m_DstRef[i]);
+      double Scale = abs(m_DstRef[i]);
+      if (Scale < 1)
+         Scale = 1;
+
+      if (Diff / Scale > CompareTolerance())
+         return false;
+   }
+
+   return true;
+}
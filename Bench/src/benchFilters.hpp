@@ -38,10 +38,14 @@ float FilterTolerance<float>()
 }
 
 
-template<typename DataType, int mask_size = 1>
+template<typename DataType, int mask_size = 1, int channels = 1>
 class FilterBenchBase : public BenchUnaryBase<DataType, FiltersUseBuffer>
 {
 public:
+   FilterBenchBase()
+   : BenchUnaryBase<DataType, FiltersUseBuffer>(channels)
+   { }
+
    void Create(uint Width, uint Height);
 
    SSize CompareSize() const { return m_MaskSize; }
@@ -79,8 +83,8 @@ public:\
    }\
 };
 
-template<typename DataType, int mask_size>
-void FilterBenchBase<DataType, mask_size>::Create(uint Width, uint Height)
+template<typename DataType, int mask_size, int channels>
+void FilterBenchBase<DataType, mask_size, channels>::Create(uint Width, uint Height)
 {
    BenchUnaryBase<DataType, FiltersUseBuffer>::Create(Width, Height);
 
@@ -265,3 +269,75 @@ FILTER_BENCH(Sobel, 5)
 
 FILTER_BENCH(Prewitt, 3)
 FILTER_BENCH(Scharr, 3)
+
+
+// Packed 3 and 4 channel images - each channel is filtered separately
+#define FILTER_BENCH_C(Name, width, channels) \
+class CONCATENATE(CONCATENATE(Name, width), CONCATENATE(C, CONCATENATE(channels, Bench))) : public FilterBenchBase<FILTER_TYPE, width / 2, channels>\
+{\
+public:\
+   bool HasCVTest() const { return false; }\
+   bool HasCUDATest() const { return false; }\
+   void RunCL()\
+   {\
+      CONCATENATE(CONCATENATE(ocip, Name), _V) (m_CLBufferSrc, m_CLBufferDst, width);\
+   }\
+   void RunIPP()\
+   {\
+      IPP_CODE( \
+         CONCATENATE(CONCATENATE(ippiFilter, Name), FILTER_IPP_MOD)\
+            ((FILTER_TYPE*) m_ImgSrc.Data(width / 2, width / 2), m_ImgSrc.Step, (FILTER_TYPE*) m_ImgDstIPP.Data(width / 2, width / 2), m_ImgDstIPP.Step, m_IPPRoi FILTERS_IPP_MASK);\
+      )\
+   }\
+   void RunNPP()\
+   {\
+      NPP_CODE(\
+         CONCATENATE(CONCATENATE(nppiFilter, Name), FILTER_IPP_MOD)\
+            ((FILTER_TYPE*) m_NPPSrc, m_NPPSrcStep, (FILTER_TYPE*) m_NPPDst, m_NPPDstStep, m_NPPRoi FILTERS_NPP_MASK);\
+         )\
+   }\
+};
+
+#undef FILTER_TYPE
+#undef FILTER_IPP_MOD
+#undef FILTERS_IPP_MASK
+#undef FILTERS_NPP_MASK
+#define FILTER_TYPE unsigned char
+#define FILTER_IPP_MOD _8u_C3R
+#define FILTERS_IPP_MASK
+#define FILTERS_NPP_MASK
+
+FILTER_BENCH_C(Sharpen, 3, 3)
+FILTER_BENCH_C(SobelVert, 3, 3)
+FILTER_BENCH_C(SobelHoriz, 3, 3)
+
+#undef FILTER_IPP_MOD
+#define FILTER_IPP_MOD _8u_C4R
+
+FILTER_BENCH_C(Sharpen, 3, 4)
+FILTER_BENCH_C(SobelVert, 3, 4)
+FILTER_BENCH_C(SobelHoriz, 3, 4)
+
+#undef FILTERS_IPP_MASK
+#undef FILTERS_NPP_MASK
+#define FILTERS_IPP_MASK , ippMskSize3x3
+#define FILTERS_NPP_MASK , NPP_MASK_SIZE_3_X_3
+
+FILTER_BENCH_C(Gauss, 3, 4)
+
+#undef FILTER_IPP_MOD
+#define FILTER_IPP_MOD _8u_C3R
+
+FILTER_BENCH_C(Gauss, 3, 3)
+
+#undef FILTERS_IPP_MASK
+#undef FILTERS_NPP_MASK
+#define FILTERS_IPP_MASK , ippMskSize5x5
+#define FILTERS_NPP_MASK , NPP_MASK_SIZE_5_X_5
+
+FILTER_BENCH_C(Gauss, 5, 3)
+
+#undef FILTER_IPP_MOD
+#define FILTER_IPP_MOD _8u_C4R
+
+FILTER_BENCH_C(Gauss, 5, 4)
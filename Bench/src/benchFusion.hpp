@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: benchFusion.hpp
+//! @date   : Oct 2026
+//!
+//! @brief  : Benchmark classes for fused chains of pointwise operations
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+// These benches run chains of pointwise operations with Fusion of the C++ interface.
+// The reference is not IPP : the result of the fused chain is compared with the results
+// of the same operations done with the separate primitives.
+// The C++ objects are created on the COpenCL of the current context of the C interface.
+
+template<typename DataType>
+class FusionBenchBase : public IBench
+{
+public:
+   FusionBenchBase()
+   : m_CL(nullptr)
+   { }
+
+   void Create(uint Width, uint Height);
+   void Free();
+
+   void RunIPP() { }    // The reference is computed by Create()
+   void RunCL();
+
+   bool HasNPPTest() const { return false; }
+   bool HasCUDATest() const { return false; }
+   bool HasCVTest() const { return false; }
+
+   bool CompareCL(FusionBenchBase * This);
+
+   typedef DataType dataType;
+
+protected:
+   // Adds the operations to the chain
+   virtual void MakeChain(OpenCLIPP::PointwiseChain& Chain, OpenCLIPP::IImage& SourceB) = 0;
+
+   // Runs the same operations with the separate primitives
+   virtual void RunSeparate(OpenCLIPP::IImage& Source, OpenCLIPP::IImage& SourceB, OpenCLIPP::IImage& Dest) = 0;
+
+   OpenCLIPP::COpenCL * m_CL;
+
+   CSimpleImage m_ImgSrc;
+   CSimpleImage m_ImgSrcB;
+   CSimpleImage m_ImgDstRef;  // Result of the separate primitives
+   CSimpleImage m_ImgDstCL;   // Result of the fused chain
+
+   std::unique_ptr<OpenCLIPP::Image> m_Src;
+   std::unique_ptr<OpenCLIPP::Image> m_SrcB;
+   std::unique_ptr<OpenCLIPP::Image> m_Dst;
+
+   std::unique_ptr<OpenCLIPP::Fusion> m_Fusion;
+   OpenCLIPP::PointwiseChain m_Chain;
+};
+//-----------------------------------------------------------------------------------------------------------------------------
+// Logic only : the result must keep all the bits of the source depth
+template<typename DataType>
+class FusionLogicBench : public FusionBenchBase<DataType>
+{
+protected:
+   void MakeChain(OpenCLIPP::PointwiseChain& Chain, OpenCLIPP::IImage& SourceB)
+   {
+      Chain.Xor(SourceB).Not().Or(0x11);
+   }
+
+   void RunSeparate(OpenCLIPP::IImage& Source, OpenCLIPP::IImage& SourceB, OpenCLIPP::IImage& Dest)
+   {
+      OpenCLIPP::Logic Logic(*this->m_CL);
+
+      Logic.Xor(Source, SourceB, Dest);
+      Logic.Not(Dest, Dest);
+      Logic.Or(Dest, Dest, 0x11);
+   }
+};
+
+// Logic, arithmetic and tresholding - no intermediate result is saturated
+template<typename DataType>
+class FusionMixedBench : public FusionBenchBase<DataType>
+{
+protected:
+   void MakeChain(OpenCLIPP::PointwiseChain& Chain, OpenCLIPP::IImage& SourceB)
+   {
+      Chain.Not().Xor(SourceB).And(0x3F).Add(100).TresholdGT(150, 255);
+   }
+
+   void RunSeparate(OpenCLIPP::IImage& Source, OpenCLIPP::IImage& SourceB, OpenCLIPP::IImage& Dest)
+   {
+      OpenCLIPP::COpenCL& CL = *this->m_CL;
+      OpenCLIPP::Logic Logic(CL);
+      OpenCLIPP::Arithmetic Arithmetic(CL);
+      OpenCLIPP::Tresholding Tresholding(CL);
+
+      Logic.Not(Source, Dest);
+      Logic.Xor(Dest, SourceB, Dest);
+      Logic.And(Dest, Dest, 0x3F);
+      Arithmetic.Add(Dest, Dest, 100);
+      Tresholding.TresholdGT(Dest, Dest, 150, 255);
+   }
+};
+//-----------------------------------------------------------------------------------------------------------------------------
+template<typename DataType>
+void FusionBenchBase<DataType>::Create(uint Width, uint Height)
+{
+   ocipContext Context = nullptr;
+   ocipGetCurrentContext(&Context);
+   m_CL = (OpenCLIPP::COpenCL *) Context;   // Contexts of the C interface are COpenCL objects
+   OpenCLIPP::COpenCL& CL = *m_CL;
+
+   m_ImgSrc.Create<DataType>(Width, Height);
+   m_ImgSrcB.Create<DataType>(Width, Height);
+   m_ImgDstRef.Create<DataType>(Width, Height);
+   m_ImgDstCL.Create<DataType>(Width, Height);
+   FillRandomImg(m_ImgSrc);
+   FillRandomImg(m_ImgSrcB, 1);
+
+   m_Src.reset(new OpenCLIPP::Image(CL, m_ImgSrc.ToSImage(), m_ImgSrc.Data(), CL_MEM_READ_ONLY));
+   m_SrcB.reset(new OpenCLIPP::Image(CL, m_ImgSrcB.ToSImage(), m_ImgSrcB.Data(), CL_MEM_READ_ONLY));
+   m_Src->Send();
+   m_SrcB->Send();
+
+   // Reference : the same operations done with the separate primitives
+   m_Dst.reset(new OpenCLIPP::Image(CL, m_ImgDstRef.ToSImage(), m_ImgDstRef.Data()));
+   RunSeparate(*m_Src, *m_SrcB, *m_Dst);
+   m_Dst->Read(true);
+
+   m_Dst.reset(new OpenCLIPP::Image(CL, m_ImgDstCL.ToSImage(), m_ImgDstCL.Data()));
+
+   m_Chain.Clear();
+   MakeChain(m_Chain, *m_SrcB);
+
+   m_Fusion.reset(new OpenCLIPP::Fusion(CL));
+   m_Fusion->PrepareFor(m_Chain, *m_Src, *m_Dst);
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+template<typename DataType>
+void FusionBenchBase<DataType>::Free()
+{
+   m_Fusion.reset();
+   m_Dst.reset();
+   m_SrcB.reset();
+   m_Src.reset();
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+template<typename DataType>
+void FusionBenchBase<DataType>::RunCL()
+{
+   m_Fusion->Run(m_Chain, *m_Src, *m_Dst);
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+template<typename DataType>
+bool FusionBenchBase<DataType>::CompareCL(FusionBenchBase * This)
+{
+   m_Dst->Read(true);
+
+   return CompareImages(m_ImgDstCL, m_ImgDstRef, m_ImgSrc, *This);
+}
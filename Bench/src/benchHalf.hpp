@@ -0,0 +1,231 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: benchHalf.hpp
+//! @date   : Oct 2026
+//!
+//! @brief  : Benchmark classes for F16 image buffers
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+// IPP has no half float type, so the F16 benches run the F32 benches with F16 image buffers in OpenCL.
+// The source images are rounded to half precision so IPP works on the same values as OpenCL,
+// the OpenCL result is converted back to float and compared with the precision of half floats.
+
+const static float HalfPrecision = 1.f / 1024;   // Relative precision of half floats (10 bit mantissa)
+
+// Conversions between float and half (IEEE 754 binary16, rounded to nearest even)
+inline unsigned short FloatToHalf(float Value)
+{
+   uint Bits;
+   memcpy(&Bits, &Value, sizeof(Bits));
+
+   uint Sign = (Bits >> 16) & 0x8000;
+   int Exponent = int((Bits >> 23) & 0xFF) - 127 + 15;
+   uint Mantissa = Bits & 0x7FFFFF;
+
+   if (Exponent >= 31)
+   {
+      if (((Bits >> 23) & 0xFF) == 0xFF && Mantissa != 0)
+         return (unsigned short) (Sign | 0x7E00);  // NaN
+
+      return (unsigned short) (Sign | 0x7C00);     // Infinity
+   }
+
+   if (Exponent <= 0)
+   {
+      // Denormal half
+      if (Exponent < -10)
+         return (unsigned short) Sign;
+
+      Mantissa |= 0x800000;
+      uint Shift = 14 - Exponent;
+      uint Half = Mantissa >> Shift;
+      uint Remainder = Mantissa & ((1u << Shift) - 1);
+      uint Midpoint = 1u << (Shift - 1);
+      if (Remainder > Midpoint || (Remainder == Midpoint && (Half & 1)))
+         Half++;
+
+      return (unsigned short) (Sign | Half);
+   }
+
+   uint Half = (uint(Exponent) << 10) | (Mantissa >> 13);
+   uint Remainder = Mantissa & 0x1FFF;
+   if (Remainder > 0x1000 || (Remainder == 0x1000 && (Half & 1)))
+      Half++;  // A carry goes in the exponent, up to infinity
+
+   return (unsigned short) (Sign | Half);
+}
+
+inline float HalfToFloat(unsigned short Value)
+{
+   uint Sign = uint(Value & 0x8000) << 16;
+   uint Exponent = (Value >> 10) & 0x1F;
+   uint Mantissa = Value & 0x3FF;
+   uint Bits;
+
+   if (Exponent == 0x1F)
+      Bits = Sign | 0x7F800000 | (Mantissa << 13);    // Infinity or NaN
+   else if (Exponent != 0)
+      Bits = Sign | ((Exponent + 127 - 15) << 23) | (Mantissa << 13);
+   else if (Mantissa == 0)
+      Bits = Sign;
+   else
+   {
+      // Denormal half - normalize it
+      Exponent = 127 - 15 + 1;
+      while ((Mantissa & 0x400) == 0)
+      {
+         Mantissa <<= 1;
+         Exponent--;
+      }
+
+      Bits = Sign | (Exponent << 23) | ((Mantissa & 0x3FF) << 13);
+   }
+
+   float Result;
+   memcpy(&Result, &Bits, sizeof(Result));
+   return Result;
+}
+
+// Converts an F32 image to F16 or an F16 image to F32
+inline void ConvertHalfImage(const CSimpleImage& Source, CSimpleImage& Dest)
+{
+   for (uint y = 0; y < Source.Height; y++)
+      for (uint x = 0; x < Source.Width * Source.Channels; x++)
+         if (Source.Type == SImage::F32)
+            ((unsigned short *) Dest.Data(y))[x] = FloatToHalf(((const float *) Source.Data(y))[x]);
+         else
+            ((float *) Dest.Data(y))[x] = HalfToFloat(((const unsigned short *) Source.Data(y))[x]);
+}
+
+
+template<class F32Bench>
+class HalfBench : public F32Bench
+{
+public:
+   void Create(uint Width, uint Height);
+
+   bool HasNPPTest() const { return false; }
+   bool HasCUDATest() const { return false; }
+   bool HasCVTest() const { return false; }
+
+   template<class T> bool CompareCL(T * This);
+
+protected:
+   // Rounds Image to half precision and replaces Buffer by an F16 buffer containing it
+   void ToHalf(CSimpleImage& Image, CSimpleImage& HalfImage, ocipBuffer& Buffer);
+
+   CSimpleImage m_ImgSrcHalf;
+   CSimpleImage m_ImgDstHalf;
+};
+
+template<class F32Bench>
+class HalfBinaryBench : public HalfBench<F32Bench>
+{
+public:
+   void Create(uint Width, uint Height)
+   {
+      HalfBench<F32Bench>::Create(Width, Height);
+      this->ToHalf(this->m_ImgSrcB, m_ImgSrcBHalf, this->m_CLBufferSrcB);
+   }
+
+protected:
+   CSimpleImage m_ImgSrcBHalf;
+};
+
+template<class F32Bench>
+void HalfBench<F32Bench>::Create(uint Width, uint Height)
+{
+   F32Bench::Create(Width, Height);
+
+   ToHalf(this->m_ImgSrc, m_ImgSrcHalf, this->m_CLBufferSrc);
+
+   m_ImgDstHalf.Create(this->m_ImgDstCL.Width, this->m_ImgDstCL.Height, this->m_ImgDstCL.Channels, SImage::F16);
+   ocipReleaseImageBuffer(this->m_CLBufferDst);
+   ocipCreateImageBuffer(&this->m_CLBufferDst, m_ImgDstHalf, m_ImgDstHalf.Data(), CL_MEM_READ_WRITE);
+}
+
+template<class F32Bench>
+void HalfBench<F32Bench>::ToHalf(CSimpleImage& Image, CSimpleImage& HalfImage, ocipBuffer& Buffer)
+{
+   HalfImage.Create(Image.Width, Image.Height, Image.Channels, SImage::F16);
+   ConvertHalfImage(Image, HalfImage);
+   ConvertHalfImage(HalfImage, Image);
+
+   ocipReleaseImageBuffer(Buffer);
+   ocipCreateImageBuffer(&Buffer, HalfImage, HalfImage.Data(), CL_MEM_READ_ONLY);
+   ocipSendImageBuffer(Buffer);
+}
+
+template<class F32Bench>
+template<class T>
+bool HalfBench<F32Bench>::CompareCL(T * This)
+{
+   ocipReadImageBuffer(this->m_CLBufferDst);
+   ConvertHalfImage(m_ImgDstHalf, this->m_ImgDstCL);
+
+   // Same region and tolerance as the F32 bench, plus the rounding of the result to half
+   SSize MaskSize = This->CompareSize();
+   SPoint Anchor = This->CompareAnchor();
+   float Tolerance = This->CompareTolerance();
+   bool Relative = This->CompareTolRelative();
+
+   uint Width = (this->m_ImgDstCL.Width - MaskSize.Width + 1) * this->m_ImgDstCL.Channels;
+   uint Height = this->m_ImgDstCL.Height - MaskSize.Height + 1;
+
+   for (uint y = Anchor.Y; y < Anchor.Y + Height; y++)
+      for (uint x = Anchor.X * this->m_ImgDstCL.Channels; x < Anchor.X * this->m_ImgDstCL.Channels + Width; x++)
+      {
+         float CL = ((const float *) this->m_ImgDstCL.Data(y))[x];
+         float IPP = ((const float *) this->m_ImgDstIPP.Data(y))[x];
+
+         float Allowed = abs(IPP) * HalfPrecision;
+         if (Relative)
+            Allowed += abs(IPP) * Tolerance;
+         else
+            Allowed += Tolerance;
+
+         if (!(abs(CL - IPP) <= Allowed))
+            return false;
+      }
+
+   return true;
+}
+
+
+// Arithmetic
+typedef HalfBinaryBench<AddBench<float> >       AddBenchF16;
+typedef HalfBinaryBench<SubBench<float> >       SubBenchF16;
+typedef HalfBinaryBench<AbsDiffBench<float> >   AbsDiffBenchF16;
+typedef HalfBinaryBench<MulBench<float> >       MulBenchF16;
+typedef HalfBench<AddCBench<float> >            AddCBenchF16;
+typedef HalfBench<SubCBench<float> >            SubCBenchF16;
+typedef HalfBench<AbsDiffCBench<float> >        AbsDiffCBenchF16;
+typedef HalfBench<MulCBench<float> >            MulCBenchF16;
+typedef HalfBench<AbsBench<float> >             AbsBenchF16;
+typedef HalfBench<SqrBench<float> >             SqrBenchF16;
+typedef HalfBench<SqrtBench<float> >            SqrtBenchF16;
+
+// Filters
+typedef HalfBench<Gauss3Bench>         Gauss3BenchF16;
+typedef HalfBench<Gauss5Bench>         Gauss5BenchF16;
+typedef HalfBench<Laplace3Bench>       Laplace3BenchF16;
+typedef HalfBench<ScharrVert3Bench>    ScharrVert3BenchF16;
+typedef HalfBench<PrewittHoriz3Bench>  PrewittHoriz3BenchF16;
+typedef HalfBench<SobelVert5Bench>     SobelVert5BenchF16;
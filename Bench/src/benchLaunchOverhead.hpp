@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: benchLaunchOverhead.hpp
+//! @date   : Oct 2026
+//!
+//! @brief  : Benchmark class for the per-call kernel launch overhead
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Measures the cost of launching a primitive, independently of the image size.
+// A tiny image is used so that the execution time of the kernel is negligible.
+// Each run does 1000 launches, so the time displayed (in ms) is the time of 1 launch in microseconds.
+// UncachedLaunchOverheadBench gives the time of the same launches without the kernel cache.
+class LaunchOverheadBench : public IBench
+{
+public:
+   LaunchOverheadBench()
+   : m_CLBufferSrc(nullptr)
+   , m_CLBufferDst(nullptr)
+   { }
+
+   void Create(uint Width, uint Height);
+   void Free();
+
+   void RunIPP();
+   void RunCL();
+
+   bool HasNPPTest() const { return false; }
+   bool HasCUDATest() const { return false; }
+   bool HasCVTest() const { return false; }
+
+   bool CompareCL(LaunchOverheadBench*) { return true; }
+
+   static const uint NbLaunches = 1000;
+   static const uint ImageSize = 16;
+
+protected:
+   CSimpleImage m_ImgSrc;
+   CSimpleImage m_ImgDst;
+
+   ocipBuffer m_CLBufferSrc;
+   ocipBuffer m_CLBufferDst;
+};
+//-----------------------------------------------------------------------------------------------------------------------------
+void LaunchOverheadBench::Create(uint, uint)
+{
+   m_ImgSrc.Create<unsigned char>(ImageSize, ImageSize);
+   m_ImgDst.Create<unsigned char>(ImageSize, ImageSize);
+   FillRandomImg(m_ImgSrc);
+
+   ocipCreateImageBuffer(&m_CLBufferSrc, m_ImgSrc.ToSImage(), m_ImgSrc.Data(), CL_MEM_READ_ONLY);
+   ocipCreateImageBuffer(&m_CLBufferDst, m_ImgDst.ToSImage(), m_ImgDst.Data(), CL_MEM_WRITE_ONLY);
+
+   ocipSendImageBuffer(m_CLBufferSrc);
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+void LaunchOverheadBench::Free()
+{
+   ocipReleaseImageBuffer(m_CLBufferSrc);
+   ocipReleaseImageBuffer(m_CLBufferDst);
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+void LaunchOverheadBench::RunIPP()
+{
+   // Nothing to do
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+void LaunchOverheadBench::RunCL()
+{
+   for (uint i = 0; i < NbLaunches; i++)
+      ocipAddC_V(m_CLBufferSrc, m_CLBufferDst, 1);
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+// Same launches, plus the creation of a new kernel object for each launch,
+// which is what each launch did before kernels were cached by the programs.
+// The kernel objects are created from the program of ArithmeticVector of the C++ interface,
+// on the COpenCL of the current context of the C interface.
+class UncachedLaunchOverheadBench : public LaunchOverheadBench
+{
+public:
+   UncachedLaunchOverheadBench()
+   : m_Program(nullptr)
+   { }
+
+   void Create(uint Width, uint Height);
+   void Free();
+
+   void RunCL();
+
+protected:
+   std::unique_ptr<OpenCLIPP::ArithmeticVector> m_Arithmetic;
+   std::unique_ptr<OpenCLIPP::TempImageBuffer> m_Image;   // Used to select the version of the program
+   OpenCLIPP::Program * m_Program;
+};
+//-----------------------------------------------------------------------------------------------------------------------------
+void UncachedLaunchOverheadBench::Create(uint Width, uint Height)
+{
+   LaunchOverheadBench::Create(Width, Height);
+
+   ocipContext Context = nullptr;
+   ocipGetCurrentContext(&Context);
+   OpenCLIPP::COpenCL& CL = *(OpenCLIPP::COpenCL *) Context;   // Contexts of the C interface are COpenCL objects
+
+   m_Arithmetic.reset(new OpenCLIPP::ArithmeticVector(CL));
+   m_Image.reset(new OpenCLIPP::TempImageBuffer(CL, m_ImgSrc.ToSImage()));
+   m_Program = &m_Arithmetic->SelectProgram(*m_Image);
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+void UncachedLaunchOverheadBench::Free()
+{
+   m_Program = nullptr;
+   m_Image.reset();
+   m_Arithmetic.reset();
+
+   LaunchOverheadBench::Free();
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+void UncachedLaunchOverheadBench::RunCL()
+{
+   for (uint i = 0; i < NbLaunches; i++)
+   {
+      cl::Kernel Kernel((cl::Program&) *m_Program, "add_constant");
+      ocipAddC_V(m_CLBufferSrc, m_CLBufferDst, 1);
+   }
+}
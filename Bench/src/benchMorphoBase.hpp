@@ -27,8 +27,8 @@
 class MorphoBenchBase : public IBench1in1out
 {
 public:
-   MorphoBenchBase()
-   : IBench1in1out(MORPHO_USES_BUFFER)
+   MorphoBenchBase(uint Channels = 1)
+   : IBench1in1out(MORPHO_USES_BUFFER, Channels)
    , m_CUDATmp(nullptr)
    , m_CUDATmpStep(0)
    , m_NPPTmp(nullptr)
@@ -73,7 +73,7 @@ inline void MorphoBenchBase::Create(uint Width, uint Height)
 
    //V( (BinarizeImg<unsigned char, 1>(m_ImgSrc)) );
 
-   m_ImgTemp.Create<unsigned char>(Width, Height, 1);
+   m_ImgTemp.Create<unsigned char>(Width, Height, m_Channels);
 
    // IPP
    IPP_CODE(
@@ -93,7 +93,7 @@ inline void MorphoBenchBase::Create(uint Width, uint Height)
       ocipCreateImage(&m_CLTmp, m_ImgSrc.ToSImage(), nullptr, CL_MEM_READ_WRITE);
 
    // NPP
-   NPP_CODE(m_NPPTmp = (Npp8u*) NPP_Malloc<1>(Width, Height, m_NPPTmpStep);)
+   NPP_CODE(m_NPPTmp = (Npp8u*) NPP_Malloc<1>(Width * m_Channels, Height, m_NPPTmpStep);)
 }
 
 inline void MorphoBenchBase::Free()
@@ -113,3 +113,38 @@ inline void MorphoBenchBase::Free()
 #define BENCH_NAME Dilate
 #include "benchMorpho.hpp"
 #undef BENCH_NAME
+
+// Erode and Dilate benches on packed 3 and 4 channel images - each channel is processed separately
+#define MORPHO_BENCH_C(Name, channels) \
+class CONCATENATE(Name, CONCATENATE(C, CONCATENATE(channels, Bench))) : public MorphoBenchBase\
+{\
+public:\
+   CONCATENATE(Name, CONCATENATE(C, CONCATENATE(channels, Bench)))()\
+   : MorphoBenchBase(channels)\
+   { }\
+   bool HasCVTest() const { return false; }\
+   bool HasCUDATest() const { return false; }\
+   void RunIPP()\
+   {\
+      IPP_CODE(\
+         CONCATENATE(CONCATENATE(ippi, Name), CONCATENATE(3x3_8u_C, CONCATENATE(channels, R)))(\
+            m_ImgSrc.Data(1, 1), m_ImgSrc.Step, m_ImgDstIPP.Data(1, 1), m_ImgDstIPP.Step, m_ROI1);\
+         )\
+   }\
+   void RunCL()\
+   {\
+      CONCATENATE(CONCATENATE(ocip, Name), _B)(m_CLBufferSrc, m_CLBufferDst, 3);\
+   }\
+   void RunNPP()\
+   {\
+      NPP_CODE(\
+         CONCATENATE(CONCATENATE(nppi, Name), CONCATENATE(3x3_8u_C, CONCATENATE(channels, R)))(\
+            (Npp8u*) m_NPPSrc, m_NPPSrcStep, (Npp8u*) m_NPPDst, m_NPPDstStep, m_NPPRoi);\
+         )\
+   }\
+};
+
+MORPHO_BENCH_C(Erode, 3)
+MORPHO_BENCH_C(Erode, 4)
+MORPHO_BENCH_C(Dilate, 3)
+MORPHO_BENCH_C(Dilate, 4)
@@ -22,14 +22,25 @@
 //! 
 ////////////////////////////////////////////////////////////////////////////////
 
-class TransferBench : public IBench
+// Host memory used for the transfers
+enum ETransferMode
+{
+   PageableTransfer,    // Ordinary memory allocated by the application - the driver does a staging copy
+   PinnedTransfer,      // Pinned memory from ocipAllocHost() - transfers run at full DMA bandwidth
+   MappedTransfer,      // Pinned memory used directly by the device (CL_MEM_USE_HOST_PTR) - transfers are map / unmap
+};
+
+template<ETransferMode Mode>
+class TransferModeBench : public IBench
 {
 public:
-   TransferBench()
+   TransferModeBench()
    : m_CUDASrc(nullptr)
    , m_CUDASrcStep(0)
    , m_CLBufferSrc(nullptr)
    , m_CLBufferDst(nullptr)
+   , m_CLHostSrc(nullptr)
+   , m_CLHostDst(nullptr)
    { }
 
    void Create(uint Width, uint Height);
@@ -40,9 +51,10 @@ public:
    void RunCL();
 
    bool HasNPPTest() { return false; } // NPP will have the same speed as CUDA
+   bool HasCUDATest() const { return Mode == PageableTransfer; }
 
-   bool CompareCUDA(TransferBench*) { return true; }
-   bool CompareCL(TransferBench*) { return true; }
+   bool CompareCUDA(TransferModeBench*) { return true; }
+   bool CompareCL(TransferModeBench*) { return true; }
 
 protected:
    CSimpleImage m_ImgSrc;
@@ -55,9 +67,17 @@ protected:
 
    ocipBuffer m_CLBufferSrc;
    ocipBuffer m_CLBufferDst;
+
+   void * m_CLHostSrc;  // Pinned memory, when not using PageableTransfer
+   void * m_CLHostDst;
 };
+
+typedef TransferModeBench<PageableTransfer> TransferBench;
+typedef TransferModeBench<PinnedTransfer> PinnedTransferBench;
+typedef TransferModeBench<MappedTransfer> MappedTransferBench;
 //-----------------------------------------------------------------------------------------------------------------------------
-void TransferBench::Create(uint Width, uint Height)
+template<ETransferMode Mode>
+void TransferModeBench<Mode>::Create(uint Width, uint Height)
 {
    m_ImgSrc.Create<unsigned char>(Width, Height);
    m_ImgDst.Create<unsigned char>(Width, Height);
@@ -70,11 +90,25 @@ void TransferBench::Create(uint Width, uint Height)
       )
 
    // CL
-   ocipCreateImageBuffer(&m_CLBufferSrc, m_ImgSrc.ToSImage(), m_ImgSrc.Data(), CL_MEM_READ_ONLY);
-   ocipCreateImageBuffer(&m_CLBufferDst, m_ImgSrc.ToSImage(), m_ImgSrc.Data(), CL_MEM_WRITE_ONLY);
+   if (Mode == PageableTransfer)
+   {
+      ocipCreateImageBuffer(&m_CLBufferSrc, m_ImgSrc.ToSImage(), m_ImgSrc.Data(), CL_MEM_READ_ONLY);
+      ocipCreateImageBuffer(&m_CLBufferDst, m_ImgDst.ToSImage(), m_ImgDst.Data(), CL_MEM_WRITE_ONLY);
+      return;
+   }
+
+   size_t Size = size_t(m_ImgSrc.Step) * m_ImgSrc.Height;
+   ocipAllocHost(&m_CLHostSrc, Size);
+   ocipAllocHost(&m_CLHostDst, Size);
+   memcpy(m_CLHostSrc, m_ImgSrc.Data(), Size);
+
+   cl_mem_flags Flags = (Mode == MappedTransfer ? CL_MEM_USE_HOST_PTR : 0);
+   ocipCreateImageBuffer(&m_CLBufferSrc, m_ImgSrc.ToSImage(), m_CLHostSrc, CL_MEM_READ_ONLY | Flags);
+   ocipCreateImageBuffer(&m_CLBufferDst, m_ImgDst.ToSImage(), m_CLHostDst, CL_MEM_WRITE_ONLY | Flags);
 }
 //-----------------------------------------------------------------------------------------------------------------------------
-void TransferBench::Free()
+template<ETransferMode Mode>
+void TransferModeBench<Mode>::Free()
 {
    // CUDA
    CUDA_CODE(
@@ -85,20 +119,29 @@ void TransferBench::Free()
    // CL
    ocipReleaseImageBuffer(m_CLBufferSrc);
    ocipReleaseImageBuffer(m_CLBufferDst);
+
+   if (m_CLHostSrc != nullptr)
+   {
+      ocipFreeHost(m_CLHostSrc);
+      ocipFreeHost(m_CLHostDst);
+   }
 }
 //-----------------------------------------------------------------------------------------------------------------------------
-void TransferBench::RunIPP()
+template<ETransferMode Mode>
+void TransferModeBench<Mode>::RunIPP()
 {
    // Nothing to do
 }
 //-----------------------------------------------------------------------------------------------------------------------------
-void TransferBench::RunCL()
+template<ETransferMode Mode>
+void TransferModeBench<Mode>::RunCL()
 {
    ocipSendImageBuffer(m_CLBufferSrc);
    ocipReadImageBuffer(m_CLBufferDst);
 }
 //-----------------------------------------------------------------------------------------------------------------------------
-void TransferBench::RunCUDA()
+template<ETransferMode Mode>
+void TransferModeBench<Mode>::RunCUDA()
 {
    CUDA_CODE(
       CUDAPP(Upload)(m_ImgSrc.Data(), m_ImgSrc.Step,
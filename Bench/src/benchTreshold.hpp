@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: benchTreshold.hpp
+//! @date   : Oct 2026
+//!
+//! @brief  : Benchmark classes for tresholding on image buffers
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Uses the defines described in benchArithmetic.hpp
+// With USE_BUFFER set to true, these test TresholdingVector
+
+#define HAS_FLOAT
+#define CONSTANT_MIDDLE
+#define NO_CUSTOM_CUDA
+
+#define CONSTANT_LAST , 100, 200
+
+#define BENCH_NAME TresholdGT
+#define IPP_NAME Threshold_GTVal
+#include "benchUnary.hpp"
+
+#undef CONSTANT_LAST
+#define CONSTANT_LAST , 100, 10
+
+#define BENCH_NAME TresholdLT
+#define IPP_NAME Threshold_LTVal
+#include "benchUnary.hpp"
+
+#undef CONSTANT_LAST
+#define CONSTANT_LAST , 50, 10, 200, 250
+
+#define BENCH_NAME TresholdGTLT
+#define IPP_NAME Threshold_LTValGTVal
+#include "benchUnary.hpp"
+
+#undef CONSTANT_LAST
+#undef CONSTANT_MIDDLE
+#undef NO_CUSTOM_CUDA
+#undef HAS_FLOAT
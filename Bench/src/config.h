@@ -28,5 +28,6 @@
 //#define FULL_BENCH    // All image sizes - comment to run only a single image size for faster run time
 //#define FULL_TESTS      // All tests - uncomment to run unit tests instead of benchmark
 #define WAITFORKEY_AT_END
+//#define WORK_GROUP_TUNING_PATH "./"  // Tune work-group sizes and save the results in this folder - later runs use the saved results
 
 #define SUCCESS_EPSILON 0.0001f
@@ -27,6 +27,7 @@
 //-------------------------------------------------------------------------------------------------
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -366,6 +367,11 @@ int main()
 
    ocipSetCLFilesPath("D:/OpenCLIPP/cl files/");
 
+#ifdef WORK_GROUP_TUNING_PATH
+   ocipSetBinaryCachePath(WORK_GROUP_TUNING_PATH);
+   ocipEnableWorkGroupTuning(1);
+#endif   // WORK_GROUP_TUNING_PATH
+
 #ifdef FULL_TESTS
    printf("Running unit tests using randomly generated images\n");
    printf("All primitives having an IPP equivalent and a test class are run and compared with IPP\n");
@@ -84,9 +84,9 @@ FOR_EACH_COMMA(function, ...) -> Generates a comma seperated list of each argume
 #ifdef _MSC_VER
 
 // Works with Visual Studio 2012
-#define __VA_NUM_ARGS(...) _VA_NUM_ARGS((0, __ID(__VA_ARGS__), 8, 7, 6, 5, 4, 3, 2, 1, 0))
-#define __HAS_ARGS(...) _HAS_ARGS((0, __ID(__VA_ARGS__), 1, 1, 1, 1, 1, 1, 1, 1, 0))
-#define _SELECT_N(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+#define __VA_NUM_ARGS(...) _VA_NUM_ARGS((0, __ID(__VA_ARGS__), 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0))
+#define __HAS_ARGS(...) _HAS_ARGS((0, __ID(__VA_ARGS__), 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0))
+#define _SELECT_N(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, N, ...) N
 #define _VA_NUM_ARGS(tuple) _SELECT_N tuple
 #define _HAS_ARGS(tuple) _SELECT_N tuple
 
@@ -95,10 +95,10 @@ FOR_EACH_COMMA(function, ...) -> Generates a comma seperated list of each argume
 
 // Works with g++
 #define _COMMA(...) ,
-#define _HAS_COMMA(...) _SELECT_N(0, __VA_ARGS__, 1, 1, 1, 1, 1, 1, 1, 0, 0, -1)
+#define _HAS_COMMA(...) _SELECT_N(0, __VA_ARGS__, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, -1)
 #define __VA_NUM_ARGS(...) _NUM_ARGS1(_HAS_COMMA(__VA_ARGS__), \
       _HAS_COMMA(_COMMA __VA_ARGS__ ()), \
-      _SELECT_N(0, __VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0, -1))
+      _SELECT_N(0, __VA_ARGS__, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, -1))
 
 #define __HAS_ARGS(...) _NUM_ARGS1(_HAS_COMMA(__VA_ARGS__), \
       _HAS_COMMA(_COMMA __VA_ARGS__ ()), 1)
@@ -109,7 +109,7 @@ FOR_EACH_COMMA(function, ...) -> Generates a comma seperated list of each argume
 #define _NUM_ARGS3_00(N)    1
 #define _NUM_ARGS3_11(N)    N
 
-#define _SELECT_N(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+#define _SELECT_N(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, N, ...) N
 
 #endif	// _MSC_VER
 
@@ -129,6 +129,10 @@ FOR_EACH_COMMA(function, ...) -> Generates a comma seperated list of each argume
 #define _FOR_EACH_6(x, a, b, c, d, e, f) x(a) _FOR_EACH_5(x, b, c, d, e, f)
 #define _FOR_EACH_7(x, a, b, c, d, e, f, g) x(a) _FOR_EACH_6(x, b, c, d, e, f, g)
 #define _FOR_EACH_8(x, a, b, c, d, e, f, g, h) x(a) _FOR_EACH_7(x, b, c, d, e, f, g, h)
+#define _FOR_EACH_9(x, a, b, c, d, e, f, g, h, i) x(a) _FOR_EACH_8(x, b, c, d, e, f, g, h, i)
+#define _FOR_EACH_10(x, a, b, c, d, e, f, g, h, i, j) x(a) _FOR_EACH_9(x, b, c, d, e, f, g, h, i, j)
+#define _FOR_EACH_11(x, a, b, c, d, e, f, g, h, i, j, k) x(a) _FOR_EACH_10(x, b, c, d, e, f, g, h, i, j, k)
+#define _FOR_EACH_12(x, a, b, c, d, e, f, g, h, i, j, k, l) x(a) _FOR_EACH_11(x, b, c, d, e, f, g, h, i, j, k, l)
 
 #define _FOR_EACH_COMMA_0(...)
 #define _FOR_EACH_COMMA_1(x, a) x(a)
@@ -139,3 +143,7 @@ FOR_EACH_COMMA(function, ...) -> Generates a comma seperated list of each argume
 #define _FOR_EACH_COMMA_6(x, a, b, c, d, e, f) _FOR_EACH_COMMA_5(x, a, b, c, d, e), x(f)
 #define _FOR_EACH_COMMA_7(x, a, b, c, d, e, f, g) _FOR_EACH_COMMA_6(x, a, b, c, d, e, f), x(g)
 #define _FOR_EACH_COMMA_8(x, a, b, c, d, e, f, g, h) _FOR_EACH_COMMA_7(x, a, b, c, d, e, f, g), x(h)
+#define _FOR_EACH_COMMA_9(x, a, b, c, d, e, f, g, h, i) _FOR_EACH_COMMA_8(x, a, b, c, d, e, f, g, h), x(i)
+#define _FOR_EACH_COMMA_10(x, a, b, c, d, e, f, g, h, i, j) _FOR_EACH_COMMA_9(x, a, b, c, d, e, f, g, h, i), x(j)
+#define _FOR_EACH_COMMA_11(x, a, b, c, d, e, f, g, h, i, j, k) _FOR_EACH_COMMA_10(x, a, b, c, d, e, f, g, h, i, j), x(k)
+#define _FOR_EACH_COMMA_12(x, a, b, c, d, e, f, g, h, i, j, k, l) _FOR_EACH_COMMA_11(x, a, b, c, d, e, f, g, h, i, j, k), x(l)
@@ -23,54 +23,225 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "Buffer.h"
+#include "Image.h"
+
+#include <cstring>
 
 namespace OpenCLIPP
 {
 
+// Helpers
+void AddProfilingRecord(COpenCL& CL, const char * Name, Buffer& Buf, const cl::Event& Event);  // Records a transfer when profiling is enabled
+void CL_CALLBACK FreeHostCopy(cl_event Event, cl_int Status, void * Data);  // Frees the host copy made by ReadBuffer
+void AddDependency(std::vector<cl::Event>& WaitList, const cl::Event& Event, const cl::CommandQueue& Queue);  // Adds an event from another queue to WaitList
+void EnqueueMarker(cl::CommandQueue& Queue, const std::vector<cl::Event>& WaitList, cl::Event& Event);  // Enqueues a marker signaled when WaitList and the previous commands of Queue are done
+
+
 // Memory
 Memory::Memory()
-:  m_isInDevice(false)
+:  m_isInDevice(false),
+   m_Container(nullptr)
 { }
 
 bool Memory::IsInDevice() const
 {
+   if (m_Container != nullptr)
+      return m_Container->IsInDevice();
+
    return m_isInDevice;
 }
 
 void Memory::SetInDevice(bool inDevice)
 {
+   if (m_Container != nullptr)
+   {
+      m_Container->SetInDevice(inDevice);
+      return;
+   }
+
    m_isInDevice = inDevice;
 }
 
+void Memory::WaitForEvents()
+{
+   std::vector<cl::Event> Events;
+   GetAllEvents(Events);
+
+   if (!Events.empty())
+      cl::Event::waitForEvents(Events);
+}
+
+void Memory::AddReadDependencies(std::vector<cl::Event>& WaitList, const cl::CommandQueue& Queue) const
+{
+   if (m_Container != nullptr)
+   {
+      m_Container->AddReadDependencies(WaitList, Queue);
+      return;
+   }
+
+   if (m_LastWrite.Event() != nullptr && m_LastWrite.Queue() != Queue())
+      AddDependency(WaitList, m_LastWrite.Event, m_LastWrite.Queue);
+}
+
+void Memory::AddWriteDependencies(std::vector<cl::Event>& WaitList, const cl::CommandQueue& Queue) const
+{
+   if (m_Container != nullptr)
+   {
+      m_Container->AddWriteDependencies(WaitList, Queue);
+      return;
+   }
+
+   AddReadDependencies(WaitList, Queue);
+
+   for (auto& Read : m_PendingReads)
+      if (Read.Queue() != Queue())
+         AddDependency(WaitList, Read.Event, Read.Queue);
+}
+
+void Memory::SetReadEvent(const cl::Event& Event, const cl::CommandQueue& Queue)
+{
+   if (m_Container != nullptr)
+   {
+      m_Container->SetReadEvent(Event, Queue);
+      return;
+   }
+
+   // The queues are in-order so only the last read done in each queue needs to be kept
+   for (auto& Read : m_PendingReads)
+      if (Read.Queue() == Queue())
+      {
+         Read.Event = Event;
+         return;
+      }
+
+   SOperation Read = {Event, Queue};
+   m_PendingReads.push_back(Read);
+}
+
+void Memory::SetWriteEvent(const cl::Event& Event, const cl::CommandQueue& Queue)
+{
+   if (m_Container != nullptr)
+   {
+      m_Container->SetWriteEvent(Event, Queue);
+      return;
+   }
+
+   // The write waited for the previous write and for the reads
+   m_LastWrite.Event = Event;
+   m_LastWrite.Queue = Queue;
+   m_PendingReads.clear();
+}
+
+void Memory::GetAllEvents(std::vector<cl::Event>& Events) const
+{
+   if (m_Container != nullptr)
+   {
+      m_Container->GetAllEvents(Events);
+      return;
+   }
+
+   if (m_LastWrite.Event() != nullptr)
+      Events.push_back(m_LastWrite.Event);
+
+   for (auto& Read : m_PendingReads)
+      Events.push_back(Read.Event);
+}
+
+std::weak_ptr<void> Memory::GetLifetime()
+{
+   if (m_Lifetime == nullptr)
+      m_Lifetime = std::make_shared<char>(0);
+
+   return m_Lifetime;
+}
+
+void Memory::AddPendingEvents(const std::vector<cl::Event>& Events)
+{
+   // Not associated to any queue so that all operations writing the memory wait for them
+   for (auto& Event : Events)
+   {
+      SOperation Operation = {Event, cl::CommandQueue()};
+      m_PendingReads.push_back(Operation);
+   }
+}
+
 
 // IBuffer
 IBuffer::IBuffer(COpenCL& CL, size_t size, cl_mem_flags flags, void * data, bool copy)
 :  m_Size(size),
-   m_HostBuffer(false)
+   m_Transfer(CopyTransfer),
+   m_Flags(flags)
 {
-   if (copy)
+   if (!copy)
+      m_Transfer = CL.GetTransferStrategy(data, flags);
+
+   if (m_Transfer != CopyTransfer)
    {
-      // OpenCL will make a copy of the data and will automatically transfer the data to the device when needed
-      m_Buffer = cl::Buffer(CL, flags | CL_MEM_COPY_HOST_PTR, size, data);
+      // Use HOST_PTR mode to avoid memory transfers
+      m_Flags |= CL_MEM_USE_HOST_PTR;
       m_isInDevice = true;
+      m_Buffer = cl::Buffer(CL, m_Flags, size, data);
+      return;
    }
-   else
+
+   // Device only memory, take it from the pool
+   m_Flags &= ~CL_MEM_USE_HOST_PTR;
+   CreateInPool(CL);
+
+   if (copy)
    {
-      if (CL.SupportsNoCopy() && data != nullptr)
+      // Send a copy of the data to the device, the copy is freed when the transfer is done
+      cl::CommandQueue& Queue = CL.GetQueue();
+
+      std::vector<cl::Event> WaitList;
+      AddWriteDependencies(WaitList, Queue);
+
+      char * HostCopy = new char[size];
+      memcpy(HostCopy, data, size);
+
+      cl::Event SendEvent;
+      try
       {
-         // Use HOST_PTR mode to avoid memory transfers
-         flags |= CL_MEM_USE_HOST_PTR;
-         m_HostBuffer = true;
-         m_isInDevice = true;
+         Queue.enqueueWriteBuffer(m_Buffer, CL_FALSE, 0, size, HostCopy, &WaitList, &SendEvent);
+      }
+      catch (...)
+      {
+         delete [] HostCopy;
+         throw;
       }
-      else
-         data = nullptr;
 
-      m_Buffer = cl::Buffer(CL, flags, size, data);
+      SendEvent.setCallback(CL_COMPLETE, FreeHostCopy, HostCopy);
+
+      SetWriteEvent(SendEvent, Queue);
+      m_isInDevice = true;
    }
 
 }
 
+IBuffer::IBuffer()
+:  m_Size(0),
+   m_Transfer(CopyTransfer),
+   m_Flags(0)
+{ }
+
+void IBuffer::CreateInPool(COpenCL& CL)
+{
+   std::vector<cl::Event> PendingEvents;
+   m_Pool = CL.GetMemoryPool();
+   m_Buffer = m_Pool->CreateBuffer(m_Size, m_Flags, PendingEvents);
+   AddPendingEvents(PendingEvents);
+}
+
+IBuffer::~IBuffer()
+{
+   if (m_Pool == nullptr)
+      return;
+
+   std::vector<cl::Event> Events;
+   GetAllEvents(Events);
+   m_Pool->ReleaseBuffer(m_Buffer, m_Size, m_Flags, Events);
+}
+
 
 // TempBuffer
 TempBuffer::TempBuffer(COpenCL& CL, size_t size, cl_mem_flags flags)
@@ -79,6 +250,10 @@ TempBuffer::TempBuffer(COpenCL& CL, size_t size, cl_mem_flags flags)
 
 
 // Buffer
+Buffer::Buffer(COpenCL& CL)
+:  m_CL(CL),
+   m_data(nullptr)
+{ }
 
 // Read the image from the device memory
 void Buffer::Read(bool blocking, std::vector<cl::Event> * events, cl::Event * event)
@@ -86,31 +261,52 @@ void Buffer::Read(bool blocking, std::vector<cl::Event> * events, cl::Event * ev
    if (m_data == nullptr)
       return;
 
-   if (!m_HostBuffer)
-      m_CL.GetQueue().enqueueReadBuffer(m_Buffer, (cl_bool) blocking, 0, m_Size, m_data, events, event);
+   cl::CommandQueue& Queue = m_CL.GetTransferQueue();
+
+   // Wait for the given events and for the operations that write the buffer
+   std::vector<cl::Event> WaitList;
+   if (events != nullptr)
+      WaitList = *events;
+
+   AddReadDependencies(WaitList, Queue);
+   m_CL.WaitForKernels(WaitList);
+
+   cl::Event ReadEvent;
+
+   if (m_Transfer == CopyTransfer)
+      Queue.enqueueReadBuffer(m_Buffer, (cl_bool) blocking, 0, m_Size, m_data, &WaitList, &ReadEvent);
    else
    {
-      if (m_CL.SupportsNoCopy())
+      if (m_Transfer == NoCopyTransfer)
       {
          // The device uses the same memory for the device and the host, no transfer is needed
+         // The marker gives an event that is signaled when the data is ready to be used by the host
+         EnqueueMarker(Queue, WaitList, ReadEvent);
+
          if (blocking)
-            m_CL.GetQueue().finish();
+            ReadEvent.wait();
+
+         SetReadEvent(ReadEvent, Queue);
+
+         if (event != nullptr)
+            *event = ReadEvent;
 
          return;
       }
 
-      cl::Event unmapEvent;
       std::vector<cl::Event> mapEvent(1, cl::Event());
-      m_CL.GetQueue().enqueueMapBuffer(m_Buffer, (cl_bool) blocking, CL_MAP_READ, 0, m_Size, events, &mapEvent[0]);
-      m_CL.GetQueue().enqueueUnmapMemObject(m_Buffer, m_data, &mapEvent, &unmapEvent);
+      Queue.enqueueMapBuffer(m_Buffer, (cl_bool) blocking, CL_MAP_READ, 0, m_Size, &WaitList, &mapEvent[0]);
+      Queue.enqueueUnmapMemObject(m_Buffer, m_data, &mapEvent, &ReadEvent);
 
       if (blocking)
-         unmapEvent.wait();
-
-      if (event != nullptr)
-         *event = unmapEvent;
+         ReadEvent.wait();
    }
 
+   SetReadEvent(ReadEvent, Queue);
+   AddProfilingRecord(m_CL, "Read", *this, ReadEvent);
+
+   if (event != nullptr)
+      *event = ReadEvent;
 }
 
 // Send the image to the device memory
@@ -119,32 +315,55 @@ void Buffer::Send(bool blocking, std::vector<cl::Event> * events, cl::Event * ev
    if (m_data == nullptr)
       return;
 
-   if (!m_HostBuffer)
-      m_CL.GetQueue().enqueueWriteBuffer(m_Buffer, (cl_bool) blocking, 0, m_Size, m_data, events, event);
+   cl::CommandQueue& Queue = m_CL.GetTransferQueue();
+
+   // Wait for the given events and for the operations that use the buffer
+   std::vector<cl::Event> WaitList;
+   if (events != nullptr)
+      WaitList = *events;
+
+   AddWriteDependencies(WaitList, Queue);
+
+   cl::Event SendEvent;
+
+   if (m_Transfer == CopyTransfer)
+      Queue.enqueueWriteBuffer(m_Buffer, (cl_bool) blocking, 0, m_Size, m_data, &WaitList, &SendEvent);
    else
    {
-      if (m_CL.SupportsNoCopy())
+      if (m_Transfer == NoCopyTransfer)
       {
          // The device uses the same memory for the device and the host, no transfer is needed
+         // The marker gives an event that later operations on the memory can be ordered against
+         EnqueueMarker(Queue, WaitList, SendEvent);
+
          if (blocking)
-            m_CL.GetQueue().finish();
+            SendEvent.wait();
+
+         SetWriteEvent(SendEvent, Queue);
+         m_CL.ComputeWaitsFor(SendEvent);
+
+         if (event != nullptr)
+            *event = SendEvent;
 
          m_isInDevice = true;
          return;
       }
 
-      cl::Event unmapEvent;
       std::vector<cl::Event> mapEvent(1, cl::Event());
-      m_CL.GetQueue().enqueueMapBuffer(m_Buffer, (cl_bool) blocking, CL_MAP_WRITE, 0, m_Size, events, &mapEvent[0]);
-      m_CL.GetQueue().enqueueUnmapMemObject(m_Buffer, m_data, &mapEvent, &unmapEvent);
+      Queue.enqueueMapBuffer(m_Buffer, (cl_bool) blocking, CL_MAP_WRITE, 0, m_Size, &WaitList, &mapEvent[0]);
+      Queue.enqueueUnmapMemObject(m_Buffer, m_data, &mapEvent, &SendEvent);
 
       if (blocking)
-         unmapEvent.wait();
-
-      if (event != nullptr)
-         *event = unmapEvent;
+         SendEvent.wait();
    }
 
+   SetWriteEvent(SendEvent, Queue);
+   m_CL.ComputeWaitsFor(SendEvent);
+   AddProfilingRecord(m_CL, "Send", *this, SendEvent);
+
+   if (event != nullptr)
+      *event = SendEvent;
+
    m_isInDevice = true;
 }
 
@@ -154,4 +373,44 @@ void Buffer::SendIfNeeded()
       Send();
 }
 
+
+
+// Helpers
+void AddProfilingRecord(COpenCL& CL, const char * Name, Buffer& Buf, const cl::Event& Event)
+{
+   if (!CL.IsProfiling())
+      return;
+
+   // Use the size of the image for image buffers and the size in bytes for other buffers
+   ImageBase * Img = dynamic_cast<ImageBase *>(&Buf);
+   if (Img != nullptr)
+      CL.AddProfilingRecord(Name, Img->Width(), Img->Height(), Event);
+   else
+      CL.AddProfilingRecord(Name, uint(Buf.Size()), 1, Event);
+}
+
+void CL_CALLBACK FreeHostCopy(cl_event, cl_int, void * Data)
+{
+   delete [] (char *) Data;
+}
+
+void AddDependency(std::vector<cl::Event>& WaitList, const cl::Event& Event, const cl::CommandQueue& Queue)
+{
+   // The queue that produces the event must be flushed, otherwise the command
+   // waiting for it could wait for an operation that is never sent to the device
+   if (Queue() != nullptr)
+      clFlush(Queue());
+
+   WaitList.push_back(Event);
+}
+
+void EnqueueMarker(cl::CommandQueue& Queue, const std::vector<cl::Event>& WaitList, cl::Event& Event)
+{
+   // enqueueWaitForEvents() does not accept an empty list
+   if (!WaitList.empty())
+      Queue.enqueueWaitForEvents(WaitList);
+
+   Queue.enqueueMarker(&Event);
+}
+
 }
@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: EmbeddedClFiles.cpp
+//! @date   : Oct 2026
+//!
+//! @brief  : Access to the .cl files compiled in the library
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "EmbeddedClFiles.h"
+
+#include <cstring>
+
+namespace OpenCLIPP
+{
+
+struct SEmbeddedClFile
+{
+   const char * Name;
+   const char * Source;
+};
+
+static const SEmbeddedClFile EmbeddedClFiles[] =
+{
+#ifdef OPENCLIPP_EMBED_CL
+#include "ClFiles.inc"     // Generated by the makefile from the .cl files
+#endif   // OPENCLIPP_EMBED_CL
+   { nullptr, nullptr }
+};
+
+const char * GetEmbeddedClFile(const char * Name)
+{
+   for (const SEmbeddedClFile * File = EmbeddedClFiles; File->Name != nullptr; File++)
+      if (strcmp(File->Name, Name) == 0)
+         return File->Source;
+
+   return nullptr;
+}
+
+}
@@ -0,0 +1,37 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: EmbeddedClFiles.h
+//! @date   : Oct 2026
+//!
+//! @brief  : Access to the .cl files compiled in the library
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+namespace OpenCLIPP
+{
+
+/// Returns the source of a .cl file that was compiled in the library (for internal use).
+/// The makefile converts the content of "cl files/" to a table of strings when building the library.
+/// \param Name : Name of the .cl file, like "Arithmetic.cl"
+/// \return the source code of the file, nullptr if the file is not embedded in the library
+const char * GetEmbeddedClFile(const char * Name);
+
+}
@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: FramePipeline.cpp
+//! @date   : Oct 2026
+//!
+//! @brief  : Double-buffered processing of streams of frames
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "FramePipeline.h"
+
+#include <cstring>
+#include <algorithm>
+
+using namespace std;
+
+namespace OpenCLIPP
+{
+
+FramePipeline::FramePipeline(COpenCL& CL, const SImage& Source, const SImage& Dest, const Operation& Function, uint Depth)
+:  m_CL(CL),
+   m_Function(Function),
+   m_First(0),
+   m_NbPending(0)
+{
+   if (Source.Width != Dest.Width || Source.Height != Dest.Height)
+      throw cl::Error(CL_INVALID_VALUE, "the source and destination of a frame pipeline must have the same size");
+
+   if (Source.Channels == 3 || Dest.Channels == 3)
+      throw cl::Error(CL_IMAGE_FORMAT_NOT_SUPPORTED, "3 channel images can't be used in a frame pipeline");
+
+   if (Depth == 0)
+      throw cl::Error(CL_INVALID_VALUE, "a frame pipeline needs at least 1 slot");
+
+   // Transfers must not wait behind the kernels of other frames
+   // The caller enables the transfer queue, it changes how all the transfers of CL are done
+   if (!m_CL.HasTransferQueue())
+      throw cl::Error(CL_INVALID_COMMAND_QUEUE, "a frame pipeline needs a COpenCL that uses a transfer queue - call UseTransferQueue() first");
+
+   for (uint i = 0; i < Depth; i++)
+   {
+      unique_ptr<SSlot> Slot(new SSlot);
+      Slot->SourceData = m_CL.AllocHost(size_t(Source.Step) * Source.Height);
+      Slot->DestData = m_CL.AllocHost(size_t(Dest.Step) * Dest.Height);
+      Slot->Source.reset(new Image(m_CL, Source, Slot->SourceData));
+      Slot->Dest.reset(new Image(m_CL, Dest, Slot->DestData));
+      Slot->Profiled = false;
+      m_Slots.push_back(move(Slot));
+   }
+
+   ResetStats();
+}
+
+bool FramePipeline::Push(const void * Data)
+{
+   if (IsFull())
+      return false;
+
+   // The slot is free : the previous frame that used it has been popped
+   SSlot& Slot = *m_Slots[(m_First + m_NbPending) % m_Slots.size()];
+
+   Slot.PushTime = Clock::now();
+   if (!m_Started)
+   {
+      m_FirstPush = Slot.PushTime;
+      m_Started = true;
+   }
+
+   memcpy(Slot.SourceData->Data(), Data, Slot.SourceData->Size());
+
+   Slot.Profiled = m_CL.IsProfiling();
+   Slot.Upload = cl::Event();
+   Slot.Download = cl::Event();
+
+   Slot.Source->Send(false, nullptr, &Slot.Upload);
+
+   m_Function(*Slot.Source, *Slot.Dest);
+
+   // Signals the end of the kernels of the frame, also those that don't track their events
+   m_CL.GetQueue().enqueueMarker(&Slot.Compute);
+
+   Slot.Dest->Read(false, nullptr, &Slot.Download);
+
+   Slot.Done.clear();
+   Slot.Done.push_back(Slot.Compute);
+   Slot.Source->GetAllEvents(Slot.Done);
+   Slot.Dest->GetAllEvents(Slot.Done);
+
+   // Start the execution now so that Pop() without waiting sees the frames progress
+   m_CL.GetQueue().flush();
+   m_CL.GetTransferQueue().flush();
+
+   m_NbPending++;
+   return true;
+}
+
+bool FramePipeline::Pop(void * Data, bool Wait)
+{
+   if (m_NbPending == 0)
+      return false;
+
+   SSlot& Slot = *m_Slots[m_First];
+
+   if (!Wait)
+      for (auto& Event : Slot.Done)
+         if (Event.getInfo<CL_EVENT_COMMAND_EXECUTION_STATUS>() > CL_COMPLETE)
+            return false;
+
+   cl::Event::waitForEvents(Slot.Done);
+
+   memcpy(Data, Slot.DestData->Data(), Slot.DestData->Size());
+
+   AddStats(Slot);
+
+   m_First = (m_First + 1) % uint(m_Slots.size());
+   m_NbPending--;
+   return true;
+}
+
+uint FramePipeline::GetNbPending() const
+{
+   return m_NbPending;
+}
+
+bool FramePipeline::IsFull() const
+{
+   return m_NbPending == m_Slots.size();
+}
+
+SPipelineStats FramePipeline::GetStats() const
+{
+   SPipelineStats Stats = SPipelineStats();
+   Stats.NbFrames = m_NbFrames;
+
+   if (m_NbFrames == 0)
+      return Stats;
+
+   double Seconds = chrono::duration<double>(m_LastPop - m_FirstPush).count();
+   if (Seconds > 0)
+      Stats.FramesPerSecond = m_NbFrames / Seconds;
+
+   Stats.LatencyMs = m_TotalLatency / m_NbFrames;
+
+   if (m_NbProfiled > 0)
+   {
+      Stats.UploadMs = m_TotalUpload / m_NbProfiled;
+      Stats.ComputeMs = m_TotalCompute / m_NbProfiled;
+      Stats.DownloadMs = m_TotalDownload / m_NbProfiled;
+   }
+
+   return Stats;
+}
+
+void FramePipeline::ResetStats()
+{
+   m_Started = false;
+   m_NbFrames = 0;
+   m_NbProfiled = 0;
+   m_TotalLatency = 0;
+   m_TotalUpload = 0;
+   m_TotalCompute = 0;
+   m_TotalDownload = 0;
+}
+
+void FramePipeline::AddStats(SSlot& Slot)
+{
+   m_LastPop = Clock::now();
+   m_NbFrames++;
+   m_TotalLatency += chrono::duration<double, milli>(m_LastPop - Slot.PushTime).count();
+
+   // Transfers that don't copy (the device uses the host memory) have no event
+   if (!Slot.Profiled || Slot.Upload() == nullptr || Slot.Download() == nullptr)
+      return;
+
+   // Each stage is measured from the end of the previous one, on the device clock
+   cl_ulong UploadStart = Slot.Upload.getProfilingInfo<CL_PROFILING_COMMAND_START>();
+   cl_ulong UploadEnd = Slot.Upload.getProfilingInfo<CL_PROFILING_COMMAND_END>();
+   cl_ulong ComputeEnd = max(Slot.Compute.getProfilingInfo<CL_PROFILING_COMMAND_END>(), UploadEnd);
+   cl_ulong DownloadEnd = max(Slot.Download.getProfilingInfo<CL_PROFILING_COMMAND_END>(), ComputeEnd);
+
+   m_TotalUpload += (UploadEnd - UploadStart) * 1e-6;
+   m_TotalCompute += (ComputeEnd - UploadEnd) * 1e-6;
+   m_TotalDownload += (DownloadEnd - ComputeEnd) * 1e-6;
+   m_NbProfiled++;
+}
+
+}
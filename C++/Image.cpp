@@ -25,6 +25,8 @@
 #include "Image.h"
 #include "Programs/Color.h"
 
+#include <algorithm>
+
 namespace OpenCLIPP
 {
 
@@ -32,8 +34,11 @@ namespace OpenCLIPP
 uint DepthOfType(SImage::EDataType Type);    // Gets the number of bits of the given type
 SImage TempSImage(SSize Size, SImage::EDataType Type, uint NbChannels = 1);   // Makes a SImage for a temporary (in-device only) image
 cl::ImageFormat FormatFromImage(const SImage& Image);
-bool IsSupportedFormat(const cl::ImageFormat& inFormat, const cl::Context& context, cl_mem_flags flags);
 uint align_step(uint step, uint alignement = 128);
+SImage RegionSImage(const SImage& Image, const SRect& Region);   // Makes a SImage for a region of an image
+void * PinnedData(const std::shared_ptr<PinnedMemory>& Data, const SImage& Image);  // Checks the size of the pinned memory and returns its host pointer
+SImage BatchSImage(const SImage& Image, uint NbImages);   // Makes a SImage for a batch of images
+void EnqueueMarker(cl::CommandQueue& Queue, const std::vector<cl::Event>& WaitList, cl::Event& Event);  // Enqueues a marker signaled when WaitList and the previous commands of Queue are done
 
 
 // ImageBase
@@ -48,7 +53,8 @@ cl::NDRange ImageBase::FullRange()
 
 cl::NDRange ImageBase::VectorRange(int NbElementsPerWorker)
 {
-   return cl::NDRange(Width() * NbChannels() / NbElementsPerWorker, Height(), 1);
+   // Rounded up so that the last values of each line get a worker when the width is not a multiple
+   return cl::NDRange((Width() * NbChannels() + NbElementsPerWorker - 1) / NbElementsPerWorker, Height(), 1);
 }
 
 uint ImageBase::Width() const
@@ -110,6 +116,7 @@ bool ImageBase::IsFloat() const
    case SImage::S32:
       return false;
    case SImage::F32:
+   case SImage::F16:
       return true;
    case SImage::NbDataTypes:
    default:
@@ -131,6 +138,7 @@ bool ImageBase::IsUnsigned() const
    case SImage::S16:
    case SImage::S32:
    case SImage::F32:
+   case SImage::F16:
       return false;
    case SImage::NbDataTypes:
    default:
@@ -153,9 +161,29 @@ ImageBase::operator const SImage& () const
 // ImageBuffer
 ImageBuffer::ImageBuffer(COpenCL& CL, const SImage& Image, void * ImageData, cl_mem_flags flags)
 :  Buffer(CL, (char *) ImageData, Image.Height * Image.Step, flags),
-   ImageBase(Image)
+   ImageBase(Image),
+   m_Offset(0)
 { }
 
+ImageBuffer::ImageBuffer(COpenCL& CL, const SImage& Image, std::shared_ptr<PinnedMemory> Data, cl_mem_flags flags)
+:  Buffer(CL, (char *) PinnedData(Data, Image), Image.Height * Image.Step, flags),
+   ImageBase(Image),
+   m_Pinned(Data),
+   m_Offset(0)
+{ }
+
+ImageBuffer::ImageBuffer(COpenCL& CL, const SImage& Image)
+:  Buffer(CL),
+   ImageBase(Image),
+   m_Offset(0)
+{ }
+
+ImageBuffer::~ImageBuffer()
+{
+   if (m_Pinned != nullptr)
+      WaitForEvents();
+}
+
 
 // TempImageBuffer
 TempImageBuffer::TempImageBuffer(COpenCL& CL, const SImage& Image, cl_mem_flags flags)
@@ -168,16 +196,205 @@ TempImageBuffer::TempImageBuffer(COpenCL& CL, SSize Size, SImage::EDataType Type
 { }
 
 
+// ImageBufferOffset
+// Region of an image buffer that starts at an element offset in the memory of the image buffer
+class ImageBufferOffset : public ImageBuffer
+{
+public:
+   ImageBufferOffset(COpenCL& CL, ImageBuffer& Root, const SImage& Image, size_t Origin)
+   :  ImageBuffer(CL, Image),
+      m_Root(Root)
+   {
+      cl::Buffer& RootBuffer = Root;
+      m_Img.Step = Root.Step();
+      m_Buffer = RootBuffer;
+      m_Size = Root.IBuffer::Size();
+      m_Flags = m_Buffer.getInfo<CL_MEM_FLAGS>() & (CL_MEM_READ_WRITE | CL_MEM_WRITE_ONLY | CL_MEM_READ_ONLY);
+      m_Offset = uint(Origin / DepthBytes());
+      m_Container = &Root;
+   }
+
+   void SendIfNeeded()
+   {
+      m_Root.SendIfNeeded();
+   }
+
+private:
+   ImageBuffer& m_Root;
+};
+
+
+// ImageBufferView
+ImageBufferView::ImageBufferView(COpenCL& CL, ImageBuffer& Parent, const SRect& Region)
+:  ImageBuffer(CL, RegionSImage(Parent, Region)),
+   m_Parent(Parent),
+   m_Region(Region)
+{
+   if (Region.Width == 0 || Region.Height == 0 ||
+      Region.X + Region.Width > Parent.Width() || Region.Y + Region.Height > Parent.Height())
+   {
+      throw cl::Error(CL_INVALID_VALUE, "the region of an image buffer view must be inside its parent");
+   }
+
+   Parent.SendIfNeeded();
+
+   const uint PixelBytes = NbChannels() * DepthBytes();
+
+   // Sub-buffers can't be made from sub-buffers, so views of views are made from the buffer that contains them
+   ImageBuffer * Root = &Parent;
+   size_t Origin = size_t(Region.Y) * Parent.Step() + Region.X * PixelBytes;
+   for (ImageBufferView * View = dynamic_cast<ImageBufferView *>(Root);
+      View != nullptr && View->IsSubBuffer(); View = dynamic_cast<ImageBufferView *>(Root))
+   {
+      Origin += size_t(View->m_Region.Y) * View->m_Parent.Step() + View->m_Region.X * PixelBytes;
+      Root = &View->m_Parent;
+   }
+
+   size_t Alignment = CL.GetDeviceInfo().MemBaseAddrAlign / 8;
+   if (Alignment > 0 && Origin % Alignment == 0)
+   {
+      // The view is a part of the root buffer, no copy is needed
+      cl::Buffer& RootBuffer = *Root;
+      m_Size = std::min(NbBytes(), Root->IBuffer::Size() - Origin);
+      m_Flags = RootBuffer.getInfo<CL_MEM_FLAGS>() & (CL_MEM_READ_WRITE | CL_MEM_WRITE_ONLY | CL_MEM_READ_ONLY);
+
+      cl_buffer_region BufferRegion = {Origin, m_Size};
+      m_Buffer = RootBuffer.createSubBuffer(m_Flags, CL_BUFFER_CREATE_TYPE_REGION, &BufferRegion);
+      m_Container = Root;
+      return;
+   }
+
+   // Kernels that accept an element offset use the region in the root buffer
+   if (Origin % DepthBytes() == 0)
+      m_Direct.reset(new ImageBufferOffset(CL, *Root, m_Img, Origin));
+
+   // The other kernels use a copy of the region - with aligned rows so that vector kernels can use it
+   m_Img = TempSImage(ImageBase::Size(), DataType(), NbChannels());
+   m_Img.Step = align_step(m_Img.Step);
+   m_Size = NbBytes();
+   m_Flags = CL_MEM_READ_WRITE;
+   CreateInPool(CL);
+}
+
+ImageBuffer& ImageBufferView::Direct()
+{
+   if (m_Direct == nullptr)
+      return *this;
+
+   return *m_Direct;
+}
+
+void ImageBufferView::SendIfNeeded()
+{
+   m_Parent.SendIfNeeded();
+
+   // The parent may have been changed since the last copy
+   if (!IsSubBuffer())
+      CopyRegion(true);
+}
+
+void ImageBufferView::SetWriteEvent(const cl::Event& Event, const cl::CommandQueue& Queue)
+{
+   ImageBuffer::SetWriteEvent(Event, Queue);
+
+   if (!IsSubBuffer())
+      CopyRegion(false);
+}
+
+void ImageBufferView::CopyRegion(bool FromParent)
+{
+   cl::CommandQueue& Queue = m_CL.GetQueue();
+
+   std::vector<cl::Event> WaitList;
+   if (FromParent)
+   {
+      m_Parent.AddReadDependencies(WaitList, Queue);
+      AddWriteDependencies(WaitList, Queue);
+   }
+   else
+   {
+      AddReadDependencies(WaitList, Queue);
+      m_Parent.AddWriteDependencies(WaitList, Queue);
+   }
+
+   cl::size_t<3> ParentOrigin, ViewOrigin, Region;
+   ParentOrigin[0] = m_Region.X * NbChannels() * DepthBytes();
+   ParentOrigin[1] = m_Region.Y;
+   Region[0] = Width() * NbChannels() * DepthBytes();
+   Region[1] = Height();
+   Region[2] = 1;
+
+   cl::Event CopyEvent;
+
+   if (FromParent)
+   {
+      Queue.enqueueCopyBufferRect(m_Parent, m_Buffer, ParentOrigin, ViewOrigin, Region,
+         m_Parent.Step(), 0, Step(), 0, &WaitList, &CopyEvent);
+
+      m_Parent.SetReadEvent(CopyEvent, Queue);
+      Memory::SetWriteEvent(CopyEvent, Queue);
+      m_isInDevice = true;
+   }
+   else
+   {
+      Queue.enqueueCopyBufferRect(m_Buffer, m_Parent, ViewOrigin, ParentOrigin, Region,
+         Step(), 0, m_Parent.Step(), 0, &WaitList, &CopyEvent);
+
+      SetReadEvent(CopyEvent, Queue);
+      m_Parent.SetWriteEvent(CopyEvent, Queue);
+   }
+
+}
+
+
+// ImageBufferBatch
+ImageBufferBatch::ImageBufferBatch(COpenCL& CL, const SImage& Image, uint NbImages, void * ImageData, cl_mem_flags flags)
+:  ImageBuffer(CL, BatchSImage(Image, NbImages), ImageData, flags),
+   m_NbImages(NbImages),
+   m_ImageHeight(Image.Height)
+{ }
+
+cl::NDRange ImageBufferBatch::BatchRange()
+{
+   return cl::NDRange(Width(), m_ImageHeight, m_NbImages);
+}
+
+
 // IImage
 IImage::IImage(COpenCL& CL, const SImage& Image, cl_mem_flags flags, void * data)
 :  ImageBase(Image),
    m_format(FormatFromImage(Image)),
-   m_HostBuffer(false),
-   m_CL(CL)
+   m_Transfer(CopyTransfer),
+   m_CL(CL),
+   m_Flags(flags),
+   m_Origin()
 {
    Create(flags, data);
 }
 
+IImage::IImage(COpenCL& CL, IImage& Parent, const SRect& Region)
+:  ImageBase(RegionSImage(Parent, Region)),
+   m_format(FormatFromImage(Parent)),
+   m_clImage(Parent.m_clImage),
+   m_Transfer(CopyTransfer),
+   m_CL(CL),
+   m_Flags(Parent.m_Flags),
+   m_Origin(Parent.m_Origin)
+{
+   m_Origin.X += Region.X;
+   m_Origin.Y += Region.Y;
+}
+
+IImage::~IImage()
+{
+   if (m_Pool == nullptr)
+      return;
+
+   std::vector<cl::Event> Events;
+   GetAllEvents(Events);
+   m_Pool->ReleaseImage(m_clImage, m_format, Width(), Height(), m_Flags, Events);
+}
+
 void IImage::Create(cl_mem_flags flags, void * data)
 {
    if (m_format.image_channel_order == CL_RGB)
@@ -188,23 +405,52 @@ void IImage::Create(cl_mem_flags flags, void * data)
       m_Img.Step = align_step(Width() * 4 * (Depth() / 8));
    }
 
-   if (!IsSupportedFormat(m_format, m_CL, flags))
+   if (!m_CL.IsSupportedFormat(m_format, flags))
       throw cl::Error(CL_IMAGE_FORMAT_NOT_SUPPORTED, "IImage creation");
 
-   size_t row_pitch = 0;
+   m_Flags = flags;
+
+   m_Transfer = m_CL.GetTransferStrategy(data, flags, Step());
 
-   if (m_CL.SupportsNoCopy() && data != nullptr)
+   if (m_Transfer != CopyTransfer)
    {
       // Use HOST_PTR mode to avoid memory transfers
-      row_pitch = Step();
-      m_HostBuffer = true;
-      flags |= CL_MEM_USE_HOST_PTR;
+      m_Flags |= CL_MEM_USE_HOST_PTR;
       m_isInDevice = true;
+      m_clImage = cl::Image2D(m_CL, m_Flags, m_format, Width(), Height(), Step(), data);
+      return;
    }
-   else
-      data = nullptr;
 
-   m_clImage = cl::Image2D(m_CL, flags, m_format, Width(), Height(), row_pitch, data);
+   // Device only memory, take it from the pool
+   m_Flags &= ~CL_MEM_USE_HOST_PTR;
+   std::vector<cl::Event> PendingEvents;
+   m_Pool = m_CL.GetMemoryPool();
+   m_clImage = m_Pool->CreateImage(m_format, Width(), Height(), m_Flags, PendingEvents);
+   AddPendingEvents(PendingEvents);
+}
+
+
+// ImageView
+ImageView::ImageView(COpenCL& CL, IImage& Parent, const SRect& Region)
+:  IImage(CL, Parent, Region),
+   m_Parent(Parent),
+   m_Region(Region)
+{
+   if (Region.Width == 0 || Region.Height == 0 ||
+      Region.X + Region.Width > Parent.Width() || Region.Y + Region.Height > Parent.Height())
+   {
+      throw cl::Error(CL_INVALID_VALUE, "the region of an image view must be inside its parent");
+   }
+
+   Parent.SendIfNeeded();
+
+   // The parent tracks the device state and the events of the OpenCL image
+   m_Container = &Parent;
+}
+
+void ImageView::SendIfNeeded()
+{
+   m_Parent.SendIfNeeded();
 }
 
 
@@ -227,6 +473,21 @@ Image::Image(COpenCL& CL, const SImage& Image, void * ImageData, cl_mem_flags fl
       throw cl::Error(CL_IMAGE_FORMAT_NOT_SUPPORTED, "Image can't be 3 channels - use ColorImage to handle 3 channel images");
 }
 
+Image::Image(COpenCL& CL, const SImage& Image, std::shared_ptr<PinnedMemory> Data, cl_mem_flags flags)
+:  IImage(CL, Image, flags, PinnedData(Data, Image)),
+   m_data(Data->Data()),
+   m_Pinned(Data)
+{
+   if (Image.Channels == 3)
+      throw cl::Error(CL_IMAGE_FORMAT_NOT_SUPPORTED, "Image can't be 3 channels - use ColorImage to handle 3 channel images");
+}
+
+Image::~Image()
+{
+   if (m_Pinned != nullptr)
+      WaitForEvents();
+}
+
 // Read the image from the device memory
 void Image::Read(bool blocking, std::vector<cl::Event> * events, cl::Event * event)
 {
@@ -238,36 +499,59 @@ void Image::Read(bool blocking, std::vector<cl::Event> * events, cl::Event * eve
    region[1] = Height();
    region[2] = 1;
 
-   if (!m_HostBuffer)
-      m_CL.GetQueue().enqueueReadImage(m_clImage, (cl_bool) blocking, origin, region, Step(), 0, m_data, events, event);
+   cl::CommandQueue& Queue = m_CL.GetTransferQueue();
+
+   // Wait for the given events and for the operations that write the image
+   std::vector<cl::Event> WaitList;
+   if (events != nullptr)
+      WaitList = *events;
+
+   AddReadDependencies(WaitList, Queue);
+   m_CL.WaitForKernels(WaitList);
+
+   cl::Event ReadEvent;
+
+   if (m_Transfer == CopyTransfer)
+      Queue.enqueueReadImage(m_clImage, (cl_bool) blocking, origin, region, Step(), 0, m_data, &WaitList, &ReadEvent);
    else
    {
-      if (m_CL.SupportsNoCopy())
+      if (m_Transfer == NoCopyTransfer)
       {
          // The device uses the same memory for the device and the host, no transfer is needed
+         // The marker gives an event that is signaled when the data is ready to be used by the host
+         EnqueueMarker(Queue, WaitList, ReadEvent);
+
          if (blocking)
-            m_CL.GetQueue().finish();
+            ReadEvent.wait();
+
+         SetReadEvent(ReadEvent, Queue);
+
+         if (event != nullptr)
+            *event = ReadEvent;
 
          return;
       }
 
-      cl::Event unmapEvent;
       std::vector<cl::Event> mapEvent(1, cl::Event());
       size_t row_pitch = 0;
-      m_CL.GetQueue().enqueueMapImage(m_clImage, (cl_bool) blocking, CL_MAP_READ, origin, region, &row_pitch, 0, events, &mapEvent[0]);
+      Queue.enqueueMapImage(m_clImage, (cl_bool) blocking, CL_MAP_READ, origin, region, &row_pitch, 0, &WaitList, &mapEvent[0]);
 
       if (row_pitch != Step())
          throw cl::Error(CL_MISALIGNED_SUB_BUFFER_OFFSET, "Row pitch does not match during image reading");
 
-      m_CL.GetQueue().enqueueUnmapMemObject(m_clImage, m_data, &mapEvent, &unmapEvent);
+      Queue.enqueueUnmapMemObject(m_clImage, m_data, &mapEvent, &ReadEvent);
 
       if (blocking)
-         unmapEvent.wait();
-
-      if (event != nullptr)
-         *event = unmapEvent;
+         ReadEvent.wait();
    }
 
+   SetReadEvent(ReadEvent, Queue);
+
+   if (m_CL.IsProfiling())
+      m_CL.AddProfilingRecord("Read", Width(), Height(), ReadEvent);
+
+   if (event != nullptr)
+      *event = ReadEvent;
 }
 
 // Send the image to the device memory
@@ -281,37 +565,62 @@ void Image::Send(bool blocking, std::vector<cl::Event> * events, cl::Event * eve
    region[1] = Height();
    region[2] = 1;
 
-   if (!m_HostBuffer)
-      m_CL.GetQueue().enqueueWriteImage(m_clImage, (cl_bool) blocking, origin, region, Step(), 0, m_data, events, event);
+   cl::CommandQueue& Queue = m_CL.GetTransferQueue();
+
+   // Wait for the given events and for the operations that use the image
+   std::vector<cl::Event> WaitList;
+   if (events != nullptr)
+      WaitList = *events;
+
+   AddWriteDependencies(WaitList, Queue);
+
+   cl::Event SendEvent;
+
+   if (m_Transfer == CopyTransfer)
+      Queue.enqueueWriteImage(m_clImage, (cl_bool) blocking, origin, region, Step(), 0, m_data, &WaitList, &SendEvent);
    else
    {
-      if (m_CL.SupportsNoCopy())
+      if (m_Transfer == NoCopyTransfer)
       {
          // The device uses the same memory for the device and the host, no transfer is needed
+         // The marker gives an event that later operations on the memory can be ordered against
+         EnqueueMarker(Queue, WaitList, SendEvent);
+
          if (blocking)
-            m_CL.GetQueue().finish();
+            SendEvent.wait();
+
+         SetWriteEvent(SendEvent, Queue);
+         m_CL.ComputeWaitsFor(SendEvent);
+
+         if (event != nullptr)
+            *event = SendEvent;
 
          m_isInDevice = true;
          return;
       }
 
-      cl::Event unmapEvent;
       std::vector<cl::Event> mapEvent(1, cl::Event());
       size_t row_pitch = 0;
-      m_CL.GetQueue().enqueueMapImage(m_clImage, (cl_bool) blocking, CL_MAP_WRITE, origin, region, &row_pitch, 0, events, &mapEvent[0]);
+      Queue.enqueueMapImage(m_clImage, (cl_bool) blocking, CL_MAP_WRITE, origin, region, &row_pitch, 0, &WaitList, &mapEvent[0]);
 
       if (row_pitch != Step())
          throw cl::Error(CL_MISALIGNED_SUB_BUFFER_OFFSET, "Row pitch does not match during image sending");
 
-      m_CL.GetQueue().enqueueUnmapMemObject(m_clImage, m_data, &mapEvent, &unmapEvent);
+      Queue.enqueueUnmapMemObject(m_clImage, m_data, &mapEvent, &SendEvent);
 
       if (blocking)
-         unmapEvent.wait();
-
-      if (event != nullptr)
-         *event = unmapEvent;
+         SendEvent.wait();
    }
 
+   SetWriteEvent(SendEvent, Queue);
+   m_CL.ComputeWaitsFor(SendEvent);
+
+   if (m_CL.IsProfiling())
+      m_CL.AddProfilingRecord("Send", Width(), Height(), SendEvent);
+
+   if (event != nullptr)
+      *event = SendEvent;
+
    m_isInDevice = true;
 }
 
@@ -335,18 +644,32 @@ ColorImage::ColorImage(COpenCL& CL, const SImage& Image, void * ImageData)
 // Read the image from the device memory
 void ColorImage::Read(bool blocking, std::vector<cl::Event> * events, cl::Event * event)
 {
-   // NOTE : Synchronisation is not good here because conversion will start without waiting on the events
+   // The conversion writes m_Buffer, so it waits for the given events
+   if (events != nullptr)
+      m_Buffer.AddPendingEvents(*events);
+
+   // The conversion kernel tracks its events so the read of m_Buffer waits for the conversion
    m_CL.GetColorConverter().Convert4CTo3C(*this, m_Buffer);
-   m_Buffer.Read(blocking, events, event);
+   m_Buffer.Read(blocking, nullptr, event);
 
    m_isInDevice = true;
 }
 
 // Send the image to the device memory
-void ColorImage::Send()
+void ColorImage::Send(bool blocking, std::vector<cl::Event> * events, cl::Event * event)
 {
-   m_Buffer.Send();
+   // The conversion kernel tracks its events so it waits for the send of m_Buffer
+   m_Buffer.Send(false, events);
    m_CL.GetColorConverter().Convert3CTo4C(m_Buffer, *this);
+
+   // The conversion is now the last operation that wrote this image
+   cl::Event ConvertEvent = m_LastWrite.Event;
+
+   if (blocking)
+      ConvertEvent.wait();
+
+   if (event != nullptr)
+      *event = ConvertEvent;
 }
 
 void ColorImage::SendIfNeeded()
@@ -366,6 +689,7 @@ uint DepthOfType(SImage::EDataType Type)
       return 8;
    case SImage::U16:
    case SImage::S16:
+   case SImage::F16:
       return 16;
    case SImage::U32:
    case SImage::S32:
@@ -383,22 +707,22 @@ SImage TempSImage(SSize Size, SImage::EDataType Type, uint NbChannels)
    return Image;
 }
 
-inline bool operator == (const cl::ImageFormat& left, const cl::ImageFormat& right)
+SImage RegionSImage(const SImage& Image, const SRect& Region)
 {
-   return (left.image_channel_data_type == right.image_channel_data_type &&
-      left.image_channel_order == right.image_channel_order);
+   SImage RegionImage = Image;
+   RegionImage.Width = Region.Width;
+   RegionImage.Height = Region.Height;
+   return RegionImage;
 }
 
-bool IsSupportedFormat(const cl::ImageFormat& inFormat, const cl::Context& context, cl_mem_flags flags)
+SImage BatchSImage(const SImage& Image, uint NbImages)
 {
-   std::vector<cl::ImageFormat> formats;
-   context.getSupportedImageFormats(flags, CL_MEM_OBJECT_IMAGE2D, &formats);
+   if (NbImages == 0 || Image.Height == 0)
+      throw cl::Error(CL_INVALID_VALUE, "a batch of images needs at least one image");
 
-   for (auto format : formats)
-      if (inFormat == format)
-         return true;
-
-   return false;
+   SImage Batch = Image;
+   Batch.Height = Image.Height * NbImages;
+   return Batch;
 }
 
 cl::ImageFormat FormatFromImage(const SImage& image)
@@ -428,6 +752,9 @@ cl::ImageFormat FormatFromImage(const SImage& image)
    case SImage::F32:
       format.image_channel_data_type = CL_FLOAT;
       break;
+   case SImage::F16:
+      format.image_channel_data_type = CL_HALF_FLOAT;
+      break;
    case SImage::NbDataTypes:
    default:
       throw cl::Error(CL_IMAGE_FORMAT_NOT_SUPPORTED, "FormatFromILImage - DataType");
@@ -462,4 +789,12 @@ uint align_step(uint step, uint alignement)
    return step + alignement - mod;
 }
 
+void * PinnedData(const std::shared_ptr<PinnedMemory>& Data, const SImage& Image)
+{
+   if (Data == nullptr || Data->Size() < size_t(Image.Height) * Image.Step)
+      throw cl::Error(CL_INVALID_HOST_PTR, "pinned memory is too small for the image");
+
+   return Data->Data();
+}
+
 }
@@ -0,0 +1,306 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: MemoryPool.cpp
+//! @date   : Oct 2026
+//!
+//! @brief  : Pool of device memory used by temporary images and buffers
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "MemoryPool.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+namespace OpenCLIPP
+{
+
+// Helpers
+static size_t BucketSize(size_t Size);                         // Rounds up the size of a buffer
+static size_t PixelSize(const cl::ImageFormat& Format);        // Size of a pixel in bytes
+static bool IsOutOfMemory(const cl::Error& Error);             // True if the error means the device ran out of memory
+
+
+MemoryPool::MemoryPool(const cl::Context& Context)
+:  m_Context(Context),
+   m_MaxCachedBytes(256 << 20)
+{
+   memset(&m_Stats, 0, sizeof(m_Stats));
+}
+
+cl::Buffer MemoryPool::CreateBuffer(size_t Size, cl_mem_flags Flags, vector<cl::Event>& PendingEvents)
+{
+   SBufferKey Key = {BucketSize(Size), Flags};
+
+   cl::Buffer Buffer;
+   if (TakeCached(m_Buffers, Key, Key.Size, Buffer, PendingEvents))
+      return Buffer;
+
+   try
+   {
+      Buffer = cl::Buffer(m_Context, Flags, Key.Size);
+   }
+   catch (const cl::Error& Error)
+   {
+      if (!IsOutOfMemory(Error))
+         throw;
+
+      // Free the memory kept by the pool and try again
+      Clear();
+      Buffer = cl::Buffer(m_Context, Flags, Key.Size);
+   }
+
+   AddCreated(Key.Size);
+
+   return Buffer;
+}
+
+void MemoryPool::ReleaseBuffer(const cl::Buffer& Buffer, size_t Size, cl_mem_flags Flags, const vector<cl::Event>& PendingEvents)
+{
+   SBufferKey Key = {BucketSize(Size), Flags};
+   Keep(m_Buffers, Key, Key.Size, Buffer, PendingEvents);
+}
+
+cl::Image2D MemoryPool::CreateImage(const cl::ImageFormat& Format, size_t Width, size_t Height, cl_mem_flags Flags,
+                                    vector<cl::Event>& PendingEvents)
+{
+   SImageKey Key = {Format.image_channel_order, Format.image_channel_data_type, Width, Height, Flags};
+   size_t NbBytes = Width * Height * PixelSize(Format);
+
+   cl::Image2D Image;
+   if (TakeCached(m_Images, Key, NbBytes, Image, PendingEvents))
+      return Image;
+
+   try
+   {
+      Image = cl::Image2D(m_Context, Flags, Format, Width, Height);
+   }
+   catch (const cl::Error& Error)
+   {
+      if (!IsOutOfMemory(Error))
+         throw;
+
+      // Free the memory kept by the pool and try again
+      Clear();
+      Image = cl::Image2D(m_Context, Flags, Format, Width, Height);
+   }
+
+   AddCreated(NbBytes);
+
+   return Image;
+}
+
+void MemoryPool::ReleaseImage(const cl::Image2D& Image, const cl::ImageFormat& Format, size_t Width, size_t Height,
+                              cl_mem_flags Flags, const vector<cl::Event>& PendingEvents)
+{
+   SImageKey Key = {Format.image_channel_order, Format.image_channel_data_type, Width, Height, Flags};
+   Keep(m_Images, Key, Width * Height * PixelSize(Format), Image, PendingEvents);
+}
+
+void MemoryPool::SetMaxCachedBytes(size_t MaxBytes)
+{
+   lock_guard<mutex> Lock(m_Mutex);
+   m_MaxCachedBytes = MaxBytes;
+}
+
+void MemoryPool::Clear()
+{
+   lock_guard<mutex> Lock(m_Mutex);
+
+   m_Buffers.clear();
+   m_Images.clear();
+
+   m_Stats.NbCached = 0;
+   m_Stats.CachedBytes = 0;
+}
+
+SMemoryPoolStats MemoryPool::GetStats() const
+{
+   lock_guard<mutex> Lock(m_Mutex);
+   return m_Stats;
+}
+
+void MemoryPool::Reserve(cl_mem Memory)
+{
+   lock_guard<mutex> Lock(m_Mutex);
+
+   m_Reserved[Memory]++;
+}
+
+void MemoryPool::Unreserve(cl_mem Memory)
+{
+   lock_guard<mutex> Lock(m_Mutex);
+
+   auto It = m_Reserved.find(Memory);
+   if (It == m_Reserved.end())
+      return;
+
+   if (--It->second == 0)
+      m_Reserved.erase(It);
+}
+
+template<class K, class T>
+bool MemoryPool::TakeCached(map<K, vector<SEntry<T>>>& Map, const K& Key, size_t NbBytes,
+                            T& Memory, vector<cl::Event>& PendingEvents)
+{
+   lock_guard<mutex> Lock(m_Mutex);
+
+   m_Stats.NbRequests++;
+
+   auto It = Map.find(Key);
+   if (It == Map.end() || It->second.empty())
+      return false;
+
+   Memory = It->second.back().Memory;
+   PendingEvents = It->second.back().PendingEvents;
+   It->second.pop_back();
+
+   m_Stats.NbReused++;
+   m_Stats.NbCached--;
+   m_Stats.CachedBytes -= NbBytes;
+   m_Stats.InUseBytes += NbBytes;
+
+   return true;
+}
+
+template<class K, class T>
+void MemoryPool::Keep(map<K, vector<SEntry<T>>>& Map, const K& Key, size_t NbBytes,
+                      const T& Memory, const vector<cl::Event>& PendingEvents)
+{
+   lock_guard<mutex> Lock(m_Mutex);
+
+   m_Stats.InUseBytes -= NbBytes;
+
+   if (m_Reserved.count(Memory()) > 0)
+      return;  // Still used elsewhere, the memory is freed when its last user releases it
+
+   if (m_Stats.CachedBytes + NbBytes > m_MaxCachedBytes)
+      return;  // The pool is full, the memory will be freed
+
+   SEntry<T> Entry = {Memory, PendingEvents};
+   Map[Key].push_back(Entry);
+
+   m_Stats.NbCached++;
+   m_Stats.CachedBytes += NbBytes;
+}
+
+void MemoryPool::AddCreated(size_t NbBytes)
+{
+   lock_guard<mutex> Lock(m_Mutex);
+
+   m_Stats.NbCreated++;
+   m_Stats.InUseBytes += NbBytes;
+   m_Stats.PeakBytes = max(m_Stats.PeakBytes, m_Stats.InUseBytes + m_Stats.CachedBytes);
+}
+
+bool MemoryPool::SBufferKey::operator < (const SBufferKey& Other) const
+{
+   if (Size != Other.Size)
+      return Size < Other.Size;
+
+   return Flags < Other.Flags;
+}
+
+bool MemoryPool::SImageKey::operator < (const SImageKey& Other) const
+{
+   if (Width != Other.Width)
+      return Width < Other.Width;
+
+   if (Height != Other.Height)
+      return Height < Other.Height;
+
+   if (Order != Other.Order)
+      return Order < Other.Order;
+
+   if (Type != Other.Type)
+      return Type < Other.Type;
+
+   return Flags < Other.Flags;
+}
+
+
+// Helpers
+size_t BucketSize(size_t Size)
+{
+   const static size_t Granularity = 4096;
+
+   // Small buffers are rounded to the next power of 2, larger ones to a multiple of the granularity
+   if (Size >= Granularity)
+      return (Size + Granularity - 1) / Granularity * Granularity;
+
+   size_t Bucket = 64;
+   while (Bucket < Size)
+      Bucket *= 2;
+
+   return Bucket;
+}
+
+size_t PixelSize(const cl::ImageFormat& Format)
+{
+   size_t NbChannels = 4;
+   switch (Format.image_channel_order)
+   {
+   case CL_R:
+   case CL_A:
+   case CL_INTENSITY:
+   case CL_LUMINANCE:
+      NbChannels = 1;
+      break;
+   case CL_RG:
+   case CL_RA:
+      NbChannels = 2;
+      break;
+   case CL_RGB:
+      NbChannels = 3;
+      break;
+   default:
+      break;
+   }
+
+   size_t ChannelSize = 4;
+   switch (Format.image_channel_data_type)
+   {
+   case CL_SNORM_INT8:
+   case CL_UNORM_INT8:
+   case CL_SIGNED_INT8:
+   case CL_UNSIGNED_INT8:
+      ChannelSize = 1;
+      break;
+   case CL_SNORM_INT16:
+   case CL_UNORM_INT16:
+   case CL_SIGNED_INT16:
+   case CL_UNSIGNED_INT16:
+   case CL_HALF_FLOAT:
+      ChannelSize = 2;
+      break;
+   default:
+      break;
+   }
+
+   return NbChannels * ChannelSize;
+}
+
+bool IsOutOfMemory(const cl::Error& Error)
+{
+   return Error.err() == CL_MEM_OBJECT_ALLOCATION_FAILURE || Error.err() == CL_OUT_OF_RESOURCES;
+}
+
+}
@@ -24,8 +24,15 @@
 
 #include "OpenCL.h"
 #include "Programs/Color.h"
+#include "ThreadPool.h"
+#include "PinnedMemory.h"
+#include "WorkGroupTuner.h"
+#include "OperationGraph.h"
+#include "Programs/BufferExpression.h"
 
 #include <string>
+#include <cstring>
+#include <algorithm>
 
 
 using namespace std;
@@ -37,14 +44,19 @@ namespace OpenCLIPP
 
 // Static variables
 string COpenCL::m_ClFilesPath;
+bool COpenCL::m_UseClFiles = false;
+string COpenCL::m_BinaryCachePath;
 
 
 // Helper functions
 string LoadClFile(const string& Path);
 cl::Program LoadClProgram(const cl::Context& context,  const string& Path, bool build);
 cl::Platform findPlatform(const char * inPreferred);
+SDeviceInfo QueryDeviceInfo(const cl::Platform& Platform, const cl::Device& Device, const cl::Context& Context);
 
 COpenCL::COpenCL(const char * PreferredPlatform, cl_device_type deviceType)
+:  m_QueueProperties(0),
+   m_Profiling(false)
 {
    if (PreferredPlatform == nullptr || string(PreferredPlatform) == "")
       m_Platform = cl::Platform::getDefault();
@@ -64,6 +76,10 @@ COpenCL::COpenCL(const char * PreferredPlatform, cl_device_type deviceType)
 
    m_Queue = cl::CommandQueue(m_Context, devices[0]);
 
+   m_DeviceInfo = QueryDeviceInfo(m_Platform, m_Device, m_Context);
+
+   m_MemoryPool = make_shared<MemoryPool>(m_Context);
+
    m_ColorConverter = std::make_shared<Color>(*this);
 }
 
@@ -78,16 +94,262 @@ const string& COpenCL::GetClFilePath()
    return m_ClFilesPath;
 }
 
+void COpenCL::SetUseClFiles(bool Use)
+{
+   m_UseClFiles = Use;
+}
+
+bool COpenCL::GetUseClFiles()
+{
+   return m_UseClFiles;
+}
+
+void COpenCL::SetBinaryCachePath(const char * Path)
+{
+   m_BinaryCachePath = Path;
+
+   // Make sure the path ends with a separator
+   if (m_BinaryCachePath != "" && m_BinaryCachePath.back() != '/' && m_BinaryCachePath.back() != '\\')
+      m_BinaryCachePath += '/';
+}
+
+const string& COpenCL::GetBinaryCachePath()
+{
+   return m_BinaryCachePath;
+}
+
 cl::CommandQueue& COpenCL::GetQueue()
 {
    return m_Queue;
 }
 
+void COpenCL::UseTransferQueue(bool Use)
+{
+   if (Use == HasTransferQueue())
+      return;
+
+   if (Use)
+   {
+      m_TransferQueue = cl::CommandQueue(m_Context, m_Device, m_QueueProperties);
+      return;
+   }
+
+   // Make sure pending transfers are done before going back to a single queue
+   m_TransferQueue.finish();
+   m_TransferQueue = cl::CommandQueue();
+}
+
+cl::CommandQueue& COpenCL::GetTransferQueue()
+{
+   if (HasTransferQueue())
+      return m_TransferQueue;
+
+   return m_Queue;
+}
+
+bool COpenCL::HasTransferQueue() const
+{
+   return m_TransferQueue() != nullptr;
+}
+
+void COpenCL::ComputeWaitsFor(const cl::Event& Event)
+{
+   if (!HasTransferQueue())
+      return;
+
+   // The transfer must be submitted to the device before the kernel queue can wait for it
+   m_TransferQueue.flush();
+
+   // The commands enqueued after this wait for the event
+   vector<cl::Event> Events(1, Event);
+   m_Queue.enqueueWaitForEvents(Events);
+}
+
+void COpenCL::WaitForKernels(vector<cl::Event>& WaitList)
+{
+   if (!HasTransferQueue())
+      return;
+
+   // The marker event is signaled when the commands enqueued before it are done
+   cl::Event KernelsDone;
+   m_Queue.enqueueMarker(&KernelsDone);
+   WaitList.push_back(KernelsDone);
+
+   // Submit the kernels, the transfer queue would otherwise wait for commands that may never be sent to the device
+   m_Queue.flush();
+}
+
+void COpenCL::Finish()
+{
+   if (HasTransferQueue())
+      m_TransferQueue.finish();
+
+   m_Queue.finish();
+}
+
+void COpenCL::EnableProfiling(bool Enable)
+{
+   if (Enable == IsProfiling())
+      return;
+
+   m_Profiling = Enable;
+   m_ProfiledOperations.clear();
+
+   UpdateQueueProperties();
+}
+
+bool COpenCL::IsProfiling() const
+{
+   return m_Profiling;
+}
+
+void COpenCL::EnableWorkGroupTuning(bool Enable)
+{
+   if (Enable == IsTuningWorkGroups())
+      return;
+
+   if (Enable)
+      m_WorkGroupTuner = make_shared<WorkGroupTuner>(*this);
+   else
+      m_WorkGroupTuner.reset();
+
+   UpdateQueueProperties();
+}
+
+bool COpenCL::IsTuningWorkGroups() const
+{
+   return m_WorkGroupTuner != nullptr;
+}
+
+WorkGroupTuner& COpenCL::GetWorkGroupTuner()
+{
+   return *m_WorkGroupTuner;
+}
+
+void COpenCL::BeginRecording()
+{
+   if (IsRecording())
+      throw cl::Error(CL_INVALID_OPERATION, "already recording");
+
+   m_RecordingGraph = make_shared<OperationGraph>(*this);
+}
+
+shared_ptr<OperationGraph> COpenCL::EndRecording()
+{
+   if (!IsRecording())
+      throw cl::Error(CL_INVALID_OPERATION, "EndRecording() called without BeginRecording()");
+
+   shared_ptr<OperationGraph> Graph = m_RecordingGraph;
+   m_RecordingGraph.reset();
+
+   return Graph;
+}
+
+bool COpenCL::IsRecording() const
+{
+   return m_RecordingGraph != nullptr;
+}
+
+OperationGraph& COpenCL::GetRecordingGraph()
+{
+   return *m_RecordingGraph;
+}
+
+void COpenCL::UpdateQueueProperties()
+{
+   // Work-group tuning times kernels using profiling information
+   cl_command_queue_properties Properties = 0;
+   if (IsProfiling() || IsTuningWorkGroups())
+      Properties = CL_QUEUE_PROFILING_ENABLE;
+
+   if (Properties == m_QueueProperties)
+      return;
+
+   Finish();
+
+   m_QueueProperties = Properties;
+
+   // Profiling can only be enabled when creating a queue
+   m_Queue = cl::CommandQueue(m_Context, m_Device, m_QueueProperties);
+
+   if (HasTransferQueue())
+      m_TransferQueue = cl::CommandQueue(m_Context, m_Device, m_QueueProperties);
+}
+
+void COpenCL::AddProfilingRecord(const string& Name, uint Width, uint Height, const cl::Event& Event)
+{
+   if (!IsProfiling())
+      return;
+
+   SProfiledOperation Operation = {Name, Width, Height, Event};
+   m_ProfiledOperations.push_back(Operation);
+}
+
+size_t COpenCL::GetNbProfilingRecords() const
+{
+   return m_ProfiledOperations.size();
+}
+
+vector<SProfilingRecord> COpenCL::GetProfilingRecords(size_t MaxRecords)
+{
+   size_t NbRecords = min(MaxRecords, m_ProfiledOperations.size());
+
+   vector<SProfilingRecord> Records(NbRecords);
+
+   for (size_t i = 0; i < NbRecords; i++)
+   {
+      SProfiledOperation& Operation = m_ProfiledOperations[i];
+      SProfilingRecord& Record = Records[i];
+
+      // Timings are only available once the operation is done
+      Operation.Event.wait();
+
+      memset(Record.Name, 0, sizeof(Record.Name));
+      Operation.Name.copy(Record.Name, sizeof(Record.Name) - 1);
+      Record.Width = Operation.Width;
+      Record.Height = Operation.Height;
+      Record.Queued = Operation.Event.getProfilingInfo<CL_PROFILING_COMMAND_QUEUED>();
+      Record.Submit = Operation.Event.getProfilingInfo<CL_PROFILING_COMMAND_SUBMIT>();
+      Record.Start = Operation.Event.getProfilingInfo<CL_PROFILING_COMMAND_START>();
+      Record.End = Operation.Event.getProfilingInfo<CL_PROFILING_COMMAND_END>();
+   }
+
+   m_ProfiledOperations.erase(m_ProfiledOperations.begin(), m_ProfiledOperations.begin() + NbRecords);
+
+   return Records;
+}
+
 Color& COpenCL::GetColorConverter()
 {
    return *m_ColorConverter;
 }
 
+ExpressionEvaluator& COpenCL::GetExpressionEvaluator()
+{
+   if (m_ExpressionEvaluator == nullptr)
+      m_ExpressionEvaluator = make_shared<ExpressionEvaluator>(*this);
+
+   return *m_ExpressionEvaluator;
+}
+
+ThreadPool& COpenCL::GetBuildThreads()
+{
+   if (m_BuildThreads == nullptr)
+      m_BuildThreads = make_shared<ThreadPool>();
+
+   return *m_BuildThreads;
+}
+
+const std::shared_ptr<MemoryPool>& COpenCL::GetMemoryPool() const
+{
+   return m_MemoryPool;
+}
+
+shared_ptr<PinnedMemory> COpenCL::AllocHost(size_t Size)
+{
+   return make_shared<PinnedMemory>(*this, Size);
+}
+
 COpenCL::operator cl::Context& ()
 {
    return m_Context;
@@ -120,24 +382,65 @@ COpenCL::operator cl_device_id ()
 
 bool COpenCL::IsOnIntelCPU() const
 {
-   string name = m_Platform.getInfo<CL_PLATFORM_NAME>();
-   if (name.find("Intel") == string::npos)
-      return false;
-
-   return (m_Device.getInfo<CL_DEVICE_TYPE>() == CL_DEVICE_TYPE_CPU);
+   return m_DeviceInfo.IsOnIntelCPU;
 }
 
 bool COpenCL::SupportsNoCopy() const
 {
-   // TODO : Test all common devices to see if they support using the same
-   // memory region for the host and the device.
-   // Main candidates are : Intel GPU, AMD CPU, AMD Integrated GPU
+   // Only the Intel CPU runtime is known to use the host memory without needing map / unmap.
+   // Other devices that share their memory with the host use MapTransfer, see GetTransferStrategy()
    return IsOnIntelCPU();
 }
 
+ETransferStrategy COpenCL::GetTransferStrategy(const void * HostPtr, cl_mem_flags flags, size_t RowPitch) const
+{
+   if (HostPtr == nullptr)
+      return CopyTransfer;
+
+   size_t Alignment = max<size_t>(m_DeviceInfo.MemBaseAddrAlign / 8, 1);
+   bool Aligned = (size_t(HostPtr) % Alignment == 0 && RowPitch % Alignment == 0);
+
+   if (flags & CL_MEM_USE_HOST_PTR)
+      return (Aligned && SupportsNoCopy() ? NoCopyTransfer : MapTransfer);   // Asked for by the caller
+
+   if (!Aligned)
+      return CopyTransfer; // The driver would make its own copy of misaligned memory
+
+   if (SupportsNoCopy())
+      return NoCopyTransfer;
+
+   if (m_DeviceInfo.HostUnifiedMemory)
+      return MapTransfer;
+
+   return CopyTransfer;
+}
+
 std::string COpenCL::GetDeviceName() const
 {
-   return m_Device.getInfo<CL_DEVICE_NAME>();
+   return m_DeviceInfo.DeviceName;
+}
+
+const SDeviceInfo& COpenCL::GetDeviceInfo() const
+{
+   return m_DeviceInfo;
+}
+
+bool COpenCL::IsSupportedFormat(const cl::ImageFormat& Format, cl_mem_flags flags) const
+{
+   const vector<cl::ImageFormat> * Formats = &m_DeviceInfo.ReadWriteFormats;
+   if (flags & CL_MEM_READ_ONLY)
+      Formats = &m_DeviceInfo.ReadOnlyFormats;
+   else if (flags & CL_MEM_WRITE_ONLY)
+      Formats = &m_DeviceInfo.WriteOnlyFormats;
+
+   for (auto& Supported : *Formats)
+      if (Supported.image_channel_order == Format.image_channel_order &&
+          Supported.image_channel_data_type == Format.image_channel_data_type)
+      {
+         return true;
+      }
+
+   return false;
 }
 
 const char * COpenCL::ErrorName(cl_int status)
@@ -272,4 +575,39 @@ cl::Platform findPlatform(const char * inPreferred)
    return cl::Platform::getDefault();
 }
 
+SDeviceInfo QueryDeviceInfo(const cl::Platform& Platform, const cl::Device& Device, const cl::Context& Context)
+{
+   SDeviceInfo Info;
+
+   Info.PlatformName = Platform.getInfo<CL_PLATFORM_NAME>();
+   Info.DeviceName = Device.getInfo<CL_DEVICE_NAME>();
+   Info.DeviceVersion = Device.getInfo<CL_DEVICE_VERSION>();
+   Info.DriverVersion = Device.getInfo<CL_DRIVER_VERSION>();
+   Info.Type = Device.getInfo<CL_DEVICE_TYPE>();
+   Info.IsOnIntelCPU = (Info.PlatformName.find("Intel") != string::npos && Info.Type == CL_DEVICE_TYPE_CPU);
+   Info.HostUnifiedMemory = (Device.getInfo<CL_DEVICE_HOST_UNIFIED_MEMORY>() != CL_FALSE);
+   Info.MemBaseAddrAlign = Device.getInfo<CL_DEVICE_MEM_BASE_ADDR_ALIGN>();
+   Info.ComputeUnits = Device.getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>();
+   Info.MaxWorkGroupSize = Device.getInfo<CL_DEVICE_MAX_WORK_GROUP_SIZE>();
+   Info.LocalMemSize = Device.getInfo<CL_DEVICE_LOCAL_MEM_SIZE>();
+   Info.GlobalMemSize = Device.getInfo<CL_DEVICE_GLOBAL_MEM_SIZE>();
+   Info.MaxMemAllocSize = Device.getInfo<CL_DEVICE_MAX_MEM_ALLOC_SIZE>();
+   Info.ImageSupport = (Device.getInfo<CL_DEVICE_IMAGE_SUPPORT>() != CL_FALSE);
+   Info.Image2DMaxWidth = Device.getInfo<CL_DEVICE_IMAGE2D_MAX_WIDTH>();
+   Info.Image2DMaxHeight = Device.getInfo<CL_DEVICE_IMAGE2D_MAX_HEIGHT>();
+   Info.PreferredVectorWidthChar = Device.getInfo<CL_DEVICE_PREFERRED_VECTOR_WIDTH_CHAR>();
+   Info.PreferredVectorWidthShort = Device.getInfo<CL_DEVICE_PREFERRED_VECTOR_WIDTH_SHORT>();
+   Info.PreferredVectorWidthInt = Device.getInfo<CL_DEVICE_PREFERRED_VECTOR_WIDTH_INT>();
+   Info.PreferredVectorWidthFloat = Device.getInfo<CL_DEVICE_PREFERRED_VECTOR_WIDTH_FLOAT>();
+
+   if (Info.ImageSupport)
+   {
+      Context.getSupportedImageFormats(CL_MEM_READ_WRITE, CL_MEM_OBJECT_IMAGE2D, &Info.ReadWriteFormats);
+      Context.getSupportedImageFormats(CL_MEM_READ_ONLY, CL_MEM_OBJECT_IMAGE2D, &Info.ReadOnlyFormats);
+      Context.getSupportedImageFormats(CL_MEM_WRITE_ONLY, CL_MEM_OBJECT_IMAGE2D, &Info.WriteOnlyFormats);
+   }
+
+   return Info;
+}
+
 }
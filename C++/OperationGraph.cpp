@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: OperationGraph.cpp
+//! @date   : Oct 2026
+//!
+//! @brief  : Recording and replay of sequences of kernel launches
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "OperationGraph.h"
+#include "Programs/Program.h"
+
+using namespace std;
+
+namespace OpenCLIPP
+{
+
+OperationGraph::OperationGraph(COpenCL& CL)
+:  m_CL(&CL),
+   m_Pool(CL.GetMemoryPool())
+{ }
+
+OperationGraph::~OperationGraph()
+{
+   for (auto& Step : m_Steps)
+      for (auto& Arg : Step.MemoryArgs)
+         m_Pool->Unreserve(Arg.Handle());
+}
+
+void OperationGraph::Launch()
+{
+   cl::CommandQueue& Queue = m_CL->GetQueue();
+
+   for (auto& Step : m_Steps)
+   {
+      // Images that no longer exist were temporaries of the primitives, they are only used by the graph
+      // and the kernels of the graph execute in order, so only the other images need to be tracked
+      vector<cl::Event> WaitList;
+      for (auto& Arg : Step.MemoryArgs)
+      {
+         if (Arg.Role == Value || Arg.Lifetime.expired())
+            continue;
+
+         if (Arg.Role == Input)
+         {
+            Arg.Object->SendIfNeeded();
+            Arg.Object->AddReadDependencies(WaitList, Queue);
+         }
+         else
+            Arg.Object->AddWriteDependencies(WaitList, Queue);
+      }
+
+      cl::Event Event;
+      Queue.enqueueNDRangeKernel(Step.Kernel, Step.Offset, Step.Global, Step.Local,
+         WaitList.empty() ? nullptr : &WaitList, &Event);
+
+      for (auto& Arg : Step.MemoryArgs)
+      {
+         if (Arg.Role == Value || Arg.Lifetime.expired())
+            continue;
+
+         if (Arg.Role == Input)
+            Arg.Object->SetReadEvent(Event, Queue);
+         else
+         {
+            Arg.Object->SetInDevice();
+            Arg.Object->SetWriteEvent(Event, Queue);
+         }
+
+      }
+
+      if (m_CL->IsProfiling())
+         m_CL->AddProfilingRecord(Step.Name, Step.Width, Step.Height, Event);
+   }
+
+}
+
+void OperationGraph::Replace(IImage& Recorded, IImage& Replacement)
+{
+   CheckSimilarity(Recorded, Replacement);
+
+   // The origin of views is part of the recorded launches
+   if (Recorded.Origin().X != Replacement.Origin().X || Recorded.Origin().Y != Replacement.Origin().Y)
+      throw cl::Error(CL_INVALID_VALUE, "the replacement image must have the same origin as the recorded image");
+
+   cl::Image2D& Handle = Replacement;
+   ReplaceHandle(Recorded, Replacement, Handle);
+}
+
+void OperationGraph::Replace(ImageBuffer& Recorded, ImageBuffer& Replacement)
+{
+   CheckSimilarity(Recorded, Replacement);
+
+   cl::Buffer& Handle = Replacement;
+   ReplaceHandle(Recorded, Replacement, Handle);
+}
+
+void OperationGraph::Replace(IBuffer& Recorded, IBuffer& Replacement)
+{
+   if (Recorded.Size() != Replacement.Size())
+      throw cl::Error(CL_INVALID_BUFFER_SIZE, "the replacement buffer must have the same size as the recorded buffer");
+
+   cl::Buffer& Handle = Replacement;
+   ReplaceHandle(Recorded, Replacement, Handle);
+}
+
+size_t OperationGraph::GetNbSteps() const
+{
+   return m_Steps.size();
+}
+
+void OperationGraph::AddStep(const cl::Program& Program, const string& Name, const cl::EnqueueArgs& Args, uint Width, uint Height)
+{
+   // Each step has its own kernel object so that its arguments stay set
+   SStep Step;
+   Step.Kernel = cl::Kernel(Program, Name.c_str());
+   Step.Offset = Args.offset_;
+   Step.Global = Args.global_;
+   Step.Local = Args.local_;
+   Step.Name = Name;
+   Step.Width = Width;
+   Step.Height = Height;
+   Step.NbArgs = 0;
+
+   m_Steps.push_back(Step);
+}
+
+void OperationGraph::KeepHandle(SMemoryArg& Arg, const cl::Memory * Handle)
+{
+   // The memory of temporary images must not be given to other images when the temporary is destroyed
+   Arg.Handle = *Handle;
+   m_Pool->Reserve(Arg.Handle());
+}
+
+void OperationGraph::ReplaceHandle(Memory& Recorded, Memory& Replacement, const cl::Memory& Handle)
+{
+   bool Found = false;
+
+   for (auto& Step : m_Steps)
+      for (auto& Arg : Step.MemoryArgs)
+      {
+         if (Arg.Object != &Recorded || Arg.Lifetime.expired())
+            continue;
+
+         Step.Kernel.setArg(Arg.Index, Handle);
+
+         m_Pool->Unreserve(Arg.Handle());
+         m_Pool->Reserve(Handle());
+
+         Arg.Object = &Replacement;
+         Arg.Lifetime = Replacement.GetLifetime();
+         Arg.Handle = Handle;
+         Found = true;
+      }
+
+   if (!Found)
+      throw cl::Error(CL_INVALID_MEM_OBJECT, "the image to replace is not used by the graph");
+}
+
+}
@@ -0,0 +1,50 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: PinnedMemory.cpp
+//! @date   : Oct 2026
+//!
+//! @brief  : Page-locked host memory for fast transfers
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "PinnedMemory.h"
+
+namespace OpenCLIPP
+{
+
+PinnedMemory::PinnedMemory(COpenCL& CL, size_t Size)
+:  m_Queue(CL.GetQueue()),
+   m_Buffer(CL, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, Size),
+   m_Data(nullptr),
+   m_Size(Size)
+{
+   m_Data = m_Queue.enqueueMapBuffer(m_Buffer, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0, Size);
+}
+
+PinnedMemory::~PinnedMemory()
+{
+   try
+   {
+      m_Queue.enqueueUnmapMemObject(m_Buffer, m_Data);
+   }
+   catch (...)
+   { }   // Destructors must not throw
+}
+
+}
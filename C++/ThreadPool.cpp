@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: ThreadPool.cpp
+//! @date   : Oct 2026
+//!
+//! @brief  : Thread pool used to build programs in the background
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "ThreadPool.h"
+
+using namespace std;
+
+namespace OpenCLIPP
+{
+
+ThreadPool::ThreadPool(uint NbThreads)
+:  m_Stop(false)
+{
+   if (NbThreads == 0)
+      NbThreads = thread::hardware_concurrency();
+
+   if (NbThreads == 0)
+      NbThreads = 1;
+
+   for (uint i = 0; i < NbThreads; i++)
+      m_Threads.push_back(thread(&ThreadPool::WorkerLoop, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+   {
+      lock_guard<mutex> Lock(m_Mutex);
+      m_Stop = true;
+      m_Tasks.clear();  // Tasks not yet started are abandoned
+   }
+
+   m_Condition.notify_all();
+
+   for (auto& Thread : m_Threads)
+      Thread.join();
+}
+
+shared_future<void> ThreadPool::Run(function<void()> Task)
+{
+   TaskPtr NewTask = make_shared<packaged_task<void()>>(Task);
+   shared_future<void> Future = NewTask->get_future().share();
+
+   {
+      lock_guard<mutex> Lock(m_Mutex);
+      m_Tasks.push_back(NewTask);
+   }
+
+   m_Condition.notify_one();
+
+   return Future;
+}
+
+void ThreadPool::WorkerLoop()
+{
+   for (;;)
+   {
+      TaskPtr Task;
+
+      {
+         unique_lock<mutex> Lock(m_Mutex);
+         while (!m_Stop && m_Tasks.empty())
+            m_Condition.wait(Lock);
+
+         if (m_Stop)
+            return;
+
+         Task = m_Tasks.front();
+         m_Tasks.pop_front();
+      }
+
+      (*Task)();  // Exceptions are stored in the future
+   }
+}
+
+}
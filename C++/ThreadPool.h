@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: ThreadPool.h
+//! @date   : Oct 2026
+//!
+//! @brief  : Thread pool used to build programs in the background
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include "Basic.h"
+
+#include <functional>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <vector>
+#include <memory>
+
+namespace OpenCLIPP
+{
+
+/// A simple pool of worker threads (for internal use).
+/// Tasks are run in the order they are given.
+class ThreadPool
+{
+public:
+   /// Constructor - starts the worker threads.
+   /// \param NbThreads : Number of worker threads, 0 to use the number of hardware threads
+   ThreadPool(uint NbThreads = 0);
+
+   /// Destructor - waits for running tasks to finish.
+   /// Tasks that have not been started are discarded, their future will throw std::future_error.
+   ~ThreadPool();
+
+   /// Queues a task to be run by one of the worker threads.
+   /// \param Task : Function to run
+   /// \return a future that becomes ready when the task has been run.
+   ///   If the task throws an exception, it is rethrown by the get() method of the future.
+   std::shared_future<void> Run(std::function<void()> Task);
+
+private:
+   ThreadPool(const ThreadPool&);              // Not copyable
+   ThreadPool& operator = (const ThreadPool&);
+
+   void WorkerLoop();
+
+   typedef std::shared_ptr<std::packaged_task<void()>> TaskPtr;
+
+   std::vector<std::thread> m_Threads;
+   std::deque<TaskPtr> m_Tasks;
+   std::mutex m_Mutex;
+   std::condition_variable m_Condition;
+   bool m_Stop;
+};
+
+}
@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: TileExecutor.cpp
+//! @date   : Oct 2026
+//!
+//! @brief  : Processing of images larger than the device limits, in tiles
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "TileExecutor.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace OpenCLIPP
+{
+
+uint DepthOfType(SImage::EDataType Type);    // Gets the number of bits of the given type - from Image.cpp
+uint PixelBytes(const SImage& Image);        // Number of bytes of each pixel
+SImage TileSImage(const SImage& Image, const SRect& Region);      // SImage of a region of a host image - same step
+void * TileData(const SImage& Image, void * Data, const SRect& Region);   // Address of the first pixel of the region
+
+
+TileExecutor::TileExecutor(COpenCL& CL)
+:  m_CL(CL)
+{
+   m_MaxTileSize.Width = DefaultTileSize;
+   m_MaxTileSize.Height = DefaultTileSize;
+}
+
+void TileExecutor::SetMaxTileSize(SSize Size)
+{
+   if (Size.Width == 0 || Size.Height == 0)
+      throw cl::Error(CL_INVALID_VALUE, "the maximum tile size must not be 0");
+
+   m_MaxTileSize = Size;
+}
+
+SSize TileExecutor::GetTileSize(const SImage& Image, uint Halo) const
+{
+   const SDeviceInfo& Info = m_CL.GetDeviceInfo();
+
+   SSize Size = m_MaxTileSize;
+   Size.Width = (uint) min<size_t>(min(Size.Width, Image.Width), Info.Image2DMaxWidth);
+   Size.Height = (uint) min<size_t>(min(Size.Height, Image.Height), Info.Image2DMaxHeight);
+
+   // Each tile must fit in a single allocation
+   cl_ulong RowBytes = cl_ulong(Size.Width) * PixelBytes(Image);
+   if (RowBytes * Size.Height > Info.MaxMemAllocSize)
+      Size.Height = uint(Info.MaxMemAllocSize / RowBytes);
+
+   // Tiles smaller than the image need room for a core between their halos
+   if ((Size.Width < Image.Width && Size.Width <= 2 * Halo) || (Size.Height < Image.Height && Size.Height <= 2 * Halo))
+      throw cl::Error(CL_INVALID_VALUE, "the halo is too large for the tiles that fit in the device");
+
+   return Size;
+}
+
+void TileExecutor::Run(const SImage& Source, void * SourceData, const SImage& Dest, void * DestData,
+                       uint Halo, const Operation& Function)
+{
+   if (Source.Width != Dest.Width || Source.Height != Dest.Height)
+      throw cl::Error(CL_INVALID_VALUE, "the source and destination of a tiled operation must have the same size");
+
+   if (Source.Channels == 3 || Dest.Channels == 3)
+      throw cl::Error(CL_IMAGE_FORMAT_NOT_SUPPORTED, "3 channel images can't be processed in tiles");
+
+   // The tiles are sized for the image that has the largest pixels
+   vector<STile> Tiles = MakeTiles(PixelBytes(Dest) > PixelBytes(Source) ? Dest : Source, Halo);
+
+   SSlot Slots[2];
+
+   SendTile(Slots[0], Tiles[0], Source, SourceData);
+
+   for (size_t i = 0; i < Tiles.size(); i++)
+   {
+      ProcessTile(Slots[i % 2], Tiles[i], Dest, DestData, Function);
+
+      if (i + 1 < Tiles.size())
+      {
+         // The next tile re-uses the slot of the previous tile, the device works on the current tile meanwhile
+         SSlot& Next = Slots[(i + 1) % 2];
+         WaitForSlot(Next);
+         SendTile(Next, Tiles[i + 1], Source, SourceData);
+      }
+
+   }
+
+   WaitForSlot(Slots[0]);
+   WaitForSlot(Slots[1]);
+}
+
+vector<TileExecutor::STile> TileExecutor::MakeTiles(const SImage& Image, uint Halo) const
+{
+   SSize Size = GetTileSize(Image, Halo);
+
+   // A tile that covers the whole width or height of the image needs no halo in that direction
+   uint CoreWidth = (Size.Width < Image.Width ? Size.Width - 2 * Halo : Image.Width);
+   uint CoreHeight = (Size.Height < Image.Height ? Size.Height - 2 * Halo : Image.Height);
+
+   vector<STile> Tiles;
+
+   for (uint Y = 0; Y < Image.Height; Y += CoreHeight)
+      for (uint X = 0; X < Image.Width; X += CoreWidth)
+      {
+         STile Tile;
+         Tile.Core.X = X;
+         Tile.Core.Y = Y;
+         Tile.Core.Width = min(CoreWidth, Image.Width - X);
+         Tile.Core.Height = min(CoreHeight, Image.Height - Y);
+
+         // The halo stops at the edges of the image, where the primitives handle borders as usual
+         Tile.Region.X = X - min(X, Halo);
+         Tile.Region.Y = Y - min(Y, Halo);
+         Tile.Region.Width = min(Image.Width, X + Tile.Core.Width + Halo) - Tile.Region.X;
+         Tile.Region.Height = min(Image.Height, Y + Tile.Core.Height + Halo) - Tile.Region.Y;
+
+         Tiles.push_back(Tile);
+      }
+
+   return Tiles;
+}
+
+void TileExecutor::SendTile(SSlot& Slot, const STile& Tile, const SImage& Source, void * SourceData)
+{
+   Slot.Source.reset(new Image(m_CL, TileSImage(Source, Tile.Region), TileData(Source, SourceData, Tile.Region)));
+   Slot.Source->Send();
+}
+
+void TileExecutor::ProcessTile(SSlot& Slot, const STile& Tile, const SImage& Dest, void * DestData, const Operation& Function)
+{
+   Slot.Dest.reset(new TempImage(m_CL, Slot.Source->Size(), Dest.Type, Dest.Channels));
+
+   Function(*Slot.Source, *Slot.Dest);
+
+   // Copy the core of the tile to an image that uses the destination data
+   Slot.Result.reset(new Image(m_CL, TileSImage(Dest, Tile.Core), TileData(Dest, DestData, Tile.Core)));
+
+   TempImage& TileDest = *Slot.Dest;
+   Image& Result = *Slot.Result;
+
+   cl::CommandQueue& Queue = m_CL.GetQueue();
+
+   vector<cl::Event> WaitList;
+   TileDest.AddReadDependencies(WaitList, Queue);
+   Result.AddWriteDependencies(WaitList, Queue);
+
+   cl::size_t<3> CoreOrigin, ResultOrigin, Region;
+   CoreOrigin[0] = Tile.Core.X - Tile.Region.X;
+   CoreOrigin[1] = Tile.Core.Y - Tile.Region.Y;
+   Region[0] = Tile.Core.Width;
+   Region[1] = Tile.Core.Height;
+   Region[2] = 1;
+
+   cl::Event CopyEvent;
+   Queue.enqueueCopyImage(TileDest, Result, CoreOrigin, ResultOrigin, Region, &WaitList, &CopyEvent);
+
+   TileDest.SetReadEvent(CopyEvent, Queue);
+   Result.SetWriteEvent(CopyEvent, Queue);
+   Result.SetInDevice();
+
+   Result.Read();
+}
+
+void TileExecutor::WaitForSlot(SSlot& Slot)
+{
+   // The result is the last image used by a tile
+   if (Slot.Result != nullptr)
+      Slot.Result->WaitForEvents();
+}
+
+
+uint PixelBytes(const SImage& Image)
+{
+   return DepthOfType(Image.Type) / 8 * Image.Channels;
+}
+
+SImage TileSImage(const SImage& Image, const SRect& Region)
+{
+   SImage Tile = Image;
+   Tile.Width = Region.Width;
+   Tile.Height = Region.Height;
+   return Tile;
+}
+
+void * TileData(const SImage& Image, void * Data, const SRect& Region)
+{
+   return (char *) Data + size_t(Region.Y) * Image.Step + size_t(Region.X) * PixelBytes(Image);
+}
+
+}
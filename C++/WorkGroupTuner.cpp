@@ -0,0 +1,320 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: WorkGroupTuner.cpp
+//! @date   : Oct 2026
+//!
+//! @brief  : Automatic selection of the work-group size of kernels
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "WorkGroupTuner.h"
+#include "OpenCL.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+namespace OpenCLIPP
+{
+
+// Helpers
+static uint SizeClass(size_t Value);   // Number of bits needed for Value - sizes within a factor of 2 share the same tuning
+static bool Divides(const cl::NDRange& Local, const cl::NDRange& Global);  // true if Local can be used with Global
+static void WriteTuning(ostream& File, const string& DeviceKey, const string& Key, const cl::NDRange& Best);
+
+
+WorkGroupTuner::WorkGroupTuner(COpenCL& CL)
+:  m_CL(&CL),
+   m_Device((cl::Device&) CL),
+   m_DeviceKey(CL.GetDeviceInfo().DeviceName + " " + CL.GetDeviceInfo().DriverVersion)
+{
+   if (COpenCL::GetBinaryCachePath() != "")
+      m_FileName = COpenCL::GetBinaryCachePath() + "workgroups.txt";
+
+   Load();
+}
+
+cl::NDRange WorkGroupTuner::SelectLocalRange(const string& ProgramId, const cl::Kernel& Kernel, const string& Name,
+                                             const cl::NDRange& Global, SWorkGroupTrial& Trial)
+{
+   ostringstream Key;
+   Key << ProgramId << "|" << Name << "|" << SizeClass(Global[0]);
+   if (Global.dimensions() > 1)
+      Key << "x" << SizeClass(Global[1]);
+
+   lock_guard<mutex> Lock(m_Mutex);
+
+   auto It = m_Tunings.find(Key.str());
+   if (It == m_Tunings.end())
+   {
+      STuning Tuning;
+      Tuning.NbLaunched = 0;
+      Tuning.Done = false;
+      Tuning.Measured = false;
+      GenerateCandidates(Kernel, Global, Tuning);
+
+      if (Tuning.Candidates.size() < 2)
+         Tuning.Done = true;  // Nothing to choose from, let OpenCL choose
+
+      It = m_Tunings.insert(make_pair(Key.str(), Tuning)).first;
+   }
+
+   STuning& Tuning = It->second;
+
+   if (!Tuning.Done && Tuning.NbLaunched >= Tuning.Candidates.size() * NbRunsPerCandidate)
+      TryFinish(Tuning);   // All candidates have been launched, check if their results are ready
+
+   if (Tuning.Done)
+      return (Divides(Tuning.Best, Global) ? Tuning.Best : cl::NullRange);
+
+   if (Tuning.NbLaunched >= Tuning.Candidates.size() * NbRunsPerCandidate)
+      return cl::NullRange;   // Still waiting for the results
+
+   int Candidate = int(Tuning.NbLaunched % Tuning.Candidates.size());
+   const cl::NDRange& Local = Tuning.Candidates[Candidate];
+
+   if (!Divides(Local, Global))
+      return cl::NullRange;   // Image of a different size of the same size class
+
+   Tuning.NbLaunched++;
+
+   Trial.Key = Key.str();
+   Trial.Candidate = Candidate;
+
+   return Local;
+}
+
+void WorkGroupTuner::AddTrialResult(const SWorkGroupTrial& Trial, const cl::Event& Event)
+{
+   if (Trial.Candidate < 0)
+      return;
+
+   lock_guard<mutex> Lock(m_Mutex);
+
+   STuning& Tuning = m_Tunings[Trial.Key];
+   Tuning.Events.push_back(make_pair(Trial.Candidate, Event));
+
+   // The launches are usually not complete yet, the next launches of the kernel will check again
+   TryFinish(Tuning);
+}
+
+void WorkGroupTuner::GenerateCandidates(const cl::Kernel& Kernel, const cl::NDRange& Global, STuning& Tuning) const
+{
+   // Letting OpenCL choose is always a candidate
+   Tuning.Candidates.push_back(cl::NullRange);
+
+   size_t MaxSize = min(m_CL->GetDeviceInfo().MaxWorkGroupSize,
+                        Kernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(m_Device));
+
+   uint Dimensions = Global.dimensions();
+   size_t Width = Global[0];
+   size_t Height = (Dimensions > 1 ? Global[1] : 1);
+
+   for (size_t X = 4; X <= 256; X *= 2)
+      for (size_t Y = 1; Y <= 16; Y *= 2)
+      {
+         size_t Size = X * Y;
+         if (Size < 32 || Size > MaxSize)
+            continue;
+
+         if (Width % X != 0 || Height % Y != 0)
+            continue;
+
+         switch (Dimensions)
+         {
+         case 1:
+            if (Y == 1)
+               Tuning.Candidates.push_back(cl::NDRange(X));
+            break;
+         case 2:
+            Tuning.Candidates.push_back(cl::NDRange(X, Y));
+            break;
+         default:
+            Tuning.Candidates.push_back(cl::NDRange(X, Y, 1));
+            break;
+         }
+
+      }
+
+}
+
+void WorkGroupTuner::TryFinish(STuning& Tuning)
+{
+   if (Tuning.Events.size() < Tuning.Candidates.size() * NbRunsPerCandidate)
+      return;  // Some candidates have not been launched yet
+
+   // Keep the fastest time of each candidate
+   map<int, unsigned long long> Times;
+   bool Timed = true;
+
+   try
+   {
+      for (auto& Launch : Tuning.Events)
+      {
+         cl_int Status = Launch.second.getInfo<CL_EVENT_COMMAND_EXECUTION_STATUS>();
+         if (Status < 0)
+            throw cl::Error(Status, "timed launch failed");
+
+         if (Status != CL_COMPLETE)
+            return;  // Not done yet - never wait here, this is called while launching kernels
+
+         unsigned long long Time = Launch.second.getProfilingInfo<CL_PROFILING_COMMAND_END>() -
+                                   Launch.second.getProfilingInfo<CL_PROFILING_COMMAND_START>();
+
+         auto It = Times.find(Launch.first);
+         if (It == Times.end() || Time < It->second)
+            Times[Launch.first] = Time;
+      }
+
+   }
+   catch (const cl::Error&)
+   {
+      Timed = false; // Profiling was not enabled on the queue
+   }
+
+   Tuning.Events.clear();
+   Tuning.Done = true;
+   Tuning.Best = cl::NullRange;
+
+   if (!Timed || Times.empty())
+      return;
+
+   auto Best = Times.begin();
+   for (auto It = Times.begin(); It != Times.end(); It++)
+      if (It->second < Best->second)
+         Best = It;
+
+   Tuning.Best = Tuning.Candidates[Best->first];
+   Tuning.Measured = true;
+
+   Save();
+}
+
+// File format : one line per tuning : Device key <tab> Tuning key <tab> Number of dimensions, followed by the local range
+void WorkGroupTuner::Load()
+{
+   if (m_FileName == "")
+      return;
+
+   ifstream File(m_FileName.c_str());
+
+   string Line;
+   while (getline(File, Line))
+   {
+      size_t Tab1 = Line.find('\t');
+      size_t Tab2 = Line.find('\t', Tab1 + 1);
+      if (Tab1 == string::npos || Tab2 == string::npos)
+         continue;
+
+      if (Line.substr(0, Tab1) != m_DeviceKey)
+      {
+         m_OtherDevices.push_back(Line);
+         continue;
+      }
+
+      istringstream Values(Line.substr(Tab2 + 1));
+      size_t Dimensions = 0, X = 1, Y = 1;
+      Values >> Dimensions >> X >> Y;
+
+      STuning Tuning;
+      Tuning.NbLaunched = 0;
+      Tuning.Done = true;
+      Tuning.Measured = true;
+
+      switch (Dimensions)
+      {
+      case 0:
+         Tuning.Best = cl::NullRange;
+         break;
+      case 1:
+         Tuning.Best = cl::NDRange(X);
+         break;
+      case 2:
+         Tuning.Best = cl::NDRange(X, Y);
+         break;
+      default:
+         Tuning.Best = cl::NDRange(X, Y, 1);
+         break;
+      }
+
+      // Later lines replace older results
+      m_Tunings[Line.substr(Tab1 + 1, Tab2 - Tab1 - 1)] = Tuning;
+   }
+
+}
+
+void WorkGroupTuner::Save() const
+{
+   if (m_FileName == "")
+      return;
+
+   // The whole file is written again so each tuning appears only once
+   ofstream File(m_FileName.c_str(), ios::trunc);
+
+   for (auto& Line : m_OtherDevices)
+      File << Line << "\n";
+
+   for (auto& Tuning : m_Tunings)
+      if (Tuning.second.Measured)
+         WriteTuning(File, m_DeviceKey, Tuning.first, Tuning.second.Best);
+}
+
+
+// Helpers
+uint SizeClass(size_t Value)
+{
+   uint Bits = 0;
+   while (Value > 0)
+   {
+      Bits++;
+      Value >>= 1;
+   }
+
+   return Bits;
+}
+
+bool Divides(const cl::NDRange& Local, const cl::NDRange& Global)
+{
+   if (Local.dimensions() == 0)
+      return true;
+
+   if (Local.dimensions() != Global.dimensions())
+      return false;
+
+   for (uint i = 0; i < Local.dimensions(); i++)
+      if (Global[i] % Local[i] != 0)
+         return false;
+
+   return true;
+}
+
+void WriteTuning(ostream& File, const string& DeviceKey, const string& Key, const cl::NDRange& Best)
+{
+   uint Dimensions = Best.dimensions();
+
+   File << DeviceKey << "\t" << Key << "\t" << Dimensions;
+   for (uint i = 0; i < Dimensions && i < 2; i++)
+      File << " " << Best[i];
+
+   File << "\n";
+}
+
+}
@@ -25,7 +25,7 @@
 #include "Programs/ArithmeticVector.h"
 
 
-#define KERNEL_RANGE(src_img) src_img.VectorRange(8)
+#define KERNEL_RANGE(src_img) src_img.VectorRange(VectorWidth(src_img))
 
 #include "kernel_helpers.h"
 
@@ -39,7 +39,12 @@ void ArithmeticVector::Add(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuff
    CheckSimilarity(Source1, Source2);
    CheckSimilarity(Source1, Dest);
 
-   Kernel(add_images, In(Source1, Source2), Out(Dest), Source1.Step(), Source2.Step(), Dest.Step(), Source1.Width() * Source1.NbChannels());
+   ImageBuffer& Src1 = Source1.Direct();
+   ImageBuffer& Src2 = Source2.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(add_images, In(Src1, Src2), Out(Dst), Src1.Step(), Src2.Step(), Dst.Step(),
+      Src1.Offset(), Src2.Offset(), Dst.Offset(), Source1.Width() * Source1.NbChannels());
 }
 
 void ArithmeticVector::AddSquare(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuffer& Dest)
@@ -47,7 +52,12 @@ void ArithmeticVector::AddSquare(ImageBuffer& Source1, ImageBuffer& Source2, Ima
    CheckSimilarity(Source1, Source2);
    CheckSimilarity(Source1, Dest);
 
-   Kernel(add_square_images, In(Source1, Source2), Out(Dest), Source1.Step(), Source2.Step(), Dest.Step(), Source1.Width() * Source1.NbChannels());
+   ImageBuffer& Src1 = Source1.Direct();
+   ImageBuffer& Src2 = Source2.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(add_square_images, In(Src1, Src2), Out(Dst), Src1.Step(), Src2.Step(), Dst.Step(),
+      Src1.Offset(), Src2.Offset(), Dst.Offset(), Source1.Width() * Source1.NbChannels());
 }
 
 void ArithmeticVector::Sub(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuffer& Dest)
@@ -55,7 +65,12 @@ void ArithmeticVector::Sub(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuff
    CheckSimilarity(Source1, Source2);
    CheckSimilarity(Source1, Dest);
 
-   Kernel(sub_images, In(Source1, Source2), Out(Dest), Source1.Step(), Source2.Step(), Dest.Step(), Source1.Width() * Source1.NbChannels());
+   ImageBuffer& Src1 = Source1.Direct();
+   ImageBuffer& Src2 = Source2.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(sub_images, In(Src1, Src2), Out(Dst), Src1.Step(), Src2.Step(), Dst.Step(),
+      Src1.Offset(), Src2.Offset(), Dst.Offset(), Source1.Width() * Source1.NbChannels());
 }
 
 void ArithmeticVector::AbsDiff(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuffer& Dest)
@@ -63,7 +78,12 @@ void ArithmeticVector::AbsDiff(ImageBuffer& Source1, ImageBuffer& Source2, Image
    CheckSimilarity(Source1, Source2);
    CheckSimilarity(Source1, Dest);
 
-   Kernel(abs_diff_images, In(Source1, Source2), Out(Dest), Source1.Step(), Source2.Step(), Dest.Step(), Source1.Width() * Source1.NbChannels());
+   ImageBuffer& Src1 = Source1.Direct();
+   ImageBuffer& Src2 = Source2.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(abs_diff_images, In(Src1, Src2), Out(Dst), Src1.Step(), Src2.Step(), Dst.Step(),
+      Src1.Offset(), Src2.Offset(), Dst.Offset(), Source1.Width() * Source1.NbChannels());
 }
 
 void ArithmeticVector::Mul(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuffer& Dest)
@@ -71,7 +91,12 @@ void ArithmeticVector::Mul(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuff
    CheckSimilarity(Source1, Source2);
    CheckSimilarity(Source1, Dest);
 
-   Kernel(mul_images, In(Source1, Source2), Out(Dest), Source1.Step(), Source2.Step(), Dest.Step(), Source1.Width() * Source1.NbChannels());
+   ImageBuffer& Src1 = Source1.Direct();
+   ImageBuffer& Src2 = Source2.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(mul_images, In(Src1, Src2), Out(Dst), Src1.Step(), Src2.Step(), Dst.Step(),
+      Src1.Offset(), Src2.Offset(), Dst.Offset(), Source1.Width() * Source1.NbChannels());
 }
 
 void ArithmeticVector::Div(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuffer& Dest)
@@ -79,7 +104,12 @@ void ArithmeticVector::Div(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuff
    CheckSimilarity(Source1, Source2);
    CheckSimilarity(Source1, Dest);
 
-   Kernel(div_images, In(Source1, Source2), Out(Dest), Source1.Step(), Source2.Step(), Dest.Step(), Source1.Width() * Source1.NbChannels());
+   ImageBuffer& Src1 = Source1.Direct();
+   ImageBuffer& Src2 = Source2.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(div_images, In(Src1, Src2), Out(Dst), Src1.Step(), Src2.Step(), Dst.Step(),
+      Src1.Offset(), Src2.Offset(), Dst.Offset(), Source1.Width() * Source1.NbChannels());
 }
 
 void ArithmeticVector::Min(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuffer& Dest)
@@ -87,7 +117,12 @@ void ArithmeticVector::Min(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuff
    CheckSimilarity(Source1, Source2);
    CheckSimilarity(Source1, Dest);
 
-   Kernel(min_images, In(Source1, Source2), Out(Dest), Source1.Step(), Source2.Step(), Dest.Step(), Source1.Width() * Source1.NbChannels());
+   ImageBuffer& Src1 = Source1.Direct();
+   ImageBuffer& Src2 = Source2.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(min_images, In(Src1, Src2), Out(Dst), Src1.Step(), Src2.Step(), Dst.Step(),
+      Src1.Offset(), Src2.Offset(), Dst.Offset(), Source1.Width() * Source1.NbChannels());
 }
 
 void ArithmeticVector::Max(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuffer& Dest)
@@ -95,7 +130,12 @@ void ArithmeticVector::Max(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuff
    CheckSimilarity(Source1, Source2);
    CheckSimilarity(Source1, Dest);
 
-   Kernel(max_images, In(Source1, Source2), Out(Dest), Source1.Step(), Source2.Step(), Dest.Step(), Source1.Width() * Source1.NbChannels());
+   ImageBuffer& Src1 = Source1.Direct();
+   ImageBuffer& Src2 = Source2.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(max_images, In(Src1, Src2), Out(Dst), Src1.Step(), Src2.Step(), Dst.Step(),
+      Src1.Offset(), Src2.Offset(), Dst.Offset(), Source1.Width() * Source1.NbChannels());
 }
 
 void ArithmeticVector::Mean(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuffer& Dest)
@@ -103,7 +143,12 @@ void ArithmeticVector::Mean(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuf
    CheckSimilarity(Source1, Source2);
    CheckSimilarity(Source1, Dest);
 
-   Kernel(mean_images, In(Source1, Source2), Out(Dest), Source1.Step(), Source2.Step(), Dest.Step(), Source1.Width() * Source1.NbChannels());
+   ImageBuffer& Src1 = Source1.Direct();
+   ImageBuffer& Src2 = Source2.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(mean_images, In(Src1, Src2), Out(Dst), Src1.Step(), Src2.Step(), Dst.Step(),
+      Src1.Offset(), Src2.Offset(), Dst.Offset(), Source1.Width() * Source1.NbChannels());
 }
 
 void ArithmeticVector::Combine(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuffer& Dest)
@@ -111,7 +156,12 @@ void ArithmeticVector::Combine(ImageBuffer& Source1, ImageBuffer& Source2, Image
    CheckSimilarity(Source1, Source2);
    CheckSimilarity(Source1, Dest);
 
-   Kernel(combine_images, In(Source1, Source2), Out(Dest), Source1.Step(), Source2.Step(), Dest.Step(), Source1.Width() * Source1.NbChannels());
+   ImageBuffer& Src1 = Source1.Direct();
+   ImageBuffer& Src2 = Source2.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(combine_images, In(Src1, Src2), Out(Dst), Src1.Step(), Src2.Step(), Dst.Step(),
+      Src1.Offset(), Src2.Offset(), Dst.Offset(), Source1.Width() * Source1.NbChannels());
 }
 
 
@@ -121,63 +171,99 @@ void ArithmeticVector::Add(ImageBuffer& Source, ImageBuffer& Dest, float value)
 {
    CheckSimilarity(Source, Dest);
 
-   Kernel(add_constant, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels(), value);
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(add_constant, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels(), value);
 }
 
 void ArithmeticVector::Sub(ImageBuffer& Source, ImageBuffer& Dest, float value)
 {
    CheckSimilarity(Source, Dest);
 
-   Kernel(sub_constant, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels(), value);
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(sub_constant, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels(), value);
 }
 
 void ArithmeticVector::AbsDiff(ImageBuffer& Source, ImageBuffer& Dest, float value)
 {
    CheckSimilarity(Source, Dest);
 
-   Kernel(abs_diff_constant, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels(), value);
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(abs_diff_constant, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels(), value);
 }
 
 void ArithmeticVector::Mul(ImageBuffer& Source, ImageBuffer& Dest, float value)
 {
    CheckSimilarity(Source, Dest);
 
-   Kernel(mul_constant, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels(), value);
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(mul_constant, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels(), value);
 }
 
 void ArithmeticVector::Div(ImageBuffer& Source, ImageBuffer& Dest, float value)
 {
    CheckSimilarity(Source, Dest);
 
-   Kernel(div_constant, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels(), value);
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(div_constant, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels(), value);
 }
 
 void ArithmeticVector::RevDiv(ImageBuffer& Source, ImageBuffer& Dest, float value)
 {
    CheckSimilarity(Source, Dest);
 
-   Kernel(reversed_div, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels(), value);
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(reversed_div, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels(), value);
 }
 
 void ArithmeticVector::Min(ImageBuffer& Source, ImageBuffer& Dest, float value)
 {
    CheckSimilarity(Source, Dest);
 
-   Kernel(min_constant, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels(), value);
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(min_constant, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels(), value);
 }
 
 void ArithmeticVector::Max(ImageBuffer& Source, ImageBuffer& Dest, float value)
 {
    CheckSimilarity(Source, Dest);
 
-   Kernel(max_constant, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels(), value);
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(max_constant, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels(), value);
 }
 
 void ArithmeticVector::Mean(ImageBuffer& Source, ImageBuffer& Dest, float value)
 {
    CheckSimilarity(Source, Dest);
 
-   Kernel(mean_constant, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels(), value);
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(mean_constant, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels(), value);
 }
 
 
@@ -187,21 +273,33 @@ void ArithmeticVector::Abs(ImageBuffer& Source, ImageBuffer& Dest)
 {
    CheckSimilarity(Source, Dest);
 
-   Kernel(abs_image, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels());
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(abs_image, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels());
 }
 
 void ArithmeticVector::Invert(ImageBuffer& Source, ImageBuffer& Dest)
 {
    CheckSimilarity(Source, Dest);
 
-   Kernel(invert_image, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels());
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(invert_image, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels());
 }
 
 void ArithmeticVector::Sqr(ImageBuffer& Source, ImageBuffer& Dest)
 {
    CheckSimilarity(Source, Dest);
 
-   Kernel(sqr_image, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels());
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(sqr_image, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels());
 }
 
 
@@ -211,35 +309,55 @@ void ArithmeticVector::Exp(ImageBuffer& Source, ImageBuffer& Dest)
 {
    CheckSimilarity(Source, Dest);
 
-   Kernel(exp_image, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels());
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(exp_image, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels());
 }
 
 void ArithmeticVector::Log(ImageBuffer& Source, ImageBuffer& Dest)
 {
    CheckSimilarity(Source, Dest);
 
-   Kernel(log_image, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels());
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(log_image, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels());
 }
 
 void ArithmeticVector::Sqrt(ImageBuffer& Source, ImageBuffer& Dest)
 {
    CheckSimilarity(Source, Dest);
 
-   Kernel(sqrt_image, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels());
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(sqrt_image, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels());
 }
 
 void ArithmeticVector::Sin(ImageBuffer& Source, ImageBuffer& Dest)
 {
    CheckSimilarity(Source, Dest);
 
-   Kernel(sin_image, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels());
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(sin_image, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels());
 }
 
 void ArithmeticVector::Cos(ImageBuffer& Source, ImageBuffer& Dest)
 {
    CheckSimilarity(Source, Dest);
 
-   Kernel(cos_image, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels());
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(cos_image, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels());
 }
 
 }
@@ -24,6 +24,8 @@
 
 #include "Programs/Blob.h"
 
+#define KERNEL_OFFSET(src_img) OpenCLIPP::_NoOffset(src_img)   // Kernels need the whole image
+
 #include "kernel_helpers.h"
 
 
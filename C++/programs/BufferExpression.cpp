@@ -0,0 +1,177 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: BufferExpression.cpp
+//! @date   : Oct 2026
+//!
+//! @brief  : Lazy arithmetic expressions on image buffers
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Programs/BufferExpression.h"
+
+
+#define KERNEL_RANGE(src_img) src_img.VectorRange(ExpressionProgram.VectorWidth(src_img))
+
+#include "kernel_helpers.h"
+
+
+namespace OpenCLIPP
+{
+
+static const char * const BufferNames[] = {"S1", "S2", "S3", "S4"};
+
+// Types, conversions and load/store macros, shared with the Vector_*.cl programs - included when the program is built
+static const char * const SourceHeader =
+   "#include \"Vector_Types.cl\"\n";
+
+
+// ExpressionBuilder
+
+std::string ExpressionBuilder::Buffer(ImageBuffer& Image)
+{
+   for (size_t i = 0; i < m_Buffers.size(); i++)
+      if (m_Buffers[i] == &Image)
+         return BufferNames[i];
+
+   if (m_Buffers.size() >= MaxBuffers)
+      throw cl::Error(CL_INVALID_VALUE, "too many image buffers in the expression");
+
+   m_Buffers.push_back(&Image);
+
+   return BufferNames[m_Buffers.size() - 1];
+}
+
+std::string ExpressionBuilder::Value(float value)
+{
+   if (m_Values.size() >= MaxValues)
+      throw cl::Error(CL_INVALID_VALUE, "too many values in the expression");
+
+   static const char Digits[] = "0123456789abcdef";
+
+   // Converted to T so that the value is a vector in the vector code
+   std::string Code = "((T) V.s";
+   Code += Digits[m_Values.size()];
+   Code += ")";
+
+   m_Values.push_back(value);
+
+   return Code;
+}
+
+
+// ExpressionEvaluator
+
+ExpressionEvaluator::ExpressionEvaluator(COpenCL& CL)
+:  m_CL(&CL)
+{ }
+
+void ExpressionEvaluator::Evaluate(const std::string& Code, const ExpressionBuilder& Builder, ImageBuffer& Dest)
+{
+   const std::vector<ImageBuffer *>& Buffers = Builder.GetBuffers();
+   const std::vector<float>& ExpressionValues = Builder.GetValues();
+
+   if (Buffers.empty())
+      throw cl::Error(CL_INVALID_VALUE, "an expression must use at least one image buffer");
+
+   ImageBuffer& Source1 = *Buffers[0];
+   for (auto it = Buffers.begin(); it != Buffers.end(); it++)
+      CheckSimilarity(Source1, **it);
+
+   CheckSimilarity(Source1, Dest);
+
+   ImageBufferProgram& ExpressionProgram = SelectProgram(Code, uint(Buffers.size()));
+
+   // Buffer slots not used by the expression receive the first buffer
+   ImageBuffer& Source2 = (Buffers.size() > 1 ? *Buffers[1] : Source1);
+   ImageBuffer& Source3 = (Buffers.size() > 2 ? *Buffers[2] : Source1);
+   ImageBuffer& Source4 = (Buffers.size() > 3 ? *Buffers[3] : Source1);
+
+   cl_float16 Values;
+   for (uint i = 0; i < ExpressionBuilder::MaxValues; i++)
+      Values.s[i] = (i < ExpressionValues.size() ? ExpressionValues[i] : 0);
+
+   Kernel_(*m_CL, ExpressionProgram.SelectProgram(Source1), expression, DEFAULT_LOCAL_RANGE,
+      In(Source1, Source2, Source3, Source4), Out(Dest),
+      Source1.Step(), Source2.Step(), Source3.Step(), Source4.Step(), Dest.Step(),
+      Source1.Width() * Source1.NbChannels(), Values);
+}
+
+ImageBufferProgram& ExpressionEvaluator::SelectProgram(const std::string& Code, uint NbBuffers)
+{
+   std::lock_guard<std::mutex> Lock(m_Mutex);
+
+   std::shared_ptr<ImageBufferProgram>& ExpressionProgram = m_Programs[Code];
+   if (ExpressionProgram == nullptr)
+      ExpressionProgram = std::make_shared<ImageBufferProgram>(*m_CL, true, GenerateSource(Code, NbBuffers).c_str(), 8);
+
+   return *ExpressionProgram;
+}
+
+std::string ExpressionEvaluator::GenerateSource(const std::string& Code, uint NbBuffers)
+{
+   std::string Source = SourceHeader;
+
+   Source +=
+      "__attribute__(( vec_type_hint(HINT_TYPE) ))\n"
+      "kernel void expression(INPUT_SPACE const TYPE * source1, INPUT_SPACE const TYPE * source2,\n"
+      "   INPUT_SPACE const TYPE * source3, INPUT_SPACE const TYPE * source4, global TYPE * dest,\n"
+      "   int src1_step, int src2_step, int src3_step, int src4_step, int dst_step, int width, float16 V)\n"
+      "{\n"
+      "   const int gx = get_global_id(0);\t/* x divided by VEC_WIDTH */\n"
+      "   const int gy = get_global_id(1);\n"
+      "   src1_step /= sizeof(SCALAR);\n"
+      "   src2_step /= sizeof(SCALAR);\n"
+      "   src3_step /= sizeof(SCALAR);\n"
+      "   src4_step /= sizeof(SCALAR);\n"
+      "   dst_step /= sizeof(SCALAR);\n"
+      "   if ((gx + 1) * VEC_WIDTH > width)\n"
+      "   {\n"
+      "      /* Last worker on the current row for an image that has a width that is not a multiple of VEC_WIDTH*/\n"
+      "      typedef float T;\n"
+      "      for (int i = gx * VEC_WIDTH; i < width; i++)\n"
+      "      {\n";
+
+   for (uint i = 1; i <= NbBuffers; i++)
+   {
+      std::string Index = std::string(1, char('0' + i));
+      Source += "         const T S" + Index + " = LOAD_SCALAR(((const INPUT_SPACE SCALAR *) source" + Index + "),"
+         " (gy * src" + Index + "_step) + i);\n";
+   }
+
+   Source +=
+      "         STORE_SCALAR(((global SCALAR *) dest), (gy * dst_step) + i, " + Code + ");\n"
+      "      }\n"
+      "      return;\n"
+      "   }\n"
+      "   typedef FTYPE T;\n";
+
+   for (uint i = 1; i <= NbBuffers; i++)
+   {
+      std::string Index = std::string(1, char('0' + i));
+      Source += "   const T S" + Index + " = LOAD_VECTOR(source" + Index + ", (gy * src" + Index + "_step) / VEC_WIDTH + gx);\n";
+   }
+
+   Source +=
+      "   STORE_VECTOR(dest, (gy * dst_step) / VEC_WIDTH + gx, " + Code + ");\n"
+      "}\n";
+
+   return Source;
+}
+
+}
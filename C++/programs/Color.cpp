@@ -24,6 +24,9 @@
 
 #include "Programs/Color.h"
 
+// The conversions are done by Send() and Read(), which are not part of recorded graphs
+#define NO_GRAPH_RECORDING
+
 #include "kernel_helpers.h"
 
 namespace OpenCLIPP
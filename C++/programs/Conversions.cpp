@@ -31,6 +31,7 @@ namespace OpenCLIPP
 
 double GetTypeRange(const IImage& Img);
 double GetTypeMin(const IImage& Img);
+cl::size_t<3> ImageOrigin(const IImage& Img);   // Origin of the image in its OpenCL image, for copy operations
 
 // Copy & Convert
 
@@ -100,9 +101,9 @@ void Conversions::Copy(IImage& Source, IImage& Dest)
 
    Source.SendIfNeeded();
 
-   cl::size_t<3> Origin, Region(Source.Width(), Source.Height(), 1);
+   cl::size_t<3> Region(Source.Width(), Source.Height(), 1);
 
-   m_CL->GetQueue().enqueueCopyImage(Source, Dest, Origin, Origin, Region);
+   m_CL->GetQueue().enqueueCopyImage(Source, Dest, ImageOrigin(Source), ImageOrigin(Dest), Region);
 
    Dest.SetInDevice();
 }
@@ -134,9 +135,9 @@ void Conversions::Copy(IImage& Source, ImageBuffer& Dest)
 
    Source.SendIfNeeded();
 
-   cl::size_t<3> Origin, Region(Source.Width(), Source.Height(), 1);
+   cl::size_t<3> Region(Source.Width(), Source.Height(), 1);
 
-   m_CL->GetQueue().enqueueCopyImageToBuffer(Source, Dest, Origin, Region, 0);
+   m_CL->GetQueue().enqueueCopyImageToBuffer(Source, Dest, ImageOrigin(Source), Region, 0);
 
    Dest.SetInDevice();
 }
@@ -152,9 +153,9 @@ void Conversions::Copy(ImageBuffer& Source, IImage& Dest)
 
    Source.SendIfNeeded();
 
-   cl::size_t<3> Origin, Region(Source.Width(), Source.Height(), 1);
+   cl::size_t<3> Region(Source.Width(), Source.Height(), 1);
 
-   m_CL->GetQueue().enqueueCopyBufferToImage(Source, Dest, 0, Origin, Region);
+   m_CL->GetQueue().enqueueCopyBufferToImage(Source, Dest, 0, ImageOrigin(Dest), Region);
 
    Dest.SetInDevice();
 }
@@ -208,6 +209,9 @@ double GetTypeRange(const IImage& Img)
    case 8:
       return 0xFF;
    case 16:
+      if (Img.IsFloat())
+         return 0xFF;
+
       return 0xFFFF;
    case 32:
       if (Img.IsFloat())
@@ -244,4 +248,12 @@ double GetTypeMin(const IImage& Img)
 
 }
 
+cl::size_t<3> ImageOrigin(const IImage& Img)
+{
+   cl::size_t<3> Origin;
+   Origin[0] = Img.Origin().X;
+   Origin[1] = Img.Origin().Y;
+   return Origin;
+}
+
 }
@@ -135,7 +135,8 @@ void Filters::Median(IImage& Source, IImage& Dest, int Width)
 
    if (Width == 3)
    {
-      if (RangeFit(Source, 16, 16))
+      // The cached version needs its work-groups to be aligned on blocks of 16x16 pixels
+      if (RangeFit(Source, 16, 16) && Source.Origin().X % 16 == 0 && Source.Origin().Y % 16 == 0)
       {
          Kernel_(*m_CL, SelectProgram(Source), median3_cached, cl::NDRange(16, 16, 1), Source, Dest);
          return;
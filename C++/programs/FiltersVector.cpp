@@ -26,6 +26,7 @@
 #include <vector>
 
 #define SELECT_NAME(name, src_img) SelectName( #name , src_img)
+#define KERNEL_RANGE(src_img) FilterRange(src_img)
 
 #include "kernel_helpers.h"
 
@@ -34,14 +35,31 @@
 namespace OpenCLIPP
 {
 
-static std::string SelectName(const char * Name, const ImageBase& Img)
+// The _1C kernels filter each channel separately, so packed images with more channels (like RGB) are filtered without conversion
+static std::string SelectName(const char * Name, const ImageBase& /*Img*/)
 {
-   if (Img.NbChannels() != 1)
-      throw cl::Error(CL_IMAGE_FORMAT_NOT_SUPPORTED, "Filters on images with >1 channels not yet supported");
-
    return std::string(Name) + "_1C";
 }
 
+// Height of each image of a batch, used by the kernels for the borders
+static uint ImageHeight(ImageBuffer& Img)
+{
+   ImageBufferBatch * Batch = dynamic_cast<ImageBufferBatch *>(&Img);
+   if (Batch != nullptr)
+      return Batch->ImageHeight();
+
+   return Img.Height();
+}
+
+// One worker per channel of each pixel - batches of images are filtered with one image per index of the third dimension
+static cl::NDRange FilterRange(ImageBuffer& Img)
+{
+   ImageBufferBatch * Batch = dynamic_cast<ImageBufferBatch *>(&Img);
+   uint NbImages = (Batch != nullptr ? Batch->NbImages() : 1);
+
+   return cl::NDRange(Img.Width() * Img.NbChannels(), ImageHeight(Img), NbImages);
+}
+
 static void GenerateBlurMask(std::vector<float>& Mask, float Sigma, int MaskSize)
 {
    float sum = 0;
@@ -81,7 +99,7 @@ void FiltersVector::GaussianBlur(ImageBuffer& Source, ImageBuffer& Dest, float S
    ReadBuffer MaskBuffer(*m_CL, Mask.data(), NbElements);
 
    // Execute kernel
-   Kernel(gaussian_blur, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Height(), MaskBuffer, MaskSize);
+   Kernel(gaussian_blur, In(Source), Out(Dest), Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels(), MaskBuffer, MaskSize);
 }
 
 void FiltersVector::Gauss(ImageBuffer& Source, ImageBuffer& Dest, int Width)
@@ -90,13 +108,13 @@ void FiltersVector::Gauss(ImageBuffer& Source, ImageBuffer& Dest, int Width)
 
    if (Width == 3)
    {
-      Kernel(gaussian3, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(gaussian3, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
    if (Width == 5)
    {
-      Kernel(gaussian5, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(gaussian5, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
@@ -110,7 +128,7 @@ void FiltersVector::Sharpen(ImageBuffer& Source, ImageBuffer& Dest, int Width)
    if (Width != 3)
       throw cl::Error(CL_INVALID_ARG_VALUE, "Invalid width used in Sharpen - allowed : 3");
 
-   Kernel(sharpen3, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Height());
+   Kernel(sharpen3, In(Source), Out(Dest), Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
 }
 
 void FiltersVector::Smooth(ImageBuffer& Source, ImageBuffer& Dest, int Width)
@@ -120,7 +138,7 @@ void FiltersVector::Smooth(ImageBuffer& Source, ImageBuffer& Dest, int Width)
    if (Width < 3 || (Width & 1) == 0)
       throw cl::Error(CL_INVALID_ARG_VALUE, "Invalid width used in Smooth");
 
-   Kernel(smooth, In(Source), Out(Dest), Source.Step(), Dest.Step(), Source.Height(), Width);
+   Kernel(smooth, In(Source), Out(Dest), Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels(), Width);
 }
 
 /*static bool RangeFit(const ImageBase& Img, int RangeX, int RangeY)
@@ -147,15 +165,15 @@ void FiltersVector::Median(ImageBuffer& Source, ImageBuffer& Dest, int Width)
    {
       /*if (RangeFit(Source, 16, 16))  // The cached version is slower on my GTX 680
       {
-         Kernel_(*m_CL, SelectProgram(Source), median3_cached, cl::NDRange(16, 16, 1), Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+         Kernel_(*m_CL, SelectProgram(Source), median3_cached, cl::NDRange(16, 16, 1), Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
          return;
       }*/
 
-      Kernel(median3, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(median3, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
-   Kernel(median5, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+   Kernel(median5, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
 }
 
 void FiltersVector::SobelVert(ImageBuffer& Source, ImageBuffer& Dest, int Width)
@@ -164,13 +182,13 @@ void FiltersVector::SobelVert(ImageBuffer& Source, ImageBuffer& Dest, int Width)
 
    if (Width == 3)
    {
-      Kernel(sobelV3, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(sobelV3, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
    if (Width == 5)
    {
-      Kernel(sobelV5, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(sobelV5, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
@@ -183,13 +201,13 @@ void FiltersVector::SobelHoriz(ImageBuffer& Source, ImageBuffer& Dest, int Width
 
    if (Width == 3)
    {
-      Kernel(sobelH3, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(sobelH3, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
    if (Width == 5)
    {
-      Kernel(sobelH5, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(sobelH5, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
    
@@ -202,13 +220,13 @@ void FiltersVector::SobelCross(ImageBuffer& Source, ImageBuffer& Dest, int Width
 
    if (Width == 3)
    {
-      Kernel(sobelCross3, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(sobelCross3, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
    if (Width == 5)
    {
-      Kernel(sobelCross5, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(sobelCross5, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
    
@@ -221,13 +239,13 @@ void FiltersVector::Sobel(ImageBuffer& Source, ImageBuffer& Dest, int Width)
 
    if (Width == 3)
    {
-      Kernel(sobel3, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(sobel3, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
    if (Width == 5)
    {
-      Kernel(sobel5, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(sobel5, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
    
@@ -240,7 +258,7 @@ void FiltersVector::PrewittVert(ImageBuffer& Source, ImageBuffer& Dest, int Widt
 
    if (Width == 3)
    {
-      Kernel(prewittV3, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(prewittV3, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
@@ -253,7 +271,7 @@ void FiltersVector::PrewittHoriz(ImageBuffer& Source, ImageBuffer& Dest, int Wid
 
    if (Width == 3)
    {
-      Kernel(prewittH3, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(prewittH3, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
@@ -266,7 +284,7 @@ void FiltersVector::Prewitt(ImageBuffer& Source, ImageBuffer& Dest, int Width)
 
    if (Width == 3)
    {
-      Kernel(prewitt3, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(prewitt3, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
@@ -279,7 +297,7 @@ void FiltersVector::ScharrVert(ImageBuffer& Source, ImageBuffer& Dest, int Width
 
    if (Width == 3)
    {
-      Kernel(scharrV3, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(scharrV3, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
@@ -292,7 +310,7 @@ void FiltersVector::ScharrHoriz(ImageBuffer& Source, ImageBuffer& Dest, int Widt
 
    if (Width == 3)
    {
-      Kernel(scharrH3, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(scharrH3, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
@@ -305,7 +323,7 @@ void FiltersVector::Scharr(ImageBuffer& Source, ImageBuffer& Dest, int Width)
 
    if (Width == 3)
    {
-      Kernel(scharr3, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(scharr3, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
@@ -318,13 +336,13 @@ void FiltersVector::Hipass(ImageBuffer& Source, ImageBuffer& Dest, int Width)
 
    if (Width == 3)
    {
-      Kernel(hipass3, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(hipass3, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
    if (Width == 5)
    {
-      Kernel(hipass5, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(hipass5, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
@@ -337,13 +355,13 @@ void FiltersVector::Laplace(ImageBuffer& Source, ImageBuffer& Dest, int Width)
 
    if (Width == 3)
    {
-      Kernel(laplace3, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(laplace3, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
    if (Width == 5)
    {
-      Kernel(laplace5, Source, Dest, Source.Step(), Dest.Step(), Source.Height());
+      Kernel(laplace5, Source, Dest, Source.Step(), Dest.Step(), ImageHeight(Source), Source.NbChannels());
       return;
    }
 
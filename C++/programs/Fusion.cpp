@@ -0,0 +1,564 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: Fusion.cpp
+//! @date   : Oct 2026
+//!
+//! @brief  : Fusion of pointwise operations into single kernels
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Programs/Fusion.h"
+
+#include "kernel_helpers.h"
+
+#include <cstring>
+
+
+namespace OpenCLIPP
+{
+
+static const char * const ImageNames[] = {"I1", "I2", "I3"};
+
+static std::string ReadPixel(const ImageBase& Img, const std::string& Name);
+static std::string ReadLogicPixel(const ImageBase& Img, const std::string& Name);
+static std::string LogicMask(const ImageBase& Img);
+static std::string WritePixel(const ImageBase& Img, bool LogicResult);
+static const char * CompareOperator(Tresholding::ECompareOperation Op);
+
+
+// PointwiseChain
+
+PointwiseChain::PointwiseChain()
+:  m_NbOperations(0),
+   m_UsesLogic(false),
+   m_InFloat(true),
+   m_InLogic(true)
+{ }
+
+void PointwiseChain::Clear()
+{
+   m_Code.clear();
+   m_Values.clear();
+   m_Images.clear();
+   m_NbOperations = 0;
+   m_UsesLogic = false;
+   m_InFloat = true;
+   m_InLogic = true;
+}
+
+PointwiseChain& PointwiseChain::AddCode(const std::string& Code)
+{
+   m_Code += "   " + Code + "\n";
+   return *this;
+}
+
+PointwiseChain& PointwiseChain::Operation(const std::string& Code)
+{
+   if (!m_InFloat)
+      AddCode("P = convert_float4(L);");
+
+   m_InFloat = true;
+   m_InLogic = false;
+   m_NbOperations++;
+
+   return AddCode(Code);
+}
+
+PointwiseChain& PointwiseChain::LogicOperation(const std::string& Code)
+{
+   // Same as Logic.cl : the result is masked to the depth of the image
+   if (!m_InLogic)
+      AddCode("L = LOGIC(P);");
+
+   m_UsesLogic = true;
+   m_InFloat = false;
+   m_InLogic = true;
+   m_NbOperations++;
+
+   return AddCode("L = (" + Code + ") & LOGIC_MASK;");
+}
+
+std::string PointwiseChain::Value(float value)
+{
+   if (m_Values.size() >= MaxValues)
+      throw cl::Error(CL_INVALID_VALUE, "too many values in the pointwise chain");
+
+   static const char Digits[] = "0123456789abcdef";
+
+   std::string Code = "V.s";
+   Code += Digits[m_Values.size()];
+
+   m_Values.push_back(value);
+
+   return Code;
+}
+
+std::string PointwiseChain::LogicValue(uint value)
+{
+   // The bits of the value are sent as is in a float and reinterpreted by the kernel
+   float Bits;
+   std::memcpy(&Bits, &value, sizeof(Bits));
+
+   return "as_uint(" + Value(Bits) + ")";
+}
+
+std::string PointwiseChain::ImageValue(IImage& Image)
+{
+   for (size_t i = 0; i < m_Images.size(); i++)
+      if (m_Images[i] == &Image)
+         return ImageNames[i];
+
+   if (m_Images.size() >= MaxImages)
+      throw cl::Error(CL_INVALID_VALUE, "too many images in the pointwise chain");
+
+   m_Images.push_back(&Image);
+
+   return ImageNames[m_Images.size() - 1];
+}
+
+
+// Arithmetic
+PointwiseChain& PointwiseChain::Add(IImage& Image)
+{
+   return Operation("P = P + " + ImageValue(Image) + ";");
+}
+
+PointwiseChain& PointwiseChain::AddSquare(IImage& Image)
+{
+   std::string I = ImageValue(Image);
+   return Operation("P = P + " + I + " * " + I + ";");
+}
+
+PointwiseChain& PointwiseChain::Sub(IImage& Image)
+{
+   return Operation("P = P - " + ImageValue(Image) + ";");
+}
+
+PointwiseChain& PointwiseChain::AbsDiff(IImage& Image)
+{
+   return Operation("P = fabs(P - " + ImageValue(Image) + ");");
+}
+
+PointwiseChain& PointwiseChain::Mul(IImage& Image)
+{
+   return Operation("P = P * " + ImageValue(Image) + ";");
+}
+
+PointwiseChain& PointwiseChain::Div(IImage& Image)
+{
+   return Operation("P = P / " + ImageValue(Image) + ";");
+}
+
+PointwiseChain& PointwiseChain::Min(IImage& Image)
+{
+   return Operation("P = min(P, " + ImageValue(Image) + ");");
+}
+
+PointwiseChain& PointwiseChain::Max(IImage& Image)
+{
+   return Operation("P = max(P, " + ImageValue(Image) + ");");
+}
+
+PointwiseChain& PointwiseChain::Mean(IImage& Image)
+{
+   return Operation("P = (P + " + ImageValue(Image) + ") * .5f;");
+}
+
+PointwiseChain& PointwiseChain::Combine(IImage& Image)
+{
+   std::string I = ImageValue(Image);
+   return Operation("P = sqrt(P * P + " + I + " * " + I + ");");
+}
+
+PointwiseChain& PointwiseChain::Add(float value)
+{
+   return Operation("P = P + " + Value(value) + ";");
+}
+
+PointwiseChain& PointwiseChain::Sub(float value)
+{
+   return Operation("P = P - " + Value(value) + ";");
+}
+
+PointwiseChain& PointwiseChain::AbsDiff(float value)
+{
+   return Operation("P = fabs(P - " + Value(value) + ");");
+}
+
+PointwiseChain& PointwiseChain::Mul(float value)
+{
+   return Operation("P = P * " + Value(value) + ";");
+}
+
+PointwiseChain& PointwiseChain::Div(float value)
+{
+   return Operation("P = P / " + Value(value) + ";");
+}
+
+PointwiseChain& PointwiseChain::RevDiv(float value)
+{
+   return Operation("P = " + Value(value) + " / P;");
+}
+
+PointwiseChain& PointwiseChain::Min(float value)
+{
+   return Operation("P = min(P, " + Value(value) + ");");
+}
+
+PointwiseChain& PointwiseChain::Max(float value)
+{
+   return Operation("P = max(P, " + Value(value) + ");");
+}
+
+PointwiseChain& PointwiseChain::Mean(float value)
+{
+   return Operation("P = (P + " + Value(value) + ") * .5f;");
+}
+
+PointwiseChain& PointwiseChain::Abs()
+{
+   return Operation("P = fabs(P);");
+}
+
+PointwiseChain& PointwiseChain::Invert()
+{
+   return Operation("P = 255.f - P;");
+}
+
+PointwiseChain& PointwiseChain::Exp()
+{
+   return Operation("P = exp(P);");
+}
+
+PointwiseChain& PointwiseChain::Log()
+{
+   return Operation("P = log(P);");
+}
+
+PointwiseChain& PointwiseChain::Sqr()
+{
+   return Operation("P = P * P;");
+}
+
+PointwiseChain& PointwiseChain::Sqrt()
+{
+   return Operation("P = sqrt(P);");
+}
+
+PointwiseChain& PointwiseChain::Sin()
+{
+   return Operation("P = sin(P);");
+}
+
+PointwiseChain& PointwiseChain::Cos()
+{
+   return Operation("P = cos(P);");
+}
+
+
+// Logic
+PointwiseChain& PointwiseChain::And(IImage& Image)
+{
+   return LogicOperation("L & L" + ImageValue(Image));
+}
+
+PointwiseChain& PointwiseChain::Or(IImage& Image)
+{
+   return LogicOperation("L | L" + ImageValue(Image));
+}
+
+PointwiseChain& PointwiseChain::Xor(IImage& Image)
+{
+   return LogicOperation("L ^ L" + ImageValue(Image));
+}
+
+PointwiseChain& PointwiseChain::And(uint value)
+{
+   return LogicOperation("L & (LOGIC_SCALAR) " + LogicValue(value));
+}
+
+PointwiseChain& PointwiseChain::Or(uint value)
+{
+   return LogicOperation("L | (LOGIC_SCALAR) " + LogicValue(value));
+}
+
+PointwiseChain& PointwiseChain::Xor(uint value)
+{
+   return LogicOperation("L ^ (LOGIC_SCALAR) " + LogicValue(value));
+}
+
+PointwiseChain& PointwiseChain::Not()
+{
+   return LogicOperation("~L");
+}
+
+
+// Lut
+PointwiseChain& PointwiseChain::LUT(const uint * levels, const uint * values, uint NbValues)
+{
+   if (NbValues < 2)
+      throw cl::Error(CL_INVALID_VALUE, "a LUT needs at least 2 values");
+
+   // Same as lut() in Lut.cl : values outside of the levels are kept as is
+   std::string Code = "{ const float4 S = P;";
+   std::string Level = Value(float(levels[0]));
+   for (uint i = 0; i < NbValues - 1; i++)
+   {
+      std::string NextLevel = Value(float(levels[i + 1]));
+      Code += " P = select(P, (float4) " + Value(float(values[i])) + ", (S >= " + Level + ") & (S < " + NextLevel + "));";
+      Level = NextLevel;
+   }
+
+   return Operation(Code + " }");
+}
+
+PointwiseChain& PointwiseChain::LUTLinear(const float * levels, const float * values, uint NbValues)
+{
+   if (NbValues < 2)
+      throw cl::Error(CL_INVALID_VALUE, "a LUT needs at least 2 values");
+
+   // Same as lut_linear() in Lut.cl : values outside of the levels are kept as is
+   std::string Code = "{ const float4 S = P;";
+   std::string Level = Value(levels[0]);
+   std::string LevelValue = Value(values[0]);
+   for (uint i = 0; i < NbValues - 1; i++)
+   {
+      std::string NextLevel = Value(levels[i + 1]);
+      std::string NextValue = Value(values[i + 1]);
+      Code += " P = select(P, " + LevelValue + " + (S - " + Level + ") * ((" + NextValue + " - " + LevelValue + ") / (" +
+         NextLevel + " - " + Level + ")), (S >= " + Level + ") & (S < " + NextLevel + "));";
+      Level = NextLevel;
+      LevelValue = NextValue;
+   }
+
+   return Operation(Code + " }");
+}
+
+PointwiseChain& PointwiseChain::Scale(float SrcMin, float SrcMax, float DstMin, float DstMax)
+{
+   float Levels[2] = {SrcMin, SrcMax};
+   float Values[2] = {DstMin, DstMax};
+
+   return LUTLinear(Levels, Values, 2);
+}
+
+
+// Tresholding
+PointwiseChain& PointwiseChain::TresholdGT(float Tresh, float valueHigher)
+{
+   return Operation("P = select(P, (float4) " + Value(valueHigher) + ", P > " + Value(Tresh) + ");");
+}
+
+PointwiseChain& PointwiseChain::TresholdLT(float Tresh, float valueLower)
+{
+   return Operation("P = select(P, (float4) " + Value(valueLower) + ", P < " + Value(Tresh) + ");");
+}
+
+PointwiseChain& PointwiseChain::TresholdGTLT(float threshLT, float valueLower, float treshGT, float valueHigher)
+{
+   std::string Code = "{ const float4 S = P;";
+   Code += " P = select(P, (float4) " + Value(valueLower) + ", S < " + Value(threshLT) + ");";
+   Code += " P = select(P, (float4) " + Value(valueHigher) + ", S > " + Value(treshGT) + "); }";
+   return Operation(Code);
+}
+
+PointwiseChain& PointwiseChain::Compare(float value, Tresholding::ECompareOperation Op)
+{
+   // Vector comparisons give -1 for true
+   return Operation("P = convert_float4(-(P " + std::string(CompareOperator(Op)) + " " + Value(value) + "));");
+}
+
+PointwiseChain& PointwiseChain::Compare(IImage& Image, Tresholding::ECompareOperation Op)
+{
+   return Operation("P = convert_float4(-(P " + std::string(CompareOperator(Op)) + " " + ImageValue(Image) + "));");
+}
+
+
+// Conversions
+PointwiseChain& PointwiseChain::Scale(int Offset, float Ratio)
+{
+   return Operation("P = P * " + Value(Ratio) + " + " + Value(float(Offset)) + ";");
+}
+
+
+// Fusion
+
+Fusion::Fusion(COpenCL& CL)
+:  m_CL(&CL)
+{ }
+
+void Fusion::Run(const PointwiseChain& Chain, IImage& Source, IImage& Dest)
+{
+   const std::vector<IImage *>& Images = Chain.GetImages();
+   const std::vector<float>& ChainValues = Chain.GetValues();
+
+   CheckSameSize(Source, Dest);
+   for (auto it = Images.begin(); it != Images.end(); it++)
+      CheckSameSize(Source, **it);
+
+   if (Chain.UsesLogic())
+      CheckNotFloat(Source);
+
+   Program& FusedProgram = SelectProgram(Chain, Source, Dest);
+
+   // Image slots not used by the chain receive the source image
+   IImage& Image1 = (Images.size() > 0 ? *Images[0] : Source);
+   IImage& Image2 = (Images.size() > 1 ? *Images[1] : Source);
+   IImage& Image3 = (Images.size() > 2 ? *Images[2] : Source);
+
+   cl_float16 Values;
+   for (uint i = 0; i < PointwiseChain::MaxValues; i++)
+      Values.s[i] = (i < ChainValues.size() ? ChainValues[i] : 0);
+
+   Kernel_(*m_CL, FusedProgram, fused, DEFAULT_LOCAL_RANGE, In(Source, Image1, Image2, Image3), Out(Dest), Values);
+}
+
+void Fusion::PrepareFor(const PointwiseChain& Chain, const ImageBase& Source, const ImageBase& Dest)
+{
+   SelectProgram(Chain, Source, Dest).Build();
+}
+
+Program& Fusion::SelectProgram(const PointwiseChain& Chain, const ImageBase& Source, const ImageBase& Dest)
+{
+   std::string Code = GenerateSource(Chain, Source, Dest);
+
+   std::lock_guard<std::mutex> Lock(m_Mutex);
+
+   std::shared_ptr<Program>& FusedProgram = m_Programs[Code];
+   if (FusedProgram == nullptr)
+      FusedProgram = std::make_shared<Program>(*m_CL, true, Code.c_str());
+
+   return *FusedProgram;
+}
+
+std::string Fusion::GenerateSource(const PointwiseChain& Chain, const ImageBase& Source, const ImageBase& Dest)
+{
+   const std::vector<IImage *>& Images = Chain.GetImages();
+
+   std::string Code =
+      "constant sampler_t sampler = CLK_NORMALIZED_COORDS_FALSE | CLK_ADDRESS_CLAMP_TO_EDGE | CLK_FILTER_NEAREST;\n";
+
+   if (Source.IsUnsigned())
+      Code += "#define LOGIC(px) convert_uint4_sat(px)\n#define LOGIC_SCALAR uint\n#define LOGIC_TYPE uint4\n";
+   else
+      Code += "#define LOGIC(px) convert_int4_sat(px)\n#define LOGIC_SCALAR int\n#define LOGIC_TYPE int4\n";
+
+   Code += "#define LOGIC_MASK ((LOGIC_SCALAR) " + LogicMask(Source) + ")\n";
+
+   Code +=
+      "kernel void fused(read_only image2d_t source, read_only image2d_t image1, read_only image2d_t image2,\n"
+      "   read_only image2d_t image3, write_only image2d_t dest, float16 V)\n"
+      "{\n"
+      "   const int gx = get_global_id(0);\n"
+      "   const int gy = get_global_id(1);\n"
+      "   const int2 pos = { gx, gy };\n"
+      "   float4 P = " + ReadPixel(Source, "source") + ";\n";
+
+   // Logic operations work on L, integer pixels read without going through float
+   if (Chain.UsesLogic())
+      Code += "   LOGIC_TYPE L = " + ReadLogicPixel(Source, "source") + ";\n";
+
+   static const char * const ArgNames[] = {"image1", "image2", "image3"};
+   for (size_t i = 0; i < Images.size(); i++)
+   {
+      Code += "   const float4 " + std::string(ImageNames[i]) + " = " + ReadPixel(*Images[i], ArgNames[i]) + ";\n";
+
+      if (Chain.UsesLogic())
+         Code += "   const LOGIC_TYPE L" + std::string(ImageNames[i]) + " = " + ReadLogicPixel(*Images[i], ArgNames[i]) + ";\n";
+   }
+
+   Code += Chain.GetCode();
+   Code += "   " + WritePixel(Dest, Chain.HasLogicResult()) + ";\n}\n";
+
+   return Code;
+}
+
+
+// Helpers
+
+std::string ReadPixel(const ImageBase& Img, const std::string& Name)
+{
+   if (Img.IsFloat())
+      return "read_imagef(" + Name + ", sampler, pos)";
+
+   if (Img.IsUnsigned())
+      return "convert_float4(read_imageui(" + Name + ", sampler, pos))";
+
+   return "convert_float4(read_imagei(" + Name + ", sampler, pos))";
+}
+
+std::string ReadLogicPixel(const ImageBase& Img, const std::string& Name)
+{
+   if (Img.IsFloat())
+      return "LOGIC(read_imagef(" + Name + ", sampler, pos))";
+
+   if (Img.IsUnsigned())
+      return "LOGIC(read_imageui(" + Name + ", sampler, pos))";
+
+   return "LOGIC(read_imagei(" + Name + ", sampler, pos))";
+}
+
+std::string LogicMask(const ImageBase& Img)
+{
+   switch (Img.Depth())
+   {
+   case 8:
+      return "0xFF";
+   case 16:
+      return "0xFFFF";
+   default:
+      return "0xFFFFFFFF";
+   }
+
+}
+
+std::string WritePixel(const ImageBase& Img, bool LogicResult)
+{
+   const char * Pixel = (LogicResult ? "L" : "P");
+
+   if (Img.IsFloat())
+      return "write_imagef(dest, pos, convert_float4(" + std::string(Pixel) + "))";
+
+   if (Img.IsUnsigned())
+      return "write_imageui(dest, pos, convert_uint4_sat(" + std::string(Pixel) + "))";
+
+   return "write_imagei(dest, pos, convert_int4_sat(" + std::string(Pixel) + "))";
+}
+
+const char * CompareOperator(Tresholding::ECompareOperation Op)
+{
+   switch (Op)
+   {
+   case Tresholding::LT:
+      return "<";
+   case Tresholding::LQ:
+      return "<=";
+   case Tresholding::EQ:
+      return "==";
+   case Tresholding::GQ:
+      return ">=";
+   case Tresholding::GT:
+      return ">";
+   default:
+      throw cl::Error(CL_INVALID_VALUE, "unknown compare operation");
+   }
+
+}
+
+}
@@ -31,6 +31,7 @@
 
 
 #define KERNEL_RANGE(src_img) GetRange(src_img), GetLocalRange()
+#define KERNEL_OFFSET(src_img) OpenCLIPP::_NoOffset(src_img)   // Kernels need the whole image
 
 #include "kernel_helpers.h"
 
@@ -87,7 +88,7 @@ void Integral::IntegralScan(IImage& Source, IImage& Dest)
 
    if (GetNbGroupsW(Source) > 1)
    {
-      make_kernel<Image2D, Image2D>(SelectProgram(Dest), "scan2")
+      make_kernel<Image2D, Image2D>(SelectProgram(Dest).GetKernel("scan2"))
          (EnqueueArgs(*m_CL, NDRange(GetNbGroupsW(Source) - 1, Source.Height())), Dest, *m_VerticalJunctions);
    }
 
@@ -98,7 +99,7 @@ void Integral::IntegralScan(IImage& Source, IImage& Dest)
 
    if (GetNbGroupsH(Source) > 1)
    {
-      make_kernel<Image2D, Image2D>(SelectProgram(Dest), "scan4")
+      make_kernel<Image2D, Image2D>(SelectProgram(Dest).GetKernel("scan4"))
          (EnqueueArgs(*m_CL, NDRange(Source.Width(), GetNbGroupsH(Source) - 1)), Dest, *m_HorizontalJunctions);
    }
 
@@ -25,7 +25,7 @@
 #include "Programs/LogicVector.h"
 
 
-#define KERNEL_RANGE(src_img) src_img.VectorRange(8)
+#define KERNEL_RANGE(src_img) src_img.VectorRange(VectorWidth(src_img))
 
 #include "kernel_helpers.h"
 
@@ -43,8 +43,12 @@ void LogicVector::And(ImageBuffer& Source1, ImageBuffer& Source2,
    CheckSimilarity(Source1, Dest);
    CheckNotFloat(Source1);
 
-   Kernel(and_images, In(Source1, Source2), Out(Dest), Source1.Step(),
-      Source2.Step(), Dest.Step(), Source1.Width() * Source1.NbChannels());
+   ImageBuffer& Src1 = Source1.Direct();
+   ImageBuffer& Src2 = Source2.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(and_images, In(Src1, Src2), Out(Dst), Src1.Step(), Src2.Step(), Dst.Step(),
+      Src1.Offset(), Src2.Offset(), Dst.Offset(), Source1.Width() * Source1.NbChannels());
 }
 
 void LogicVector::Or(ImageBuffer& Source1, ImageBuffer& Source2,
@@ -54,8 +58,12 @@ void LogicVector::Or(ImageBuffer& Source1, ImageBuffer& Source2,
    CheckSimilarity(Source1, Dest);
    CheckNotFloat(Source1);
 
-   Kernel(or_images, In(Source1, Source2), Out(Dest), Source1.Step(),
-      Source2.Step(), Dest.Step(), Source1.Width() * Source1.NbChannels());
+   ImageBuffer& Src1 = Source1.Direct();
+   ImageBuffer& Src2 = Source2.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(or_images, In(Src1, Src2), Out(Dst), Src1.Step(), Src2.Step(), Dst.Step(),
+      Src1.Offset(), Src2.Offset(), Dst.Offset(), Source1.Width() * Source1.NbChannels());
 }
 
 void LogicVector::Xor(ImageBuffer& Source1, ImageBuffer& Source2,
@@ -65,8 +73,12 @@ void LogicVector::Xor(ImageBuffer& Source1, ImageBuffer& Source2,
    CheckSimilarity(Source1, Dest);
    CheckNotFloat(Source1);
 
-   Kernel(xor_images, In(Source1, Source2), Out(Dest), Source1.Step(),
-      Source2.Step(), Dest.Step(), Source1.Width() * Source1.NbChannels());
+   ImageBuffer& Src1 = Source1.Direct();
+   ImageBuffer& Src2 = Source2.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(xor_images, In(Src1, Src2), Out(Dst), Src1.Step(), Src2.Step(), Dst.Step(),
+      Src1.Offset(), Src2.Offset(), Dst.Offset(), Source1.Width() * Source1.NbChannels());
 }
 
 void LogicVector::And(ImageBuffer& Source, ImageBuffer& Dest, uint value)
@@ -74,7 +86,10 @@ void LogicVector::And(ImageBuffer& Source, ImageBuffer& Dest, uint value)
    CheckSimilarity(Source, Dest);
    CheckNotFloat(Source);
 
-   Kernel(and_constant, In(Source), Out(Dest), Source.Step(), Dest.Step(),
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(and_constant, In(Src), Out(Dst), Src.Step(), Dst.Step(), Src.Offset(), Dst.Offset(),
       Source.Width() * Source.NbChannels(), value);
 }
 
@@ -83,7 +98,10 @@ void LogicVector::Or(ImageBuffer& Source, ImageBuffer& Dest, uint value)
    CheckSimilarity(Source, Dest);
    CheckNotFloat(Source);
 
-   Kernel(or_constant, In(Source), Out(Dest), Source.Step(), Dest.Step(),
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(or_constant, In(Src), Out(Dst), Src.Step(), Dst.Step(), Src.Offset(), Dst.Offset(),
       Source.Width() * Source.NbChannels(), value);
 }
 
@@ -92,7 +110,10 @@ void LogicVector::Xor(ImageBuffer& Source, ImageBuffer& Dest, uint value)
    CheckSimilarity(Source, Dest);
    CheckNotFloat(Source);
 
-   Kernel(xor_constant, In(Source), Out(Dest), Source.Step(), Dest.Step(),
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(xor_constant, In(Src), Out(Dst), Src.Step(), Dst.Step(), Src.Offset(), Dst.Offset(),
       Source.Width() * Source.NbChannels(), value);
 }
 
@@ -101,7 +122,10 @@ void LogicVector::Not(ImageBuffer& Source, ImageBuffer& Dest)
    CheckSimilarity(Source, Dest);
    CheckNotFloat(Source);
 
-   Kernel(not_image, In(Source), Out(Dest), Source.Step(), Dest.Step(),
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(not_image, In(Src), Out(Dst), Src.Step(), Dst.Step(), Src.Offset(), Dst.Offset(),
       Source.Width() * Source.NbChannels());
 }
 
@@ -24,9 +24,7 @@
 
 #include "Programs/LutVector.h"
 
-#define VEC_WIDTH 4
-
-#define KERNEL_RANGE(src_img) src_img.VectorRange(VEC_WIDTH)
+#define KERNEL_RANGE(src_img) src_img.VectorRange(VectorWidth(src_img))
 
 #include "kernel_helpers.h"
 
@@ -39,7 +37,7 @@ void LutVector::LUT(ImageBuffer& Source, ImageBuffer& Dest, uint * levels, uint
 {
    CheckCompatibility(Source, Dest);
 
-   if (SameType(Source, Dest) && Source.Depth() == 8 && Source.IsUnsigned() && Source.NbChannels() == 1)
+   if (SameType(Source, Dest) && Source.Depth() == 8 && Source.IsUnsigned())
    {
       // Use optimized version
       const static uint Length = 256;
@@ -67,7 +65,10 @@ void LutVector::LUT(ImageBuffer& Source, ImageBuffer& Dest, uint * levels, uint
    ReadBuffer Levels(*m_CL, levels, NbValues);
    ReadBuffer Values(*m_CL, values, NbValues);
 
-   Kernel(LUT, In(Source), Out(Dest), Source.Step(), Dest.Step(),
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(LUT, In(Src), Out(Dst), Src.Step(), Dst.Step(), Src.Offset(), Dst.Offset(),
       Source.Width() * Source.NbChannels(), Levels, Values, NbValues);
 }
 
@@ -78,29 +79,39 @@ void LutVector::LUTLinear(ImageBuffer& Source, ImageBuffer& Dest, float * levels
    ReadBuffer Levels(*m_CL, levels, NbValues);
    ReadBuffer Values(*m_CL, values, NbValues);
 
-   Kernel(lut_linear, In(Source), Out(Dest), Source.Step(), Dest.Step(),
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(lut_linear, In(Src), Out(Dst), Src.Step(), Dst.Step(), Src.Offset(), Dst.Offset(),
       Source.Width() * Source.NbChannels(), Levels, Values, NbValues);
 }
 
 void LutVector::BasicLut(ImageBuffer& Source, ImageBuffer& Dest, unsigned char * values)
 {
-   if (Source.Depth() != 8 || !Source.IsUnsigned() || Source.NbChannels() != 1)
-      throw cl::Error(CL_INVALID_VALUE, "BasicLut can only accept 1 channel unsigned integer images");
+   if (Source.Depth() != 8 || !Source.IsUnsigned())
+      throw cl::Error(CL_INVALID_VALUE, "BasicLut can only accept 8 bit unsigned integer images");
 
    CheckSizeAndType(Source, Dest);
 
    ReadBuffer Values(*m_CL, values, 256);
 
-   if ((Source.Width() * Source.NbChannels() / VEC_WIDTH) % 16 || Source.Height() % 16)
+   if ((Source.Width() * Source.NbChannels()) % (VectorWidth(Source) * 16) || Source.Height() % 16)
    {
       // Standard version
-      Kernel(lut_256, Source, Dest, Source.Step(), Dest.Step(),
+      ImageBuffer& Src = Source.Direct();
+      ImageBuffer& Dst = Dest.Direct();
+
+      Kernel(lut_256, In(Src), Out(Dst), Src.Step(), Dst.Step(), Src.Offset(), Dst.Offset(),
          Source.Width() * Source.NbChannels(), Values);
    }
    else
    {
       // Faster version
-      Kernel_(*m_CL, SelectProgram(Source), lut_256_cached, cl::NDRange(16, 16, 1), Source, Dest, Source.Step(), Dest.Step(), Values)
+      ImageBuffer& Src = Source.Direct();
+      ImageBuffer& Dst = Dest.Direct();
+
+      Kernel_(*m_CL, SelectProgram(Src), lut_256_cached, cl::NDRange(16, 16, 1), In(Src), Out(Dst), Src.Step(), Dst.Step(),
+         Src.Offset(), Dst.Offset(), Values)
    }
 
 }
@@ -25,7 +25,7 @@
 #include "Programs/MorphologyBuffer.h"
 
 
-#define KERNEL_RANGE(src_img) GetRange(src_img, UseLocalRange(Width)), GetLocalRange(UseLocalRange(Width))
+#define KERNEL_RANGE(src_img) ChannelRange(src_img, UseLocalRange(Width)), GetLocalRange(UseLocalRange(Width))
 #define SELECT_NAME(name, src_img) SelectName( #name , Width)
 
 #include "kernel_helpers.h"
@@ -53,6 +53,21 @@ static std::string SelectName(const char * Name, int Width)  // Selects the prop
    return KernelName;
 }
 
+static cl::NDRange ChannelRange(const ImageBase& Img, bool UseLocalSize)  // One worker per channel of each pixel
+{
+   uint Width = Img.Width() * Img.NbChannels();
+   uint Height = Img.Height();
+
+   if (UseLocalSize)
+   {
+      // The cached kernels need a range that is a multiple of the local range
+      Width = (Width + GroupWidth - 1) / GroupWidth * GroupWidth;
+      Height = (Height + GroupHeight - 1) / GroupHeight * GroupHeight;
+   }
+
+   return cl::NDRange(Width, Height, 1);
+}
+
 
 void MorphologyBuffer::Erode(ImageBuffer& Source, ImageBuffer& Dest, int Width)
 {
@@ -64,7 +79,7 @@ void MorphologyBuffer::Erode(ImageBuffer& Source, ImageBuffer& Dest, int Width)
    if (Width < 3 || Width > 63)
       throw cl::Error(CL_INVALID_ARG_VALUE, "Width for morphology operations must >= 3 && <= 63");
 
-   Kernel(erode, Source, Dest, Source.Step(), Dest.Step(), Source.Width(), Source.Height());
+   Kernel(erode, Source, Dest, Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels(), Source.Height(), Source.NbChannels());
 }
 
 void MorphologyBuffer::Dilate(ImageBuffer& Source, ImageBuffer& Dest, int Width)
@@ -77,7 +92,7 @@ void MorphologyBuffer::Dilate(ImageBuffer& Source, ImageBuffer& Dest, int Width)
    if (Width < 3 || Width > 63)
       throw cl::Error(CL_INVALID_ARG_VALUE, "Width for morphology operations must >= 3 && <= 63");
 
-   Kernel(dilate, Source, Dest, Source.Step(), Dest.Step(), Source.Width(), Source.Height());
+   Kernel(dilate, Source, Dest, Source.Step(), Dest.Step(), Source.Width() * Source.NbChannels(), Source.Height(), Source.NbChannels());
 }
 
 void MorphologyBuffer::Erode(ImageBuffer& Source, ImageBuffer& Dest, ImageBuffer& Temp, int Iterations, int Width)
@@ -23,18 +23,34 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "Programs/Program.h"
+#include "../ThreadPool.h"
+#include "../EmbeddedClFiles.h"
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <cstdio>
 
 using namespace std;
 
 namespace OpenCLIPP
 {
 
+// Helpers for the compiled program cache
+static unsigned long long HashString(const string& Str);
+static string ToHex(unsigned long long Value);
+static string BinaryCacheKey(COpenCL& CL, const string& Source, const string& Options);
+static string BinaryCacheFileName(const string& Key);
+static bool LoadBinary(COpenCL& CL, const string& FileName, const string& Key, const string& Options, cl::Program& Program);
+static void SaveBinary(COpenCL& CL, const string& FileName, const string& Key, cl::Program& Program);
+
+// Helper for ImageBufferProgram
+static uint SelectVectorWidth(const SDeviceInfo& Info, SImage::EDataType Type, uint DefaultWidth);
+
 Program::Program(COpenCL& CL, const char * Path, const char * options)
 :  m_CL(&CL),
    m_Path(Path),
    m_Options(options),
+   m_Identifier(m_Path + " " + m_Options),
    m_Built(false)
 { }
 
@@ -42,6 +58,7 @@ Program::Program(COpenCL& CL, bool, const char * Source, const char * options)
 :  m_CL(&CL),
    m_Source(Source),
    m_Options(options),
+   m_Identifier("source " + ToHex(HashString(m_Source)) + " " + m_Options),
    m_Built(false)
 { }
 
@@ -54,6 +71,11 @@ bool Program::Build()
    if (m_Built)
       return true;
 
+   lock_guard<mutex> Lock(m_BuildMutex);
+
+   if (m_Built)
+      return true;   // Was built by another thread while we were waiting
+
    string Path, Source = m_Source;
 
    if (Source == "")
@@ -62,20 +84,39 @@ bool Program::Build()
          return false;
 
       Path = m_CL->GetClFilePath() + m_Path;
-
-      Source = LoadClFile(Path);
+      Source = LoadClSource(m_Path);
    }
 
-   m_Program = cl::Program(*m_CL, Source, false);
+   // Shared headers are included in the source given to OpenCL, so embedded sources can use them too
+   Source = ExpandIncludes(Source);
 
    string optionStr = m_Options;
-      
+
+   bool Debugging = false;
    if (m_Path != "" && m_CL->IsOnIntelCPU() && IsDebuggerPresent())
    {
       // Add debug information for Intel OpenCL SDK Debugger
       optionStr += " -g -s \"" + Path + "\"";
+      Debugging = true;
    }
 
+   string CacheFile;
+   string CacheKey;
+   if (COpenCL::GetBinaryCachePath() != "" && !Debugging)
+   {
+      CacheKey = BinaryCacheKey(*m_CL, Source, optionStr);
+      CacheFile = COpenCL::GetBinaryCachePath() + BinaryCacheFileName(CacheKey);
+
+      if (LoadBinary(*m_CL, CacheFile, CacheKey, optionStr, m_Program))
+      {
+         m_Built = true;
+         return true;
+      }
+
+   }
+
+   m_Program = cl::Program(*m_CL, Source, false);
+
    // Try to build
    try
    {
@@ -96,9 +137,68 @@ bool Program::Build()
       throw error;   // Rethrow
    }
 
+   if (CacheFile != "")
+      SaveBinary(*m_CL, CacheFile, CacheKey, m_Program);
+
    return true;
 }
 
+cl::Kernel& Program::GetKernel(const std::string& Name)
+{
+   // The arguments are set on the kernel right before it is enqueued,
+   // so kernels are not shared between threads
+   KernelKey Key(this_thread::get_id(), Name);
+
+   {
+      lock_guard<mutex> Lock(m_KernelsMutex);
+
+      auto it = m_Kernels.find(Key);
+      if (it != m_Kernels.end())
+         return it->second;
+   }
+
+   Build();
+
+   cl::Kernel kernel(m_Program, Name.c_str());
+
+   lock_guard<mutex> Lock(m_KernelsMutex);
+   return m_Kernels.insert(make_pair(Key, kernel)).first->second;
+}
+
+std::string Program::LoadClSource(const std::string& Name)
+{
+   const char * Embedded = nullptr;
+   if (!COpenCL::GetUseClFiles())
+      Embedded = GetEmbeddedClFile(Name.c_str());
+
+   if (Embedded != nullptr)
+      return Embedded;
+
+   return LoadClFile(COpenCL::GetClFilePath() + Name);
+}
+
+std::string Program::ExpandIncludes(const std::string& Source)
+{
+   const string Directive = "#include \"";
+
+   string Expanded;
+   istringstream Lines(Source);
+   string Line;
+   while (getline(Lines, Line))
+   {
+      size_t End = Line.find('"', Directive.size());
+      if (Line.compare(0, Directive.size(), Directive) != 0 || End == string::npos)
+      {
+         Expanded += Line + "\n";
+         continue;
+      }
+
+      Expanded += ExpandIncludes(LoadClSource(Line.substr(Directive.size(), End - Directive.size())));
+   }
+
+   return Expanded;
+}
+
 std::string Program::LoadClFile(const std::string& Path)
 {
    ifstream file(Path);
@@ -112,6 +212,126 @@ std::string Program::LoadClFile(const std::string& Path)
 }
 
 
+// Compiled program cache
+
+// 64 bit FNV-1a hash - used because it gives the same result on all platforms and runs
+unsigned long long HashString(const string& Str)
+{
+   unsigned long long Hash = 14695981039346656037ULL;
+   for (char c : Str)
+   {
+      Hash ^= (unsigned char) c;
+      Hash *= 1099511628211ULL;
+   }
+
+   return Hash;
+}
+
+string ToHex(unsigned long long Value)
+{
+   const char * Digits = "0123456789abcdef";
+   string Hex(16, '0');
+   for (int i = 15; i >= 0; i--, Value >>= 4)
+      Hex[i] = Digits[Value & 0xF];
+
+   return Hex;
+}
+
+string BinaryCacheKey(COpenCL& CL, const string& Source, const string& Options)
+{
+   // The binary is valid only for the same device, driver, source and compiler options
+   const SDeviceInfo& Device = CL.GetDeviceInfo();
+
+   string Key = "OpenCLIPP program cache 1\n";
+   Key += Device.DeviceName + "\n";
+   Key += Device.DeviceVersion + "\n";
+   Key += Device.DriverVersion + "\n";
+   Key += Options + "\n";
+   Key += ToHex(HashString(Source)) + "\n";
+
+   return Key;
+}
+
+string BinaryCacheFileName(const string& Key)
+{
+   return ToHex(HashString(Key)) + ".clbin";
+}
+
+// Cache file format : Key, followed by a null character, followed by the program binary
+bool LoadBinary(COpenCL& CL, const string& FileName, const string& Key, const string& Options, cl::Program& Program)
+{
+   ifstream file(FileName, ios::binary);
+   if (!file.is_open())
+      return false;
+
+   string content((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+   if (content.size() <= Key.size() || content.compare(0, Key.size(), Key) != 0 || content[Key.size()] != '\0')
+      return false;   // Not the same program (hash collision) or invalid file
+
+   size_t Offset = Key.size() + 1;
+   if (Offset >= content.size())
+      return false;
+
+   cl::Program::Binaries Binaries(1, make_pair((const void *) &content[Offset], content.size() - Offset));
+   vector<cl::Device> Devices(1, (cl::Device&) CL);
+
+   try
+   {
+      Program = cl::Program(CL, Devices, Binaries);
+      Program.build(Devices, Options.c_str());
+   }
+   catch (const cl::Error&)
+   {
+      // Binary is not accepted by the driver - the program will be built from source
+      return false;
+   }
+
+   return true;
+}
+
+void SaveBinary(COpenCL& CL, const string& FileName, const string& Key, cl::Program& Program)
+{
+   try
+   {
+      // Find the binary for our device
+      vector<cl::Device> Devices = Program.getInfo<CL_PROGRAM_DEVICES>();
+      vector<size_t> Sizes = Program.getInfo<CL_PROGRAM_BINARY_SIZES>();
+      vector<char *> Binaries = Program.getInfo<CL_PROGRAM_BINARIES>();
+
+      cl_device_id Device = CL;
+      for (size_t i = 0; i < Devices.size() && i < Binaries.size(); i++)
+         if (Devices[i]() == Device && Binaries[i] != nullptr && Sizes[i] > 0)
+         {
+            // Write to a temporary file first so other processes never see a partial file
+            string TempName = FileName + ".tmp";
+            {
+               ofstream file(TempName, ios::binary | ios::trunc);
+               if (file.is_open())
+               {
+                  file.write(Key.c_str(), Key.size() + 1);
+                  file.write(Binaries[i], Sizes[i]);
+               }
+
+            }
+
+            if (rename(TempName.c_str(), FileName.c_str()) != 0)
+               remove(TempName.c_str());
+
+            break;
+         }
+
+      for (char * Binary : Binaries)
+         delete [] Binary;
+   }
+   catch (const cl::Error&)
+   {
+      // Not being able to save the binary is not an error, the program will simply be built again next time
+   }
+
+}
+
+
 // MultiProgram
 MultiProgram::MultiProgram(COpenCL& CL)
 :  m_CL(&CL)
@@ -152,6 +372,29 @@ void MultiProgram::PrepareProgram(uint Id)
    m_Programs[Id]->Build();
 }
 
+shared_future<void> MultiProgram::PrepareProgramAsync(uint Id)
+{
+   assert(Id < m_Programs.size());
+
+   // The task keeps the program alive even if this object is destroyed before the build is done
+   ProgramPtr Ptr = m_Programs[Id];
+   return m_CL->GetBuildThreads().Run([Ptr] { Ptr->Build(); });
+}
+
+shared_future<void> MultiProgram::PrepareAllAsync()
+{
+   auto Futures = make_shared<vector<shared_future<void>>>();
+   for (uint i = 0; i < m_Programs.size(); i++)
+      Futures->push_back(PrepareProgramAsync(i));
+
+   // Deferred : waiting on the result waits on each version, without using a worker thread
+   return async(launch::deferred, [Futures]
+      {
+         for (auto& Future : *Futures)
+            Future.get();
+      }).share();
+}
+
 
 // ImageProgram
 ImageProgram::ImageProgram(COpenCL& CL, const char * Path)
@@ -173,33 +416,65 @@ void ImageProgram::PrepareFor(ImageBase& Source)
    SelectProgram(Source).Build();
 }
 
+shared_future<void> ImageProgram::PrepareForAsync(ImageBase& Source)
+{
+   return PrepareProgramAsync(SelectId(Source));
+}
+
 Program& ImageProgram::SelectProgram(ImageBase& Source)
+{
+   return GetProgram(SelectId(Source));
+}
+
+uint ImageProgram::SelectId(const ImageBase& Source)
 {
    if (Source.IsFloat())
-      return GetProgram(Float);
+      return Float;
 
    if (Source.IsUnsigned())
-      return GetProgram(Unsigned);
+      return Unsigned;
 
-   return GetProgram(Signed);
+   return Signed;
 }
 
 
 // ImageBufferProgram
-ImageBufferProgram::ImageBufferProgram(COpenCL& CL, const char * Path)
+ImageBufferProgram::ImageBufferProgram(COpenCL& CL, const char * Path, uint DefaultVectorWidth)
 :  MultiProgram(CL)
 {
-   const char * Defines[NbPixelTypes] = {"U8", "S8", "U16", "S16", "U32", "S32", "F32"};    // Keep in synch with EPixelTypes
-
-   SetProgramInfo(Path, NbPixelTypes, Defines);
+   Init("", Path, DefaultVectorWidth);
 }
 
-ImageBufferProgram::ImageBufferProgram(COpenCL& CL, bool fromSource, const char * Source)
+ImageBufferProgram::ImageBufferProgram(COpenCL& CL, bool, const char * Source, uint DefaultVectorWidth)
 :  MultiProgram(CL)
 {
-   const char * Defines[NbPixelTypes] = {"U8", "S8", "U16", "S16", "U32", "S32", "F32"};    // Keep in synch with EPixelTypes
+   Init(Source, "", DefaultVectorWidth);
+}
 
-   SetProgramInfo(fromSource, Source, NbPixelTypes, Defines);
+void ImageBufferProgram::Init(const char * Source, const char * Path, uint DefaultVectorWidth)
+{
+   const char * Types[NbPixelTypes] = {"U8", "S8", "U16", "S16", "U32", "S32", "F32", "F16"};    // Keep in synch with EPixelTypes
+
+   string DefineStrings[NbPixelTypes];
+   const char * Defines[NbPixelTypes];
+
+   for (int i = 0; i < NbPixelTypes; i++)
+   {
+      DefineStrings[i] = Types[i];
+      m_VectorWidths[i] = 1;
+
+      if (DefaultVectorWidth > 0)
+      {
+         m_VectorWidths[i] = SelectVectorWidth(m_CL->GetDeviceInfo(), SImage::EDataType(i), DefaultVectorWidth);
+         ostringstream Define;
+         Define << Types[i] << " -D VEC_WIDTH=" << m_VectorWidths[i];
+         DefineStrings[i] = Define.str();
+      }
+
+      Defines[i] = DefineStrings[i].c_str();
+   }
+
+   SetProgramInfo(string(Source) != "", Source, NbPixelTypes, Defines, Path);
 }
 
 void ImageBufferProgram::PrepareFor(ImageBase& Source)
@@ -207,12 +482,27 @@ void ImageBufferProgram::PrepareFor(ImageBase& Source)
    SelectProgram(Source).Build();
 }
 
+shared_future<void> ImageBufferProgram::PrepareForAsync(ImageBase& Source)
+{
+   return PrepareProgramAsync(SelectId(Source));
+}
+
 Program& ImageBufferProgram::SelectProgram(ImageBase& Source)
+{
+   return GetProgram(SelectId(Source));
+}
+
+uint ImageBufferProgram::SelectId(const ImageBase& Source)
 {
    if (Source.DataType() < 0 || Source.DataType() >= NbPixelTypes)
       throw cl::Error(CL_IMAGE_FORMAT_NOT_SUPPORTED, "unsupported image format used with ImageBufferProgram");
 
-   return GetProgram(Source.DataType());
+   return Source.DataType();
+}
+
+uint ImageBufferProgram::VectorWidth(const ImageBase& Source)
+{
+   return m_VectorWidths[SelectId(Source)];
 }
 
 
@@ -274,4 +564,42 @@ void CheckNotFloat(const ImageBase& Img)
       throw cl::Error(CL_INVALID_VALUE, "float image used when not allowed");
 }
 
+
+// Vector width selection
+uint SelectVectorWidth(const SDeviceInfo& Info, SImage::EDataType Type, uint DefaultWidth)
+{
+   cl_uint Preferred = 1;
+   switch (Type)
+   {
+   case SImage::U8:
+   case SImage::S8:
+      Preferred = Info.PreferredVectorWidthChar;
+      break;
+   case SImage::U16:
+   case SImage::S16:
+      Preferred = Info.PreferredVectorWidthShort;
+      break;
+   case SImage::U32:
+   case SImage::S32:
+      Preferred = Info.PreferredVectorWidthInt;
+      break;
+   case SImage::F32:
+   case SImage::F16:   // Stored as half but computed as float
+   default:
+      Preferred = Info.PreferredVectorWidthFloat;
+      break;
+   }
+
+   // Scalar architectures (most GPUs) report 1, use the width the program was tuned with
+   if (Preferred <= 1)
+      return DefaultWidth;
+
+   // OpenCL C vector types have 2, 4, 8 or 16 elements
+   uint Width = 2;
+   while (Width < 16 && Width * 2 <= Preferred)
+      Width *= 2;
+
+   return Width;
+}
+
 }
@@ -26,6 +26,7 @@
 
 
 #define KERNEL_RANGE(src_img) GetRange(src_img), GetLocalRange()
+#define KERNEL_OFFSET(src_img) OpenCLIPP::_NoOffset(src_img)   // Kernels need the whole image
 #define SELECT_NAME(name, src_img) SelectName( #name , src_img)
 
 #include "kernel_helpers.h"
@@ -65,7 +66,7 @@ void Statistics::Init(IImage& Source)
 {
    Source.SendIfNeeded();
 
-   cl::make_kernel<cl::Image2D, cl::Buffer>(SelectProgram(Source), "init")
+   cl::make_kernel<cl::Image2D, cl::Buffer>(SelectProgram(Source).GetKernel("init"))
       (cl::EnqueueArgs(*m_CL, cl::NDRange(1)), Source, m_ResultBuffer);
 }
 
@@ -73,7 +74,7 @@ void Statistics::InitAbs(IImage& Source)
 {
    Source.SendIfNeeded();
 
-   cl::make_kernel<cl::Image2D, cl::Buffer>(SelectProgram(Source), "init_abs")
+   cl::make_kernel<cl::Image2D, cl::Buffer>(SelectProgram(Source).GetKernel("init_abs"))
       (cl::EnqueueArgs(*m_CL, cl::NDRange(1)), Source, m_ResultBuffer);
 }
 
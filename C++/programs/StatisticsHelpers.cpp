@@ -36,6 +36,8 @@
 
 #include "StatisticsHelpers.h"
 
+#include <algorithm>
+
 namespace OpenCLIPP
 {
 
@@ -86,4 +88,20 @@ double ReduceMean(std::vector<float>& buffer)
    return MeanSum / Divisor;  // Divide the sum to get the final mean
 }
 
+std::vector<double> ReduceBatch(std::vector<float>& buffer, uint NbImages, double (*Reduce)(std::vector<float>&))
+{
+   size_t size = buffer.size() / 2 / NbImages;   // Number of work groups per image
+
+   std::vector<double> Results(NbImages);
+   std::vector<float> ImageValues(size * 2);
+   for (uint i = 0; i < NbImages; i++)
+   {
+      std::copy(buffer.begin() + i * size, buffer.begin() + (i + 1) * size, ImageValues.begin());
+      std::copy(buffer.begin() + (NbImages + i) * size, buffer.begin() + (NbImages + i + 1) * size, ImageValues.begin() + size);
+      Results[i] = Reduce(ImageValues);
+   }
+
+   return Results;
+}
+
 }
@@ -51,4 +51,8 @@ std::string SelectName(const char * name, const ImageBase& Image);    // Selects
 double ReduceSum(std::vector<float>& buffer);
 double ReduceMean(std::vector<float>& buffer);
 
+// Final reduction of each image of a batch
+// buffer contains the values of all images followed by the number of pixels of all images
+std::vector<double> ReduceBatch(std::vector<float>& buffer, uint NbImages, double (*Reduce)(std::vector<float>&));
+
 }
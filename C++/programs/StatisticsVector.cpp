@@ -38,10 +38,33 @@ using namespace std;
 namespace OpenCLIPP
 {
 
+// One image of a batch - the work groups are computed for each image and the third dimension of the range is the image
+class BatchImage : public ImageBase
+{
+public:
+   BatchImage(const ImageBufferBatch& Batch)
+   :  ImageBase((const SImage&) Batch)
+   {
+      m_Img.Height = Batch.ImageHeight();
+   }
+};
+
+static cl::NDRange GetRange(const ImageBufferBatch& Batch)
+{
+   BatchImage Image(Batch);
+   return cl::NDRange(GetNbWorkersW(Image), GetNbWorkersH(Image), Batch.NbImages());
+}
+
+static std::string SelectName(const char * name, const ImageBufferBatch& Batch)
+{
+   return SelectName(name, BatchImage(Batch));
+}
+
+
 // Statistics
-void StatisticsVector::PrepareBuffer(const ImageBase& Image)
+void StatisticsVector::PrepareBuffer(const ImageBase& Image, uint NbImages)
 {
-   size_t NbGroups = (size_t) GetNbGroups(Image);
+   size_t NbGroups = (size_t) GetNbGroups(Image) * NbImages;
 
    // We need twice the size to be able to store the number of pixels per group
    size_t BufferSize = NbGroups * 2;
@@ -64,7 +87,7 @@ void StatisticsVector::Init(ImageBuffer& Source)
 {
    Source.SendIfNeeded();
 
-   cl::make_kernel<cl::Buffer, cl::Buffer>(SelectProgram(Source), "init")
+   cl::make_kernel<cl::Buffer, cl::Buffer>(SelectProgram(Source).GetKernel("init"))
       (cl::EnqueueArgs(*m_CL, cl::NDRange(1)), Source, m_ResultBuffer);
 }
 
@@ -72,11 +95,39 @@ void StatisticsVector::InitAbs(ImageBuffer& Source)
 {
    Source.SendIfNeeded();
 
-   cl::make_kernel<cl::Buffer, cl::Buffer>(SelectProgram(Source), "init_abs")
+   cl::make_kernel<cl::Buffer, cl::Buffer>(SelectProgram(Source).GetKernel("init_abs"))
       (cl::EnqueueArgs(*m_CL, cl::NDRange(1)), Source, m_ResultBuffer);
 }
 
 
+void StatisticsVector::Init(ImageBufferBatch& Source)
+{
+   InitBatch(Source, "init_batch");
+}
+
+void StatisticsVector::InitAbs(ImageBufferBatch& Source)
+{
+   InitBatch(Source, "init_abs_batch");
+}
+
+void StatisticsVector::InitBatch(ImageBufferBatch& Source, const char * Name)
+{
+   Source.SendIfNeeded();
+
+   size_t NbImages = Source.NbImages();
+   if (m_BatchResultBuffer == nullptr || m_BatchResult.size() != NbImages)
+   {
+      m_BatchResult.assign(NbImages, 0);
+
+      m_BatchResultBuffer.reset();
+      m_BatchResultBuffer = make_shared<Buffer>(*m_CL, m_BatchResult.data(), NbImages);
+   }
+
+   cl::make_kernel<cl::Buffer, cl::Buffer, int>(SelectProgram(Source).GetKernel(Name))
+      (cl::EnqueueArgs(*m_CL, cl::NDRange(NbImages)), Source, *m_BatchResultBuffer, Source.Step() * Source.ImageHeight());
+}
+
+
 // Reductions
 double StatisticsVector::Min(ImageBuffer& Source)
 {
@@ -166,4 +217,96 @@ double StatisticsVector::MeanSqr(ImageBuffer& Source)
    return ReduceMean(m_PartialResult);
 }
 
+
+// Reductions of batches
+vector<double> StatisticsVector::Min(ImageBufferBatch& Source)
+{
+   Init(Source);
+
+   Kernel(reduce_min, In(Source), Out(*m_BatchResultBuffer), Source.Step(), Source.Width(), Source.ImageHeight());
+
+   m_BatchResultBuffer->Read(true);
+
+   return vector<double>(m_BatchResult.begin(), m_BatchResult.end());
+}
+
+vector<double> StatisticsVector::Max(ImageBufferBatch& Source)
+{
+   Init(Source);
+
+   Kernel(reduce_max, In(Source), Out(*m_BatchResultBuffer), Source.Step(), Source.Width(), Source.ImageHeight());
+
+   m_BatchResultBuffer->Read(true);
+
+   return vector<double>(m_BatchResult.begin(), m_BatchResult.end());
+}
+
+vector<double> StatisticsVector::MinAbs(ImageBufferBatch& Source)
+{
+   InitAbs(Source);
+
+   Kernel(reduce_minabs, In(Source), Out(*m_BatchResultBuffer), Source.Step(), Source.Width(), Source.ImageHeight());
+
+   m_BatchResultBuffer->Read(true);
+
+   return vector<double>(m_BatchResult.begin(), m_BatchResult.end());
+}
+
+vector<double> StatisticsVector::MaxAbs(ImageBufferBatch& Source)
+{
+   InitAbs(Source);
+
+   Kernel(reduce_maxabs, In(Source), Out(*m_BatchResultBuffer), Source.Step(), Source.Width(), Source.ImageHeight());
+
+   m_BatchResultBuffer->Read(true);
+
+   return vector<double>(m_BatchResult.begin(), m_BatchResult.end());
+}
+
+vector<double> StatisticsVector::Sum(ImageBufferBatch& Source)
+{
+   PrepareBuffer(BatchImage(Source), Source.NbImages());
+
+   Kernel(reduce_sum, In(Source), Out(*m_PartialResultBuffer), Source.Step(), Source.Width(), Source.ImageHeight());
+
+   m_PartialResultBuffer->Read(true);
+
+   return ReduceBatch(m_PartialResult, Source.NbImages(), ReduceSum);
+}
+
+vector<uint> StatisticsVector::CountNonZero(ImageBufferBatch& Source)
+{
+   PrepareBuffer(BatchImage(Source), Source.NbImages());
+
+   Kernel(reduce_count_nz, In(Source), Out(*m_PartialResultBuffer), Source.Step(), Source.Width(), Source.ImageHeight());
+
+   m_PartialResultBuffer->Read(true);
+
+   vector<double> Counts = ReduceBatch(m_PartialResult, Source.NbImages(), ReduceSum);
+
+   return vector<uint>(Counts.begin(), Counts.end());
+}
+
+vector<double> StatisticsVector::Mean(ImageBufferBatch& Source)
+{
+   PrepareBuffer(BatchImage(Source), Source.NbImages());
+
+   Kernel(reduce_mean, In(Source), Out(*m_PartialResultBuffer), Source.Step(), Source.Width(), Source.ImageHeight());
+
+   m_PartialResultBuffer->Read(true);
+
+   return ReduceBatch(m_PartialResult, Source.NbImages(), ReduceMean);
+}
+
+vector<double> StatisticsVector::MeanSqr(ImageBufferBatch& Source)
+{
+   PrepareBuffer(BatchImage(Source), Source.NbImages());
+
+   Kernel(reduce_mean_sqr, In(Source), Out(*m_PartialResultBuffer), Source.Step(), Source.Width(), Source.ImageHeight());
+
+   m_PartialResultBuffer->Read(true);
+
+   return ReduceBatch(m_PartialResult, Source.NbImages(), ReduceMean);
+}
+
 }
@@ -24,6 +24,8 @@
 
 #include "Programs/Transform.h"
 
+#define KERNEL_OFFSET(src_img) OpenCLIPP::_NoOffset(src_img)   // Kernels need the whole image
+
 #include "kernel_helpers.h"
 
 #ifdef max
@@ -92,13 +94,13 @@ void Transform::Resize(IImage& Source, IImage& Dest, bool LinearInterpolation, b
       Range = cl::NDRange(size_t(Source.Width() / RatioX), size_t(Source.Height() / RatioY));
    }
 
-   auto kernel = cl::make_kernel<cl::Image2D, cl::Image2D, float, float>(SelectProgram(Source), name);
+   auto kernel = cl::make_kernel<cl::Image2D, cl::Image2D, float, float>(SelectProgram(Source).GetKernel(name));
    kernel(cl::EnqueueArgs(*m_CL, Range), Source, Dest, RatioX, RatioY);
 }
 
 void Transform::SetAll(IImage& Dest, float Value)
 {
-   auto kernel = cl::make_kernel<cl::Image2D, float>(SelectProgram(Dest), "set_all");
+   auto kernel = cl::make_kernel<cl::Image2D, float>(SelectProgram(Dest).GetKernel("set_all"));
    kernel(cl::EnqueueArgs(*m_CL, Dest.FullRange()), Dest, Value);
 }
 
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: TresholdingVector.cpp
+//! @date   : Oct 2026
+//!
+//! @brief  : Tresholding operations on image buffers
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Programs/TresholdingVector.h"
+
+
+#define KERNEL_RANGE(src_img) src_img.VectorRange(VectorWidth(src_img))
+
+#include "kernel_helpers.h"
+
+namespace OpenCLIPP
+{
+
+void TresholdingVector::TresholdGT(ImageBuffer& Source, ImageBuffer& Dest, float Tresh, float valueHigher)
+{
+   CheckSimilarity(Source, Dest);
+
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(tresholdGT, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels(), Tresh, valueHigher);
+}
+
+void TresholdingVector::TresholdLT(ImageBuffer& Source, ImageBuffer& Dest, float Tresh, float valueLower)
+{
+   CheckSimilarity(Source, Dest);
+
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(tresholdLT, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels(), Tresh, valueLower);
+}
+
+void TresholdingVector::TresholdGTLT(ImageBuffer& Source, ImageBuffer& Dest, float threshLT, float valueLower, float treshGT, float valueHigher)
+{
+   CheckSimilarity(Source, Dest);
+
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(tresholdGTLT, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels(),
+      threshLT, valueLower, treshGT, valueHigher);
+}
+
+#undef SELECT_NAME
+#define SELECT_NAME(name, src_img) SelectName( #name , Op)
+
+std::string SelectName(const char * name, Tresholding::ECompareOperation Op);   // Defined in Tresholding.cpp
+
+void TresholdingVector::treshold(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuffer& Dest, ECompareOperation Op)
+{
+   CheckSimilarity(Source1, Source2);
+   CheckSimilarity(Source1, Dest);
+
+   ImageBuffer& Src1 = Source1.Direct();
+   ImageBuffer& Src2 = Source2.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(img_tresh, In(Src1, Src2), Out(Dst), Src1.Step(), Src2.Step(), Dst.Step(),
+      Src1.Offset(), Src2.Offset(), Dst.Offset(), Source1.Width() * Source1.NbChannels());
+}
+
+void TresholdingVector::Compare(ImageBuffer& Source, ImageBuffer& Dest, float Value, ECompareOperation Op)
+{
+   CheckSimilarity(Source, Dest);
+
+   ImageBuffer& Src = Source.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(compare, In(Src), Out(Dst), Src.Step(), Dst.Step(),
+      Src.Offset(), Dst.Offset(), Source.Width() * Source.NbChannels(), Value);
+}
+
+void TresholdingVector::Compare(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuffer& Dest, ECompareOperation Op)
+{
+   CheckSimilarity(Source1, Source2);
+   CheckSimilarity(Source1, Dest);
+
+   ImageBuffer& Src1 = Source1.Direct();
+   ImageBuffer& Src2 = Source2.Direct();
+   ImageBuffer& Dst = Dest.Direct();
+
+   Kernel(img_compare, In(Src1, Src2), Out(Dst), Src1.Step(), Src2.Step(), Dst.Step(),
+      Src1.Offset(), Src2.Offset(), Dst.Offset(), Source1.Width() * Source1.NbChannels());
+}
+
+}
@@ -36,6 +36,30 @@
       SendIfNeeded() on the sources to send them automatically to the device
       SetInDevice() on the destinations to mark them as containing useful data
 
+   The kernel waits for the operations it depends on : the last write to each source and destination
+   and the pending reads of each destination (see Memory::AddReadDependencies()).
+   Its event is then recorded on the sources (as a read) and on the destinations (as a write).
+   When profiling is enabled (see COpenCL::EnableProfiling()), the event is also recorded with the
+   kernel name and the size of the first source.
+
+   When work-group tuning is enabled (see COpenCL::EnableWorkGroupTuning()), the local range of kernels
+   called without a specific local range is selected by the work-group tuner and the event of the
+   launch is given back to the tuner so it can time it.
+
+   While the OpenCL object is recording (see COpenCL::BeginRecording()), the launch is also added
+   to the graph being recorded, with its arguments and ranges, so it can be replayed by OperationGraph::Launch().
+   Define NO_GRAPH_RECORDING before including this file for kernels that must not be recorded.
+
+   When the first source is a view of an image (see ImageView), the kernel is launched with a global offset
+   equal to the origin of the view, so it processes only the region and writes directly in the parent images.
+   All the images given to the kernel must then have the same origin.
+   Define KERNEL_OFFSET(src_img) as OpenCLIPP::_NoOffset(src_img) before including this file
+   for kernels that don't use the global id as the pixel position, so that views are refused.
+
+   The kernel object is taken from the kernel cache of the program (see Program::GetKernel()),
+   so it is created only on the first call of each thread and re-used by the following calls of that thread.
+   Define NO_KERNEL_CACHE before including this file to create a new kernel object on every call instead.
+
    The kernel is enqueued in the the command queue of the OpenCL object.
    This means execution is not done immediately, it will be done when the GPU is available and in parallel with execution of the rest of the host program.
    The macro does not transfer the outputs to the host, they stay in the device.
@@ -62,6 +86,8 @@
 */
 
 #include "../preprocessor.h"
+#include "WorkGroupTuner.h"
+#include "OperationGraph.h"
 
 namespace OpenCLIPP
 {
@@ -87,12 +113,15 @@ SET_CL_TYPE(IImage,      cl::Image2D)
 SET_CL_TYPE(TempImage,   cl::Image2D)
 SET_CL_TYPE(Image,       cl::Image2D)
 SET_CL_TYPE(ColorImage,  cl::Image2D)
+SET_CL_TYPE(ImageView,   cl::Image2D)
 SET_CL_TYPE(IBuffer,     cl::Buffer)
 SET_CL_TYPE(Buffer,      cl::Buffer)
 SET_CL_TYPE(ReadBuffer,  cl::Buffer)
 SET_CL_TYPE(TempBuffer,  cl::Buffer)
 SET_CL_TYPE(ImageBuffer, cl::Buffer)
 SET_CL_TYPE(TempImageBuffer, cl::Buffer)
+SET_CL_TYPE(ImageBufferView, cl::Buffer)
+SET_CL_TYPE(ImageBufferBatch, cl::Buffer)
 
 
 #define CL_TYPE(arg) SelectClType<decltype(arg)>::Type
@@ -111,6 +140,10 @@ SET_CL_TYPE(TempImageBuffer, cl::Buffer)
 #define KERNEL_RANGE(src_img) src_img.FullRange()
 #endif   // SELECT_NAME
 
+#ifndef KERNEL_OFFSET
+#define KERNEL_OFFSET(src_img) OpenCLIPP::_KernelOffset(src_img)
+#endif   // KERNEL_OFFSET
+
 
 // In and Out macros are used to mark the input and output of the kernels
 // At least 1 input is needed, output may be empty : Out()
@@ -128,17 +161,140 @@ SET_CL_TYPE(TempImageBuffer, cl::Buffer)
 
 // Helpers
 #define _SEND_IF_NEEDED(img) (img).SendIfNeeded();
-#define _SET_IN_DEVICE(img) (img).SetInDevice();
+#define _SET_IN_DEVICE(img) (img).SetInDevice(); (img).SetWriteEvent(_kernel_event, _kernel_queue);
+#define _READ_DEPENDENCIES(img) (img).AddReadDependencies(_kernel_wait_list, _kernel_queue);
+#define _WRITE_DEPENDENCIES(img) (img).AddWriteDependencies(_kernel_wait_list, _kernel_queue);
+#define _SET_READ_EVENT(img) (img).SetReadEvent(_kernel_event, _kernel_queue);
 #define _FIRST_IN(in, ...) REMOVE_PAREN(SELECT_FIRST, (in))
+#define _CHECK_OFFSET(img) OpenCLIPP::_CheckOffset(img, _kernel_offset);
+#define _RECORD_IN(arg) _kernel_graph.AddArg(OpenCLIPP::_ClArg<CL_TYPE(arg)>(arg), OpenCLIPP::_MemoryOf(arg), OpenCLIPP::OperationGraph::Input);
+#define _RECORD_OUT(arg) _kernel_graph.AddArg(OpenCLIPP::_ClArg<CL_TYPE(arg)>(arg), OpenCLIPP::_MemoryOf(arg), OpenCLIPP::OperationGraph::Output);
+#define _RECORD_ARG(arg) _kernel_graph.AddArg(OpenCLIPP::_ClArg<CL_TYPE(arg)>(arg), OpenCLIPP::_MemoryOf(arg), OpenCLIPP::OperationGraph::Value);
+
+#ifdef NO_GRAPH_RECORDING
+#define _GRAPH_RECORDING false
+#else
+#define _GRAPH_RECORDING true
+#endif   // NO_GRAPH_RECORDING
+
+#ifdef NO_KERNEL_CACHE
+#define _SELECT_KERNEL(program, name) cl::Kernel((cl::Program&) (program), std::string(name).c_str())
+#else
+#define _SELECT_KERNEL(program, name) (program).GetKernel(name)
+#endif   // NO_KERNEL_CACHE
+
+// Global offset of a kernel that works on an image - the origin of the image (non zero for views)
+template<class T>
+inline typename std::enable_if<std::is_base_of<IImage, T>::value, cl::NDRange>::type _KernelOffset(const T& Img)
+{
+   SPoint Origin = Img.Origin();
+   if (Origin.X == 0 && Origin.Y == 0)
+      return cl::NullRange;
+
+   return cl::NDRange(Origin.X, Origin.Y, 0);
+}
+
+// Global offset of a kernel that works on a buffer - always none
+template<class T>
+inline typename std::enable_if<!std::is_base_of<IImage, T>::value, cl::NDRange>::type _KernelOffset(const T&)
+{
+   return cl::NullRange;
+}
+
+// Global offset of a kernel that does not support views - throws if the image is a view
+template<class T>
+inline cl::NDRange _NoOffset(const T& Img)
+{
+   cl::NDRange Offset = _KernelOffset(Img);
+   if (Offset.dimensions() != 0)
+      throw cl::Error(CL_INVALID_VALUE, "this primitive does not accept image views");
+
+   return Offset;
+}
+
+// Checks that an image given to a kernel has the origin used as global offset
+template<class T>
+inline typename std::enable_if<std::is_base_of<IImage, T>::value>::type _CheckOffset(const T& Img, const cl::NDRange& Offset)
+{
+   SPoint Origin = Img.Origin();
+   const ::size_t * Position = Offset;
+   bool HasOffset = (Offset.dimensions() != 0);
+   if (Origin.X != (HasOffset ? Position[0] : 0) || Origin.Y != (HasOffset ? Position[1] : 0))
+      throw cl::Error(CL_INVALID_VALUE, "all images given to a primitive must have the same origin");
+}
+
+// Buffers and values don't have an origin
+template<class T>
+inline typename std::enable_if<!std::is_base_of<IImage, T>::value>::type _CheckOffset(const T&, const cl::NDRange&)
+{ }
+
+// Makes the launch arguments of a kernel that does not specify a local range
+// The local range is selected by the work-group tuner when tuning is enabled
+template<class N>
+inline cl::EnqueueArgs _KernelArgs(COpenCL& CL, SWorkGroupTrial& Trial, Program& Prog, const cl::Kernel& Kernel, const N& Name,
+   cl::CommandQueue& Queue, const std::vector<cl::Event>& WaitList, const cl::NDRange& Offset, const cl::NDRange& Global)
+{
+   if (!CL.IsTuningWorkGroups())
+      return cl::EnqueueArgs(Queue, WaitList, Offset, Global, cl::NullRange);
+
+   cl::NDRange Local = CL.GetWorkGroupTuner().SelectLocalRange(Prog.GetIdentifier(), Kernel, std::string(Name), Global, Trial);
+   return cl::EnqueueArgs(Queue, WaitList, Offset, Global, Local);
+}
+
+// Makes the launch arguments of a kernel that specifies its local range - the local range is used as is
+template<class N>
+inline cl::EnqueueArgs _KernelArgs(COpenCL&, SWorkGroupTrial&, Program&, const cl::Kernel&, const N&,
+   cl::CommandQueue& Queue, const std::vector<cl::Event>& WaitList, const cl::NDRange& Offset, const cl::NDRange& Global,
+   const cl::NDRange& Local)
+{
+   return cl::EnqueueArgs(Queue, WaitList, Offset, Global, Local);
+}
+
+// Makes the launch arguments recorded in an operation graph
+// A local range that the work-group tuner is trying may be slow, so the graph uses the default local range instead
+inline cl::EnqueueArgs _RecordedArgs(const cl::EnqueueArgs& Args, const SWorkGroupTrial& Trial)
+{
+   if (Trial.Candidate < 0)
+      return Args;
+
+   cl::CommandQueue Queue = Args.queue_;
+   return cl::EnqueueArgs(Queue, Args.events_, Args.offset_, Args.global_, cl::NullRange);
+}
 
 /// More generic kernel calling macro.
 /// Example usage : Kernel(CL, ArithmeticProgram, "Add", cl::NDRange(16, 16, 1), In(Src1, Src2), Out(Dst), Arg1, Arg2);
 #define Kernel_(CL, program, name, local_range, in, out, ...)\
+   {\
    FOR_EACH(_SEND_IF_NEEDED, in)\
-   cl::make_kernel<FOR_EACH_COMMA(CL_TYPE, in) ADD_COMMA(out) FOR_EACH_COMMA(CL_TYPE, out) ADD_COMMA(__VA_ARGS__) FOR_EACH_COMMA(CL_TYPE, __VA_ARGS__)>\
-      ((cl::Program) program, SELECT_NAME(name, _FIRST_IN(in)))\
-         (cl::EnqueueArgs(CL, KERNEL_RANGE(_FIRST_IN(in)) ADD_COMMA(local_range) local_range),\
-            in ADD_COMMA(out) out ADD_COMMA(__VA_ARGS__) __VA_ARGS__);\
-   FOR_EACH(_SET_IN_DEVICE, out)
+   cl::NDRange _kernel_offset = KERNEL_OFFSET(_FIRST_IN(in));\
+   FOR_EACH(_CHECK_OFFSET, in)\
+   FOR_EACH(_CHECK_OFFSET, out)\
+   cl::CommandQueue& _kernel_queue = (CL).GetQueue();\
+   std::vector<cl::Event> _kernel_wait_list;\
+   FOR_EACH(_READ_DEPENDENCIES, in)\
+   FOR_EACH(_WRITE_DEPENDENCIES, out)\
+   OpenCLIPP::Program& _kernel_program = program;\
+   const cl::Kernel& _kernel = _SELECT_KERNEL(_kernel_program, SELECT_NAME(name, _FIRST_IN(in)));\
+   OpenCLIPP::SWorkGroupTrial _kernel_trial;\
+   cl::EnqueueArgs _kernel_args = OpenCLIPP::_KernelArgs(CL, _kernel_trial, _kernel_program, _kernel, SELECT_NAME(name, _FIRST_IN(in)),\
+      _kernel_queue, _kernel_wait_list, _kernel_offset, KERNEL_RANGE(_FIRST_IN(in)) ADD_COMMA(local_range) local_range);\
+   cl::Event _kernel_event = cl::make_kernel<FOR_EACH_COMMA(CL_TYPE, in) ADD_COMMA(out) FOR_EACH_COMMA(CL_TYPE, out) ADD_COMMA(__VA_ARGS__) FOR_EACH_COMMA(CL_TYPE, __VA_ARGS__)>\
+      (_kernel)(_kernel_args, in ADD_COMMA(out) out ADD_COMMA(__VA_ARGS__) __VA_ARGS__);\
+   if (_GRAPH_RECORDING && (CL).IsRecording())\
+   {\
+      OpenCLIPP::OperationGraph& _kernel_graph = (CL).GetRecordingGraph();\
+      _kernel_graph.AddStep(_kernel_program, SELECT_NAME(name, _FIRST_IN(in)), OpenCLIPP::_RecordedArgs(_kernel_args, _kernel_trial),\
+         _FIRST_IN(in).Width(), _FIRST_IN(in).Height());\
+      FOR_EACH(_RECORD_IN, in)\
+      FOR_EACH(_RECORD_OUT, out)\
+      FOR_EACH(_RECORD_ARG, __VA_ARGS__)\
+   }\
+   if (_kernel_trial.Candidate >= 0)\
+      (CL).GetWorkGroupTuner().AddTrialResult(_kernel_trial, _kernel_event);\
+   FOR_EACH(_SET_READ_EVENT, in)\
+   FOR_EACH(_SET_IN_DEVICE, out)\
+   if ((CL).IsProfiling())\
+      (CL).AddProfilingRecord(SELECT_NAME(name, _FIRST_IN(in)), _FIRST_IN(in).Width(), _FIRST_IN(in).Height(), _kernel_event);\
+   }
 
 }
@@ -31,8 +31,10 @@
 
 #include "OpenCLIPP.h"
 #include "OpenCLIPP.hpp"
+#include "c++/Programs/Color.h"
 
 #include <map>
+#include <mutex>
 
 using namespace std;
 using namespace OpenCLIPP;
@@ -54,7 +56,8 @@ struct SProgramList
       morphology(CL),
       morphologyBuffer(CL),
       transform(CL),
-      tresholding(CL)
+      tresholding(CL),
+      tresholdingVector(CL)
    { }
 
    Arithmetic arithmetic;
@@ -71,15 +74,35 @@ struct SProgramList
    MorphologyBuffer morphologyBuffer;
    Transform transform;
    Tresholding tresholding;
+   TresholdingVector tresholdingVector;
 };
 
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
 // List of program for each context
 map<COpenCL*, shared_ptr<SProgramList>> g_ProgramList;
 
-COpenCL * g_CurrentContext = nullptr;
+// Current context of each thread
+THREAD_LOCAL COpenCL * g_CurrentContext = nullptr;
+
+// Pinned memory allocated with ocipAllocHost()
+map<void *, shared_ptr<PinnedMemory>> g_PinnedMemory;
+
+// Protects g_ProgramList and g_PinnedMemory
+mutex g_RegistryMutex;
 
-// Retreived the program list for the current context
-SProgramList& GetList();
+// Retreives the program list of a context - the list stays valid while the returned pointer is kept, even if the context is uninitialized
+shared_ptr<SProgramList> GetList(COpenCL& CL);
+
+// Returns the context if it is a valid context, null otherwise
+COpenCL * FindContext(ocipContext Context);
+
+// Returns the pinned memory that starts at HostPtr, null if HostPtr was not allocated by ocipAllocHost()
+shared_ptr<PinnedMemory> FindPinnedMemory(void * HostPtr);
 
 
 // Catches exceptions and returns proper error code
@@ -100,7 +123,12 @@ ocipError ocip_API ocipInitialize(ocipContext * ContextPtr, const char * Preferr
    H(
       COpenCL * CL = new COpenCL(PreferredPlatform, deviceType);
 
-      g_ProgramList[CL] = make_shared<SProgramList>(*CL);
+      shared_ptr<SProgramList> List = make_shared<SProgramList>(*CL);
+
+      {
+         lock_guard<mutex> Lock(g_RegistryMutex);
+         g_ProgramList[CL] = List;
+      }
 
       g_CurrentContext = CL;
 
@@ -118,7 +146,20 @@ ocipError ocip_API ocipUninitialize(ocipContext Context)
    if (CL == g_CurrentContext)
       g_CurrentContext = nullptr;
 
-   H( g_ProgramList[CL].reset();
+   shared_ptr<SProgramList> List;
+
+   {
+      lock_guard<mutex> Lock(g_RegistryMutex);
+
+      auto It = g_ProgramList.find(CL);
+      if (It == g_ProgramList.end())
+         return CL_INVALID_CONTEXT;
+
+      List = It->second;
+      g_ProgramList.erase(It);
+   }
+
+   H( List.reset();
       delete CL; )
 }
 
@@ -126,10 +167,7 @@ ocipError ocip_API ocipChangeContext(ocipContext Context)
 {
    COpenCL * CL = (COpenCL *) Context;
 
-   if (CL == nullptr)
-      return CL_INVALID_CONTEXT;
-
-   if (g_ProgramList[CL] == nullptr)
+   if (FindContext(Context) == nullptr)
       return CL_INVALID_CONTEXT;
 
    g_CurrentContext = CL;
@@ -137,11 +175,34 @@ ocipError ocip_API ocipChangeContext(ocipContext Context)
    return CL_SUCCESS;
 }
 
+ocipError ocip_API ocipGetCurrentContext(ocipContext * ContextPtr)
+{
+   if (ContextPtr == nullptr)
+      return CL_INVALID_VALUE;
+
+   *ContextPtr = (ocipContext) g_CurrentContext;
+
+   if (g_CurrentContext == nullptr)
+      return CL_INVALID_CONTEXT;
+
+   return CL_SUCCESS;
+}
+
 void ocip_API ocipSetCLFilesPath(const char * Path)
 {
    COpenCL::SetClFilesPath(Path);
 }
 
+void ocip_API ocipUseCLFiles(ocipBool Use)
+{
+   COpenCL::SetUseClFiles(Use != 0);
+}
+
+void ocip_API ocipSetBinaryCachePath(const char * Path)
+{
+   COpenCL::SetBinaryCachePath(Path != nullptr ? Path : "");
+}
+
 ocip_API const char * ocipGetErrorName(ocipError Error)
 {
    return COpenCL::ErrorName(Error);
@@ -149,7 +210,12 @@ ocip_API const char * ocipGetErrorName(ocipError Error)
 
 ocipError ocip_API ocipGetDeviceName(char * Name, uint BufferLength)
 {
-   COpenCL * CL = g_CurrentContext;
+   return ocipGetDeviceNameEx((ocipContext) g_CurrentContext, Name, BufferLength);
+}
+
+ocipError ocip_API ocipGetDeviceNameEx(ocipContext Context, char * Name, uint BufferLength)
+{
+   COpenCL * CL = FindContext(Context);
 
    if (CL == nullptr)
       return CL_INVALID_CONTEXT;
@@ -171,23 +237,195 @@ ocipError ocip_API ocipGetDeviceName(char * Name, uint BufferLength)
 
 ocipError ocip_API ocipFinish()
 {
-   COpenCL * CL = g_CurrentContext;
+   return ocipFinishEx((ocipContext) g_CurrentContext);
+}
+
+ocipError ocip_API ocipFinishEx(ocipContext Context)
+{
+   COpenCL * CL = FindContext(Context);
+
+   if (CL == nullptr)
+      return CL_INVALID_CONTEXT;
+
+   H( CL->Finish() );
+}
+
+ocipError ocip_API ocipUseTransferQueue(ocipBool Use)
+{
+   return ocipUseTransferQueueEx((ocipContext) g_CurrentContext, Use);
+}
+
+ocipError ocip_API ocipUseTransferQueueEx(ocipContext Context, ocipBool Use)
+{
+   COpenCL * CL = FindContext(Context);
 
    if (CL == nullptr)
       return CL_INVALID_CONTEXT;
 
-   H( CL->GetQueue().finish() );
+   H( CL->UseTransferQueue(Use != 0) );
+}
+
+ocipError ocip_API ocipEnableProfiling(ocipBool Enable)
+{
+   return ocipEnableProfilingEx((ocipContext) g_CurrentContext, Enable);
+}
+
+ocipError ocip_API ocipEnableProfilingEx(ocipContext Context, ocipBool Enable)
+{
+   COpenCL * CL = FindContext(Context);
+
+   if (CL == nullptr)
+      return CL_INVALID_CONTEXT;
+
+   H( CL->EnableProfiling(Enable != 0) );
+}
+
+ocipError ocip_API ocipEnableWorkGroupTuning(ocipBool Enable)
+{
+   return ocipEnableWorkGroupTuningEx((ocipContext) g_CurrentContext, Enable);
+}
+
+ocipError ocip_API ocipEnableWorkGroupTuningEx(ocipContext Context, ocipBool Enable)
+{
+   COpenCL * CL = FindContext(Context);
+
+   if (CL == nullptr)
+      return CL_INVALID_CONTEXT;
+
+   H( CL->EnableWorkGroupTuning(Enable != 0) );
+}
+
+ocipError ocip_API ocipGetProfilingRecords(SProfilingRecord * Records, uint * NbRecords)
+{
+   return ocipGetProfilingRecordsEx((ocipContext) g_CurrentContext, Records, NbRecords);
+}
+
+ocipError ocip_API ocipGetProfilingRecordsEx(ocipContext Context, SProfilingRecord * Records, uint * NbRecords)
+{
+   COpenCL * CL = FindContext(Context);
+
+   if (CL == nullptr)
+      return CL_INVALID_CONTEXT;
+
+   if (NbRecords == nullptr)
+      return CL_INVALID_VALUE;
+
+   if (Records == nullptr)
+   {
+      *NbRecords = (uint) CL->GetNbProfilingRecords();
+      return CL_SUCCESS;
+   }
+
+   H(
+      std::vector<SProfilingRecord> List = CL->GetProfilingRecords(*NbRecords);
+
+      for (size_t i = 0; i < List.size(); i++)
+         Records[i] = List[i];
+
+      *NbRecords = (uint) List.size();
+      )
+}
+
+
+ocipError ocip_API ocipAllocHost(void ** HostPtr, size_t Size)
+{
+   return ocipAllocHostEx((ocipContext) g_CurrentContext, HostPtr, Size);
+}
+
+ocipError ocip_API ocipAllocHostEx(ocipContext Context, void ** HostPtr, size_t Size)
+{
+   COpenCL * CL = FindContext(Context);
+
+   if (CL == nullptr)
+      return CL_INVALID_CONTEXT;
+
+   if (HostPtr == nullptr)
+      return CL_INVALID_VALUE;
+
+   H(
+      shared_ptr<PinnedMemory> Memory = CL->AllocHost(Size);
+
+      {
+         lock_guard<mutex> Lock(g_RegistryMutex);
+         g_PinnedMemory[Memory->Data()] = Memory;
+      }
+
+      *HostPtr = Memory->Data();
+      )
+}
+
+ocipError ocip_API ocipFreeHost(void * HostPtr)
+{
+   shared_ptr<PinnedMemory> Memory;   // Released after the mutex is unlocked
+
+   {
+      lock_guard<mutex> Lock(g_RegistryMutex);
+
+      auto It = g_PinnedMemory.find(HostPtr);
+      if (It == g_PinnedMemory.end())
+         return CL_INVALID_HOST_PTR;
+
+      Memory = It->second;
+      g_PinnedMemory.erase(It);
+   }
+
+   return CL_SUCCESS;
 }
 
 
 ocipError ocip_API ocipCreateImageBuffer(ocipBuffer * BufferPtr, SImage image, void * ImageData, cl_mem_flags flags)
 {
-   COpenCL * CL = g_CurrentContext;
+   return ocipCreateImageBufferEx((ocipContext) g_CurrentContext, BufferPtr, image, ImageData, flags);
+}
+
+ocipError ocip_API ocipCreateImageBufferEx(ocipContext Context, ocipBuffer * BufferPtr, SImage image, void * ImageData, cl_mem_flags flags)
+{
+   COpenCL * CL = FindContext(Context);
 
    if (CL == nullptr)
       return CL_INVALID_CONTEXT;
 
-   H( *BufferPtr = (ocipBuffer) new ImageBuffer(*CL, image, ImageData, flags) )
+   shared_ptr<PinnedMemory> Pinned = FindPinnedMemory(ImageData);
+
+   H( if (Pinned != nullptr)
+         *BufferPtr = (ocipBuffer) new ImageBuffer(*CL, image, Pinned, flags);
+      else
+         *BufferPtr = (ocipBuffer) new ImageBuffer(*CL, image, ImageData, flags);
+       )
+}
+
+ocipError ocip_API ocipCreateImageBufferView(ocipBuffer * BufferPtr, ocipBuffer Parent, uint X, uint Y, uint Width, uint Height)
+{
+   return ocipCreateImageBufferViewEx((ocipContext) g_CurrentContext, BufferPtr, Parent, X, Y, Width, Height);
+}
+
+ocipError ocip_API ocipCreateImageBufferViewEx(ocipContext Context, ocipBuffer * BufferPtr, ocipBuffer Parent,
+                                                uint X, uint Y, uint Width, uint Height)
+{
+   COpenCL * CL = FindContext(Context);
+
+   if (CL == nullptr)
+      return CL_INVALID_CONTEXT;
+
+   SRect Region = {X, Y, Width, Height};
+
+   H( *BufferPtr = (ocipBuffer) (ImageBuffer *) new ImageBufferView(*CL, Buf(Parent), Region) )
+}
+
+ocipError ocip_API ocipCreateImageBufferBatch(ocipBuffer * BufferPtr, SImage image, uint NbImages, void * ImageData, cl_mem_flags flags)
+{
+   return ocipCreateImageBufferBatchEx((ocipContext) g_CurrentContext, BufferPtr, image, NbImages, ImageData, flags);
+}
+
+ocipError ocip_API ocipCreateImageBufferBatchEx(ocipContext Context, ocipBuffer * BufferPtr, SImage image, uint NbImages,
+                                                 void * ImageData, cl_mem_flags flags)
+{
+   COpenCL * CL = FindContext(Context);
+
+   if (CL == nullptr)
+      return CL_INVALID_CONTEXT;
+
+   H( *BufferPtr = (ocipBuffer) (ImageBuffer *) new ImageBufferBatch(*CL, image, NbImages, ImageData, flags) )
 }
 
 ocipError ocip_API ocipSendImageBuffer(ocipBuffer Buffer)
@@ -218,18 +456,45 @@ ocipError ocip_API ocipReleaseImageBuffer(ocipBuffer Buffer)
 
 ocipError ocip_API ocipCreateImage(ocipImage * ImagePtr, SImage image, void * ImageData, cl_mem_flags flags)
 {
-   COpenCL * CL = g_CurrentContext;
+   return ocipCreateImageEx((ocipContext) g_CurrentContext, ImagePtr, image, ImageData, flags);
+}
+
+ocipError ocip_API ocipCreateImageEx(ocipContext Context, ocipImage * ImagePtr, SImage image, void * ImageData, cl_mem_flags flags)
+{
+   COpenCL * CL = FindContext(Context);
 
    if (CL == nullptr)
       return CL_INVALID_CONTEXT;
 
+   shared_ptr<PinnedMemory> Pinned = FindPinnedMemory(ImageData);
+
    H( if (image.Channels == 3)
          *ImagePtr = (ocipImage) new ColorImage(*CL, image, ImageData);
+      else if (Pinned != nullptr)
+         *ImagePtr = (ocipImage) new Image(*CL, image, Pinned, flags);
       else
          *ImagePtr = (ocipImage) new Image(*CL, image, ImageData, flags);
        )
 }
 
+ocipError ocip_API ocipCreateImageView(ocipImage * ImagePtr, ocipImage Parent, uint X, uint Y, uint Width, uint Height)
+{
+   return ocipCreateImageViewEx((ocipContext) g_CurrentContext, ImagePtr, Parent, X, Y, Width, Height);
+}
+
+ocipError ocip_API ocipCreateImageViewEx(ocipContext Context, ocipImage * ImagePtr, ocipImage Parent,
+                                          uint X, uint Y, uint Width, uint Height)
+{
+   COpenCL * CL = FindContext(Context);
+
+   if (CL == nullptr)
+      return CL_INVALID_CONTEXT;
+
+   SRect Region = {X, Y, Width, Height};
+
+   H( *ImagePtr = (ocipImage) (IImage *) new ImageView(*CL, Img(Parent), Region) )
+}
+
 ocipError ocip_API ocipSendImage(ocipImage image)
 {
    IImage * Ptr = (IImage *) image;
@@ -269,6 +534,62 @@ ocipError ocip_API ocipReleaseImage(ocipImage image)
 }
 
 
+// Recorded graphs - an ocipGraph is a pointer to a shared_ptr<OperationGraph>
+ocipError ocip_API ocipBeginRecording()
+{
+   return ocipBeginRecordingEx((ocipContext) g_CurrentContext);
+}
+
+ocipError ocip_API ocipBeginRecordingEx(ocipContext Context)
+{
+   COpenCL * CL = FindContext(Context);
+
+   if (CL == nullptr)
+      return CL_INVALID_CONTEXT;
+
+   H( CL->BeginRecording() );
+}
+
+ocipError ocip_API ocipEndRecording(ocipGraph * GraphPtr)
+{
+   return ocipEndRecordingEx((ocipContext) g_CurrentContext, GraphPtr);
+}
+
+ocipError ocip_API ocipEndRecordingEx(ocipContext Context, ocipGraph * GraphPtr)
+{
+   COpenCL * CL = FindContext(Context);
+
+   if (CL == nullptr)
+      return CL_INVALID_CONTEXT;
+
+   H( *GraphPtr = (ocipGraph) new shared_ptr<OperationGraph>(CL->EndRecording()) );
+}
+
+ocipError ocip_API ocipLaunchGraph(ocipGraph Graph)
+{
+   shared_ptr<OperationGraph> * Ptr = (shared_ptr<OperationGraph> *) Graph;
+   H( (*Ptr)->Launch() );
+}
+
+ocipError ocip_API ocipGraphReplaceImage(ocipGraph Graph, ocipImage Recorded, ocipImage Replacement)
+{
+   shared_ptr<OperationGraph> * Ptr = (shared_ptr<OperationGraph> *) Graph;
+   H( (*Ptr)->Replace(Img(Recorded), Img(Replacement)) );
+}
+
+ocipError ocip_API ocipGraphReplaceImageBuffer(ocipGraph Graph, ocipBuffer Recorded, ocipBuffer Replacement)
+{
+   shared_ptr<OperationGraph> * Ptr = (shared_ptr<OperationGraph> *) Graph;
+   H( (*Ptr)->Replace(Buf(Recorded), Buf(Replacement)) );
+}
+
+ocipError ocip_API ocipReleaseGraph(ocipGraph Graph)
+{
+   shared_ptr<OperationGraph> * Ptr = (shared_ptr<OperationGraph> *) Graph;
+   H( delete Ptr )
+}
+
+
 ocipError ocip_API ocipReleaseProgram(ocipProgram Program)
 {
    MultiProgram * Pr = (MultiProgram *) Program;
@@ -276,13 +597,60 @@ ocipError ocip_API ocipReleaseProgram(ocipProgram Program)
 }
 
 
+ocipError ocip_API ocipPrepareSharedProgramsAsync()
+{
+   return ocipPrepareSharedProgramsAsyncEx((ocipContext) g_CurrentContext);
+}
+
+// Programs owned by the handles of ocipPrepare*(ocipProgram * ProgramPtr, ...) are not shared, they are built by that call
+ocipError ocip_API ocipPrepareSharedProgramsAsyncEx(ocipContext Context)
+{
+   COpenCL * CL = FindContext(Context);
+
+   if (CL == nullptr)
+      return CL_INVALID_CONTEXT;
+
+   H(
+      shared_ptr<SProgramList> ListPtr;
+
+      {
+         lock_guard<mutex> Lock(g_RegistryMutex);
+
+         auto It = g_ProgramList.find(CL);
+         if (It == g_ProgramList.end())
+            return CL_INVALID_CONTEXT;
+
+         ListPtr = It->second;
+      }
+
+      SProgramList& List = *ListPtr;
+      List.arithmetic.PrepareAllAsync();
+      List.arithmeticVector.PrepareAllAsync();
+      List.conversions.PrepareAllAsync();
+      List.filters.PrepareAllAsync();
+      List.filtersVector.PrepareAllAsync();
+      List.histogram.PrepareAllAsync();
+      List.logic.PrepareAllAsync();
+      List.logicVector.PrepareAllAsync();
+      List.lut.PrepareAllAsync();
+      List.lutVector.PrepareAllAsync();
+      List.morphology.PrepareAllAsync();
+      List.morphologyBuffer.PrepareAllAsync();
+      List.transform.PrepareAllAsync();
+      List.tresholding.PrepareAllAsync();
+      List.tresholdingVector.PrepareAllAsync();
+      CL->GetColorConverter().PrepareAllAsync();
+      )
+}
+
+
 // Macros for less code repetition
 
 // For implementing standard ocipPrepare* functions
 #define PREPARE(fun, Class) \
 ocipError ocip_API fun(IMAGE_ARG Image)\
 {\
-   H( GetList().Class.PrepareFor(CONV(Image)) );\
+   H( GetList(CONV(Image).GetCL())->Class.PrepareFor(CONV(Image)) );\
 }
 
 
@@ -291,9 +659,10 @@ ocipError ocip_API fun(IMAGE_ARG Image)\
 ocipError ocip_API name(ocipProgram * ProgramPtr, IMAGE_ARG Image)\
 {\
    H(\
-      if (g_CurrentContext == nullptr)\
+      COpenCL * CL = (Image != nullptr ? &CONV(Image).GetCL() : g_CurrentContext);\
+      if (CL == nullptr)\
          return CL_INVALID_CONTEXT;\
-      Class * Ptr = new Class(*g_CurrentContext);\
+      Class * Ptr = new Class(*CL);\
       *ProgramPtr = (ocipProgram) Ptr;\
       if (Image != nullptr)\
          Ptr->PrepareFor(CONV(Image));\
@@ -305,31 +674,31 @@ ocipError ocip_API name(ocipProgram * ProgramPtr, IMAGE_ARG Image)\
 #define BINARY_OP(fun, method) \
 ocipError ocip_API fun(PROGRAM_ARG IMAGE_ARG Source1, IMAGE_ARG Source2, IMAGE_ARG Dest)\
 {\
-   H( CLASS.method(CONV(Source1), CONV(Source2), CONV(Dest)) )\
+   H( CLASS(CONV(Source1)).method(CONV(Source1), CONV(Source2), CONV(Dest)) )\
 }
 
 #define CONSTANT_OP(fun, method, type) \
 ocipError ocip_API fun(PROGRAM_ARG IMAGE_ARG Source, IMAGE_ARG Dest, type value)\
 {\
-   H( CLASS.method(CONV(Source), CONV(Dest), value) )\
+   H( CLASS(CONV(Source)).method(CONV(Source), CONV(Dest), value) )\
 }
 
 #define UNARY_OP(fun, method) \
 ocipError ocip_API fun(PROGRAM_ARG IMAGE_ARG Source, IMAGE_ARG Dest)\
 {\
-   H( CLASS.method(CONV(Source), CONV(Dest)) )\
+   H( CLASS(CONV(Source)).method(CONV(Source), CONV(Dest)) )\
 }
 
 #define REDUCE_OP(fun, method, type) \
 ocipError ocip_API fun(PROGRAM_ARG IMAGE_ARG Source, type Result)\
 {\
-   H( CLASS.method(CONV(Source), Result) )\
+   H( CLASS(CONV(Source)).method(CONV(Source), Result) )\
 }
 
 #define REDUCE_RETURN_OP(fun, method, type) \
 ocipError ocip_API fun(PROGRAM_ARG IMAGE_ARG Source, type * Result)\
 {\
-   H( *Result = CLASS.method(CONV(Source)) )\
+   H( *Result = CLASS(CONV(Source)).method(CONV(Source)) )\
 }
 
 
@@ -355,7 +724,7 @@ PREPARE2(ocipPrepareBlob, Blob)
 PREPARE2(ocipPrepareIntegral, Integral)
 
 
-#define CLASS GetList().arithmetic
+#define CLASS(img) GetList((img).GetCL())->arithmetic
 
 BINARY_OP(ocipAdd, Add)
 BINARY_OP(ocipAddSquare, AddSquare)
@@ -389,7 +758,7 @@ UNARY_OP(ocipCos, Cos)
 
 
 #undef CLASS
-#define CLASS GetList().logic
+#define CLASS(img) GetList((img).GetCL())->logic
 
 BINARY_OP(ocipAnd, And)
 BINARY_OP(ocipOr, Or)
@@ -403,46 +772,46 @@ UNARY_OP(ocipNot, Not)
 
 
 #undef CLASS
-#define CLASS GetList().lut
+#define CLASS(img) GetList((img).GetCL())->lut
 
 ocipError ocip_API ocipLut(ocipImage Source, ocipImage Dest, uint * levels, uint * values, int NbValues)
 {
-   H( CLASS.LUT(Img(Source), Img(Dest), levels, values, NbValues) )
+   H( CLASS(Img(Source)).LUT(Img(Source), Img(Dest), levels, values, NbValues) )
 }
 
 ocipError ocip_API ocipLutLinear(ocipImage Source, ocipImage Dest, float * levels, float * values, int NbValues)
 {
-   H( CLASS.LUTLinear(Img(Source), Img(Dest), levels, values, NbValues) )
+   H( CLASS(Img(Source)).LUTLinear(Img(Source), Img(Dest), levels, values, NbValues) )
 }
 
 ocipError ocip_API ocipLutScale(ocipImage Source, ocipImage Dest, float SrcMin, float SrcMax, float DstMin, float DstMax)
 {
-   H( CLASS.Scale(Img(Source), Img(Dest), SrcMin, SrcMax, DstMin, DstMax) )
+   H( CLASS(Img(Source)).Scale(Img(Source), Img(Dest), SrcMin, SrcMax, DstMin, DstMax) )
 }
 
 
 #undef CLASS
-#define CLASS GetList().morphology
+#define CLASS(img) GetList((img).GetCL())->morphology
 
 ocipError ocip_API ocipErode(ocipImage Source, ocipImage Dest, int Width)
 {
-   H( CLASS.Erode(Img(Source), Img(Dest), Width) )
+   H( CLASS(Img(Source)).Erode(Img(Source), Img(Dest), Width) )
 }
 
 ocipError ocip_API ocipDilate(ocipImage Source, ocipImage Dest, int Width)
 {
-   H( CLASS.Dilate(Img(Source), Img(Dest), Width) )
+   H( CLASS(Img(Source)).Dilate(Img(Source), Img(Dest), Width) )
 }
 
 ocipError ocip_API ocipGradient(ocipImage Source, ocipImage Dest, ocipImage Temp, int Width)
 {
-   H( CLASS.Gradient(Img(Source), Img(Dest), Img(Temp), Width) )
+   H( CLASS(Img(Source)).Gradient(Img(Source), Img(Dest), Img(Temp), Width) )
 }
 
 #define MORPHO(fun, method) \
 ocipError ocip_API fun(ocipImage Source, ocipImage Dest, ocipImage Temp, int Iterations, int Width)\
 {\
-   H( CLASS.method(Img(Source), Img(Dest), Img(Temp), Iterations, Width) )\
+   H( CLASS(Img(Source)).method(Img(Source), Img(Dest), Img(Temp), Iterations, Width) )\
 }
 
 MORPHO(ocipErode2, Erode)
@@ -456,7 +825,7 @@ MORPHO(ocipBlackHat, BlackHat)
 
 
 #undef CLASS
-#define CLASS GetList().transform
+#define CLASS(img) GetList((img).GetCL())->transform
 
 UNARY_OP(ocipMirrorX, MirrorX)
 UNARY_OP(ocipMirrorY, MirrorY)
@@ -465,17 +834,17 @@ UNARY_OP(ocipTranspose, Transpose)
 
 ocipError ocip_API ocipResize(ocipImage Source, ocipImage Dest, ocipBool LinearInterpolation, ocipBool KeepRatio)
 {
-   H( CLASS.Resize(Img(Source), Img(Dest), LinearInterpolation != 0, KeepRatio != 0) )
+   H( CLASS(Img(Source)).Resize(Img(Source), Img(Dest), LinearInterpolation != 0, KeepRatio != 0) )
 }
 
 ocipError ocip_API ocipSet(ocipImage Dest, float Value)
 {
-   H( CLASS.SetAll(Img(Dest), Value) )
+   H( CLASS(Img(Dest)).SetAll(Img(Dest), Value) )
 }
 
 
 #undef CLASS
-#define CLASS GetList().conversions
+#define CLASS(img) GetList((img).GetCL())->conversions
 
 UNARY_OP(ocipConvert, Convert)
 UNARY_OP(ocipScale, Scale)
@@ -485,66 +854,66 @@ UNARY_OP(ocipToColor, ToColor)
 
 ocipError ocip_API ocipScale2(ocipImage Source, ocipImage Dest, int Offset, float Ratio)
 {
-   H( CLASS.Scale(Img(Source), Img(Dest), Offset, Ratio) )
+   H( CLASS(Img(Source)).Scale(Img(Source), Img(Dest), Offset, Ratio) )
 }
 
 ocipError ocip_API ocipCopy_B(ocipBuffer Source, ocipBuffer Dest)
 {
-   H( CLASS.Copy(Buf(Source), Buf(Dest)) )
+   H( CLASS(Buf(Source)).Copy(Buf(Source), Buf(Dest)) )
 }
 
 ocipError ocip_API ocipToImage(ocipBuffer Source, ocipImage Dest)
 {
-   H( CLASS.Copy(Buf(Source), Img(Dest)) )
+   H( CLASS(Buf(Source)).Copy(Buf(Source), Img(Dest)) )
 }
 
 ocipError ocip_API ocipToBuffer(ocipImage Source, ocipBuffer Dest)
 {
-   H( CLASS.Copy(Img(Source), Buf(Dest)) )
+   H( CLASS(Img(Source)).Copy(Img(Source), Buf(Dest)) )
 }
 
 ocipError ocip_API ocipSelectChannel(ocipImage Source, ocipImage Dest, int ChannelNo)
 {
-   H( CLASS.SelectChannel(Img(Source), Img(Dest), ChannelNo) )
+   H( CLASS(Img(Source)).SelectChannel(Img(Source), Img(Dest), ChannelNo) )
 }
 
 
 #undef CLASS
-#define CLASS GetList().tresholding
+#define CLASS(img) GetList((img).GetCL())->tresholding
 
 ocipError ocip_API ocipTresholdGT(ocipImage Source, ocipImage Dest, float Tresh, float valueHigher)
 {
-   H( CLASS.TresholdGT(Img(Source), Img(Dest), Tresh, valueHigher) )
+   H( CLASS(Img(Source)).TresholdGT(Img(Source), Img(Dest), Tresh, valueHigher) )
 }
 
 ocipError ocip_API ocipTresholdLT(ocipImage Source, ocipImage Dest, float Tresh, float valueLower)
 {
-   H( CLASS.TresholdLT(Img(Source), Img(Dest), Tresh, valueLower) )
+   H( CLASS(Img(Source)).TresholdLT(Img(Source), Img(Dest), Tresh, valueLower) )
 }
 
 ocipError ocip_API ocipTresholdGTLT(ocipImage Source, ocipImage Dest, float threshLT, float valueLower, float treshGT, float valueHigher)
 {
-   H( CLASS.TresholdGTLT(Img(Source), Img(Dest), threshLT, valueLower, treshGT, valueHigher) )
+   H( CLASS(Img(Source)).TresholdGTLT(Img(Source), Img(Dest), threshLT, valueLower, treshGT, valueHigher) )
 }
 
 ocipError ocip_API ocipTreshold_Img(ocipImage Source1, ocipImage Source2, ocipImage Dest, ECompareOperation Op)
 {
-   H( CLASS.treshold(Img(Source1), Img(Source2), Img(Dest), (Tresholding::ECompareOperation) Op) )
+   H( CLASS(Img(Source1)).treshold(Img(Source1), Img(Source2), Img(Dest), (Tresholding::ECompareOperation) Op) )
 }
 
 ocipError ocip_API ocipCompare_Img(ocipImage Source1, ocipImage Source2, ocipImage Dest, ECompareOperation Op)
 {
-   H( CLASS.Compare(Img(Source1), Img(Source2), Img(Dest), (Tresholding::ECompareOperation) Op) )
+   H( CLASS(Img(Source1)).Compare(Img(Source1), Img(Source2), Img(Dest), (Tresholding::ECompareOperation) Op) )
 }
 
 ocipError ocip_API ocipCompare(ocipImage Source, ocipImage Dest, float Value, ECompareOperation Op)
 {
-   H( CLASS.Compare(Img(Source), Img(Dest), Value, (Tresholding::ECompareOperation) Op) )
+   H( CLASS(Img(Source)).Compare(Img(Source), Img(Dest), Value, (Tresholding::ECompareOperation) Op) )
 }
 
 
 #undef CLASS
-#define CLASS GetList().filters
+#define CLASS(img) GetList((img).GetCL())->filters
 
 CONSTANT_OP(ocipGaussianBlur, GaussianBlur, float)
 CONSTANT_OP(ocipGauss, Gauss, int)
@@ -567,7 +936,7 @@ CONSTANT_OP(ocipLaplace, Laplace, int)
 
 
 #undef CLASS
-#define CLASS GetList().histogram
+#define CLASS(img) GetList((img).GetCL())->histogram
 
 REDUCE_OP(ociphistogram_1C, Histogram1C, uint *)
 REDUCE_OP(ociphistogram_4C, Histogram4C, uint *)
@@ -579,7 +948,7 @@ REDUCE_RETURN_OP(ocipOtsuTreshold, OtsuTreshold, uint)
 #define PROGRAM_ARG ocipProgram Program, 
 
 #undef CLASS
-#define CLASS (*(Statistics*)Program)
+#define CLASS(img) (*(Statistics*)Program)
 
 REDUCE_RETURN_OP(ocipMin, Min, double)
 REDUCE_RETURN_OP(ocipMax, Max, double)
@@ -591,22 +960,22 @@ REDUCE_RETURN_OP(ocipMeanSqr, MeanSqr, double)
 
 
 #undef CLASS
-#define CLASS (*(Integral*)Program)
+#define CLASS(img) (*(Integral*)Program)
 
 UNARY_OP(ocipIntegralScan, IntegralScan)
 
 
 #undef CLASS
-#define CLASS (*(Blob*)Program)
+#define CLASS(img) (*(Blob*)Program)
 
 ocipError ocip_API ocipComputeLabels(ocipProgram Program, ocipImage Source, ocipBuffer Labels, int ConnectType)
 {
-   H( CLASS.ComputeLabels(Img(Source), Buf(Labels), ConnectType) )
+   H( CLASS(Img(Source)).ComputeLabels(Img(Source), Buf(Labels), ConnectType) )
 }
 
 ocipError ocip_API ocipRenameLabels(ocipProgram Program, ocipBuffer Labels)
 {
-   H( CLASS.RenameLabels(Buf(Labels)) )
+   H( CLASS(Buf(Labels)).RenameLabels(Buf(Labels)) )
 }
 
 
@@ -625,17 +994,18 @@ PREPARE(ocipPrepareImageBufferLogic, logicVector)
 PREPARE(ocipPrepareImageBufferLUT, lutVector)
 PREPARE(ocipPrepareImageBufferMorphology, morphologyBuffer)
 PREPARE(ocipPrepareImageBufferFilters, morphologyBuffer)
+PREPARE(ocipPrepareImageBufferTresholding, tresholdingVector)
 
 PREPARE2(ocipPrepareImageBufferStatistics, StatisticsVector)
 
 #undef CLASS
-#define CLASS GetList().conversions
+#define CLASS(img) GetList((img).GetCL())->conversions
 
 UNARY_OP(ocipCopy_V, Copy)
 
 
 #undef CLASS
-#define CLASS GetList().arithmeticVector
+#define CLASS(img) GetList((img).GetCL())->arithmeticVector
 
 BINARY_OP(ocipAdd_V, Add)
 BINARY_OP(ocipAddSquare_V, AddSquare)
@@ -669,7 +1039,7 @@ UNARY_OP(ocipCos_V, Cos)
 
 
 #undef CLASS
-#define CLASS GetList().logicVector
+#define CLASS(img) GetList((img).GetCL())->logicVector
 
 BINARY_OP(ocipAnd_V, And)
 BINARY_OP(ocipOr_V, Or)
@@ -683,52 +1053,87 @@ UNARY_OP(ocipNot_V, Not)
 
 
 #undef CLASS
-#define CLASS GetList().lutVector
+#define CLASS(img) GetList((img).GetCL())->lutVector
 
 ocipError ocip_API ocipLut_V(ocipBuffer Source, ocipBuffer Dest, uint * levels, uint * values, int NbValues)
 {
-   H( CLASS.LUT(Buf(Source), Buf(Dest), levels, values, NbValues) )
+   H( CLASS(Buf(Source)).LUT(Buf(Source), Buf(Dest), levels, values, NbValues) )
 }
 
 ocipError ocip_API ocipLutLinear_V(ocipBuffer Source, ocipBuffer Dest, float * levels, float * values, int NbValues)
 {
-   H( CLASS.LUTLinear(Buf(Source), Buf(Dest), levels, values, NbValues) )
+   H( CLASS(Buf(Source)).LUTLinear(Buf(Source), Buf(Dest), levels, values, NbValues) )
 }
 
 ocipError ocip_API ocipBasicLut_V(ocipBuffer Source, ocipBuffer Dest, unsigned char * values)
 {
-   H( CLASS.BasicLut(Buf(Source), Buf(Dest), values) )
+   H( CLASS(Buf(Source)).BasicLut(Buf(Source), Buf(Dest), values) )
 }
 
 ocipError ocip_API ocipScale_V(ocipBuffer Source, ocipBuffer Dest, float SrcMin, float SrcMax, float DstMin, float DstMax)
 {
-   H( CLASS.Scale(Buf(Source), Buf(Dest), SrcMin, SrcMax, DstMin, DstMax) )
+   H( CLASS(Buf(Source)).Scale(Buf(Source), Buf(Dest), SrcMin, SrcMax, DstMin, DstMax) )
+}
+
+
+
+#undef CLASS
+#define CLASS(img) GetList((img).GetCL())->tresholdingVector
+
+ocipError ocip_API ocipTresholdGT_V(ocipBuffer Source, ocipBuffer Dest, float Tresh, float valueHigher)
+{
+   H( CLASS(Buf(Source)).TresholdGT(Buf(Source), Buf(Dest), Tresh, valueHigher) )
+}
+
+ocipError ocip_API ocipTresholdLT_V(ocipBuffer Source, ocipBuffer Dest, float Tresh, float valueLower)
+{
+   H( CLASS(Buf(Source)).TresholdLT(Buf(Source), Buf(Dest), Tresh, valueLower) )
+}
+
+ocipError ocip_API ocipTresholdGTLT_V(ocipBuffer Source, ocipBuffer Dest, float threshLT, float valueLower, float treshGT, float valueHigher)
+{
+   H( CLASS(Buf(Source)).TresholdGTLT(Buf(Source), Buf(Dest), threshLT, valueLower, treshGT, valueHigher) )
+}
+
+ocipError ocip_API ocipTreshold_Img_V(ocipBuffer Source1, ocipBuffer Source2, ocipBuffer Dest, ECompareOperation Op)
+{
+   H( CLASS(Buf(Source1)).treshold(Buf(Source1), Buf(Source2), Buf(Dest), (Tresholding::ECompareOperation) Op) )
+}
+
+ocipError ocip_API ocipCompare_Img_V(ocipBuffer Source1, ocipBuffer Source2, ocipBuffer Dest, ECompareOperation Op)
+{
+   H( CLASS(Buf(Source1)).Compare(Buf(Source1), Buf(Source2), Buf(Dest), (Tresholding::ECompareOperation) Op) )
+}
+
+ocipError ocip_API ocipCompare_V(ocipBuffer Source, ocipBuffer Dest, float Value, ECompareOperation Op)
+{
+   H( CLASS(Buf(Source)).Compare(Buf(Source), Buf(Dest), Value, (Tresholding::ECompareOperation) Op) )
 }
 
 
 
 #undef CLASS
-#define CLASS GetList().morphologyBuffer
+#define CLASS(img) GetList((img).GetCL())->morphologyBuffer
 
 ocipError ocip_API ocipErode_B(ocipBuffer Source, ocipBuffer Dest, int Width)
 {
-   H( CLASS.Erode(Buf(Source), Buf(Dest), Width) )
+   H( CLASS(Buf(Source)).Erode(Buf(Source), Buf(Dest), Width) )
 }
 
 ocipError ocip_API ocipDilate_B(ocipBuffer Source, ocipBuffer Dest, int Width)
 {
-   H( CLASS.Dilate(Buf(Source), Buf(Dest), Width) )
+   H( CLASS(Buf(Source)).Dilate(Buf(Source), Buf(Dest), Width) )
 }
 
 ocipError ocip_API ocipGradient_B(ocipBuffer Source, ocipBuffer Dest, ocipBuffer Temp, int Width)
 {
-   H( CLASS.Gradient(Buf(Source), Buf(Dest), Buf(Temp), Width) )
+   H( CLASS(Buf(Source)).Gradient(Buf(Source), Buf(Dest), Buf(Temp), Width) )
 }
 
 #define MORPHO(fun, method) \
 ocipError ocip_API CONCATENATE(fun, _B)(ocipBuffer Source, ocipBuffer Dest, ocipBuffer Temp, int Iterations, int Width)\
 {\
-   H( CLASS.method(Buf(Source), Buf(Dest), Buf(Temp), Iterations, Width) )\
+   H( CLASS(Buf(Source)).method(Buf(Source), Buf(Dest), Buf(Temp), Iterations, Width) )\
 }
 
 MORPHO(ocipErode2, Erode)
@@ -740,7 +1145,7 @@ MORPHO(ocipBlackHat, BlackHat)
 
 
 #undef CLASS
-#define CLASS GetList().filtersVector
+#define CLASS(img) GetList((img).GetCL())->filtersVector
 
 CONSTANT_OP(ocipGaussianBlur_V, GaussianBlur, float)
 CONSTANT_OP(ocipGauss_V, Gauss, int)
@@ -768,7 +1173,7 @@ CONSTANT_OP(ocipLaplace_V, Laplace, int)
 #define PROGRAM_ARG ocipProgram Program, 
 
 #undef CLASS
-#define CLASS (*(StatisticsVector*)Program)
+#define CLASS(img) (*(StatisticsVector*)Program)
 
 REDUCE_RETURN_OP(ocipMin_V, Min, double)
 REDUCE_RETURN_OP(ocipMax_V, Max, double)
@@ -778,18 +1183,66 @@ REDUCE_RETURN_OP(ocipSum_V, Sum, double)
 REDUCE_RETURN_OP(ocipMean_V, Mean, double)
 REDUCE_RETURN_OP(ocipMeanSqr_V, MeanSqr, double)
 
+#define REDUCE_BATCH_OP(fun, method) \
+ocipError ocip_API fun(PROGRAM_ARG ocipBuffer Source, double * Results)\
+{\
+   ImageBufferBatch * Batch = dynamic_cast<ImageBufferBatch *>(&Buf(Source));\
+   if (Batch == nullptr)\
+      return CL_INVALID_MEM_OBJECT;\
+   H(\
+      vector<double> Values = CLASS(*Batch).method(*Batch);\
+      for (size_t i = 0; i < Values.size(); i++)\
+         Results[i] = Values[i];\
+   )\
+}
+
+REDUCE_BATCH_OP(ocipMinBatch_V, Min)
+REDUCE_BATCH_OP(ocipMaxBatch_V, Max)
+REDUCE_BATCH_OP(ocipMinAbsBatch_V, MinAbs)
+REDUCE_BATCH_OP(ocipMaxAbsBatch_V, MaxAbs)
+REDUCE_BATCH_OP(ocipSumBatch_V, Sum)
+REDUCE_BATCH_OP(ocipMeanBatch_V, Mean)
+REDUCE_BATCH_OP(ocipMeanSqrBatch_V, MeanSqr)
+
 
 
 // Helpers
-SProgramList& GetList()
+shared_ptr<SProgramList> GetList(COpenCL& CL)
 {
-   COpenCL * Context = g_CurrentContext;
-   
-   if (Context == nullptr)
-      throw cl::Error(CL_INVALID_CONTEXT, "No current context - use ocipInitialize() first");
+   lock_guard<mutex> Lock(g_RegistryMutex);
+
+   auto It = g_ProgramList.find(&CL);
+   if (It == g_ProgramList.end())
+      throw cl::Error(CL_INVALID_CONTEXT, "The context of the image has been uninitialized");
+
+   return It->second;
+}
+
+COpenCL * FindContext(ocipContext Context)
+{
+   COpenCL * CL = (COpenCL *) Context;
+
+   if (CL == nullptr)
+      return nullptr;
+
+   lock_guard<mutex> Lock(g_RegistryMutex);
+
+   if (g_ProgramList.find(CL) == g_ProgramList.end())
+      return nullptr;
+
+   return CL;
+}
+
+shared_ptr<PinnedMemory> FindPinnedMemory(void * HostPtr)
+{
+   if (HostPtr == nullptr)
+      return nullptr;
+
+   lock_guard<mutex> Lock(g_RegistryMutex);
 
-   if (g_ProgramList[Context] == nullptr)
-      throw cl::Error(CL_INVALID_CONTEXT, "Invalid current context - ocipInitialize()");
+   auto It = g_PinnedMemory.find(HostPtr);
+   if (It == g_PinnedMemory.end())
+      return nullptr;
 
-   return *g_ProgramList[Context];
+   return It->second;
 }
@@ -42,6 +42,7 @@ int main(int argc, char * argv[])
    void * SourceData = NULL;
    void * ResultData = NULL;
    ocipImage Source, Result;
+   ocipBuffer SourceBuffer, ResultBuffer;
 
 
    // Load source image
@@ -114,6 +115,31 @@ int main(int argc, char * argv[])
    lodepng_encode24_file("result.png", (unsigned char*) ResultData, ImageInfo.Width, ImageInfo.Height);
 
 
+   // Image buffers process the packed 3 channel image directly
+   Error = ocipCreateImageBuffer(&SourceBuffer, ImageInfo, SourceData, CL_MEM_READ_ONLY);
+   Error = ocipCreateImageBuffer(&ResultBuffer, ImageInfo, ResultData, CL_MEM_READ_WRITE);
+
+   Error = ocipPrepareImageBufferFilters(SourceBuffer);
+   Error = ocipPrepareImageBufferTresholding(SourceBuffer);
+
+   // Sobel filter then keep only the strong edges
+   Error = ocipSobel_V(SourceBuffer, ResultBuffer, 3);
+   Error = ocipTresholdLT_V(ResultBuffer, ResultBuffer, 64, 0);
+
+   if (Error != CL_SUCCESS)
+   {
+      printf("Unable to process the image buffer : %s\n", ocipGetErrorName(Error));
+      return Error;
+   }
+
+   Error = ocipReadImageBuffer(ResultBuffer);
+
+   lodepng_encode24_file("result_edges.png", (unsigned char*) ResultData, ImageInfo.Width, ImageInfo.Height);
+
+   Error = ocipReleaseImageBuffer(SourceBuffer);
+   Error = ocipReleaseImageBuffer(ResultBuffer);
+
+
    // Free images on the device
    Error = ocipReleaseImage(Source);
    Error = ocipReleaseImage(Result);
@@ -27,44 +27,12 @@ constant sampler_t sampler = CLK_NORMALIZED_COORDS_FALSE | CLK_ADDRESS_CLAMP_TO_
 
 // Type must be specified when compiling this file, example : for unsigned 8 bit "-D U8"
 
-#ifdef S8
-#define TYPE char
-#endif
-
-#ifdef U8
-#define TYPE uchar
-#define UNSIGNED
-#endif
-
-#ifdef S16
-#define TYPE short
-#endif
-
-#ifdef U16
-#define TYPE ushort
-#define UNSIGNED
-#endif
+#include "Vector_Types.cl"
 
-#ifdef S32
-#define TYPE int
-#endif
-
-#ifdef U32
-#define TYPE uint
+#if !defined(FLOAT) && !defined(S8) && !defined(S16) && !defined(S32)
 #define UNSIGNED
 #endif
 
-#ifdef F32
-#define TYPE float
-#define FLOAT
-#endif
-
-#ifndef TYPE
-#define TYPE uchar
-#define UNSIGNED
-#endif
-
-
 #ifdef FLOAT
    // For float
    #define PIXEL float4
@@ -84,28 +52,36 @@ constant sampler_t sampler = CLK_NORMALIZED_COORDS_FALSE | CLK_ADDRESS_CLAMP_TO_
    #endif // UNSIGNED
 #endif // FLOAT
 
+#ifdef HALF
+   #define READ(ptr, index) vload_half(index, ptr)
+   #define WRITE(ptr, index, val) vstore_half(val, index, ptr)
+#else // HALF
+   #define READ(ptr, index) ptr[index]
+   #define WRITE(ptr, index, val) ptr[index] = val
+#endif // HALF
+
 #define BEGIN \
    const int gx = get_global_id(0);\
    const int gy = get_global_id(1);\
    const int2 pos = { gx, gy };
 
-kernel void Convert3CTo4C(global const TYPE * source, write_only image2d_t dest, uint source_step)
+kernel void Convert3CTo4C(global const SCALAR * source, write_only image2d_t dest, uint source_step)
 {
    BEGIN
 
    int source_index = gx * 3 + gy * source_step;
 
    PIXEL color;
-   color.x = source[source_index + 0];
-   color.y = source[source_index + 1];
-   color.z = source[source_index + 2];
+   color.x = READ(source, source_index + 0);
+   color.y = READ(source, source_index + 1);
+   color.z = READ(source, source_index + 2);
    color.w = 255;
 
    // Write pixel
    WRITE_IMAGE(dest, pos, color);
 }
 
-kernel void Convert4CTo3C(read_only image2d_t source, global TYPE * dest, uint dest_step)
+kernel void Convert4CTo3C(read_only image2d_t source, global SCALAR * dest, uint dest_step)
 {
    BEGIN
 
@@ -114,7 +90,7 @@ kernel void Convert4CTo3C(read_only image2d_t source, global TYPE * dest, uint d
 
    // Write pixel
    int dest_index = gx * 3 + gy * dest_step;
-   dest[dest_index + 0] = color.x;
-   dest[dest_index + 1] = color.y;
-   dest[dest_index + 2] = color.z;
+   WRITE(dest, dest_index + 0, color.x);
+   WRITE(dest, dest_index + 1, color.y);
+   WRITE(dest, dest_index + 2, color.z);
 }
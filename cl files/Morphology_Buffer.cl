@@ -23,50 +23,24 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 // Type must be specified when compiling this file, example : for unsigned 8 bit "-D U8"
+// Each worker processes 1 value : width is Width * channels and each channel of packed images (like RGB) is processed separately
 
 #ifndef LW
 #define LW 16  // local width - kernels using local cache need to use a local range of LWxLW
 #endif
 
-#ifdef S8
-#define SCALAR char
-#endif
-
-#ifdef U8
-#define SCALAR uchar
-#endif
-
-#ifdef S16
-#define SCALAR short
-#endif
-
-#ifdef U16
-#define SCALAR ushort
-#endif
-
-#ifdef S32
-#define SCALAR int
-#endif
-
-#ifdef U32
-#define SCALAR uint
-#endif
-
-#ifdef F32
-#define SCALAR float
-#define FLOAT
-#endif
+#include "Vector_Types.cl"
 
-#ifndef SCALAR
-#define SCALAR uchar
+#ifndef HALF
+#define VALUE SCALAR
+#define READ(ptr, index) ptr[index]
+#define WRITE(ptr, index, val) ptr[index] = val
+#else
+#define VALUE float
+#define READ(ptr, index) vload_half(index, ptr)
+#define WRITE(ptr, index, val) vstore_half(val, index, ptr)
 #endif
 
-#define INPUT_SPACE global    // If input images are read only, they can be set to be in "constant" memory space, with possible speed improvements
-
-
-#define CONCATENATE(a, b) _CONCATENATE(a, b)
-#define _CONCATENATE(a, b) a ## b
-
 #define BEGIN  \
    const int gx = get_global_id(0);\
    const int gy = get_global_id(1);\
@@ -75,18 +49,18 @@
 
 
 #define MORPHOLOGY_IMPL(name, op, mask_width) \
-kernel void CONCATENATE(name, mask_width) (INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int width, int height)\
+kernel void CONCATENATE(name, mask_width) (INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int width, int height, int channels)\
 {\
    BEGIN\
    \
-   SCALAR Value = source[gy * src_step + gx];\
+   VALUE Value = READ(source, gy * src_step + gx);\
    \
    const int mask_size = mask_width / 2;\
    \
-   if (gy - mask_size < 0 || gy + mask_size >= height || gx - mask_size < 0 || gx + mask_size >= width)\
+   if (gy - mask_size < 0 || gy + mask_size >= height || gx - mask_size * channels < 0 || gx + mask_size * channels >= width)\
    {\
       /* Would look outside of image - Save unmodified result*/\
-      dest[gy * dst_step + gx] = Value;\
+      WRITE(dest, gy * dst_step + gx, Value);\
       return;\
    }\
    \
@@ -95,28 +69,28 @@ kernel void CONCATENATE(name, mask_width) (INPUT_SPACE const SCALAR * source, gl
       int py = gy + y;\
       for (int x = -mask_size; x <= mask_size; x++)\
       {\
-         SCALAR Val = source[py * src_step + gx + x];\
+         VALUE Val = READ(source, py * src_step + gx + x * channels);\
          Value = op(Val, Value);\
       }\
       \
    }\
    \
    /* Save result */\
-   dest[gy * dst_step + gx] = Value;\
+   WRITE(dest, gy * dst_step + gx, Value);\
 }
 
 
 #define MORPHOLOGY_CACHED(name, op, mask_width) \
 __attribute__((reqd_work_group_size(LW, LW, 1)))\
-kernel void CONCATENATE(CONCATENATE(name, mask_width), _cached) (INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int width, int height)\
+kernel void CONCATENATE(CONCATENATE(name, mask_width), _cached) (INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int width, int height, int channels)\
 {\
    BEGIN\
    const int lid = get_local_id(1) * get_local_size(0) + get_local_id(0);\
    \
-   SCALAR Value = source[gy * src_step + gx];\
+   VALUE Value = READ(source, gy * src_step + gx);\
    \
    /* Cache pixels */\
-   local SCALAR cache[LW * LW];\
+   local VALUE cache[LW * LW];\
    cache[lid] = Value;\
    barrier(CLK_LOCAL_MEM_FENCE);\
    \
@@ -129,10 +103,10 @@ kernel void CONCATENATE(CONCATENATE(name, mask_width), _cached) (INPUT_SPACE con
    \
    const int mask_size = mask_width / 2;\
    \
-   if (gy - mask_size < 0 || gy + mask_size >= height || gx - mask_size < 0 || gx + mask_size >= width)\
+   if (gy - mask_size < 0 || gy + mask_size >= height || gx - mask_size * channels < 0 || gx + mask_size * channels >= width)\
    {\
       /* Would look outside of image - Save unmodified result */\
-      dest[gy * dst_step + gx] = Value;\
+      WRITE(dest, gy * dst_step + gx, Value);\
       return;\
    }\
    \
@@ -144,7 +118,7 @@ kernel void CONCATENATE(CONCATENATE(name, mask_width), _cached) (INPUT_SPACE con
       {\
          for (int x = -mask_size; x <= mask_size; x++)\
          {\
-            SCALAR Val = source[py * src_step + gx + x];\
+            VALUE Val = READ(source, py * src_step + gx + x * channels);\
             Value = op(Val, Value);\
          }\
       \
@@ -153,10 +127,10 @@ kernel void CONCATENATE(CONCATENATE(name, mask_width), _cached) (INPUT_SPACE con
       {\
          for (int x = -mask_size; x <= mask_size; x++)\
          {\
-            int px = gx + x;\
-            SCALAR Val;\
+            int px = gx + x * channels;\
+            VALUE Val;\
             if (px < x_cache_begin || px >= x_cache_end)\
-               Val = source[py * src_step + px];\
+               Val = READ(source, py * src_step + px);\
             else\
             {\
                /* Read from cache */\
@@ -173,7 +147,7 @@ kernel void CONCATENATE(CONCATENATE(name, mask_width), _cached) (INPUT_SPACE con
    }\
    \
    /* Save result */\
-   dest[gy * dst_step + gx] = Value;\
+   WRITE(dest, gy * dst_step + gx, Value);\
 }
 
 // Each size has a standard version and a version with local cache - host code will choose which version to use
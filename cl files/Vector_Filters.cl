@@ -25,41 +25,7 @@
 // Make at least a 4C version of the filters
 
 // Type must be specified when compiling this file, example : for unsigned 8 bit "-D U8"
-#ifdef S8
-#define SCALAR char
-#endif
-
-#ifdef U8
-#define SCALAR uchar
-#endif
-
-#ifdef S16
-#define SCALAR short
-#endif
-
-#ifdef U16
-#define SCALAR ushort
-#endif
-
-#ifdef S32
-#define SCALAR int
-#endif
-
-#ifdef U32
-#define SCALAR uint
-#endif
-
-#ifdef F32
-#define SCALAR float
-#define FLOAT
-#endif
-
-#ifndef SCALAR
-#define SCALAR uchar
-#endif
-
-#define INPUT_SPACE global    // If input images are read only, they can be set to be in "constant" memory space, with possible speed improvements
-
+#include "Vector_Types.cl"
 
 #ifdef __NV_CL_C_VERSION
 #define NVIDIA_PLATFORM
@@ -83,25 +49,27 @@
 #endif
 
 
+// Each worker processes 1 value : the _1C kernels also filter images with more channels (like packed RGB)
+// by processing each channel separately, the neighbours of a value are channels values away
+// The third dimension of the range is the index of the image in a batch of images (stacked one after the other)
 #define BEGIN \
    const int gx = get_global_id(0);\
    const int gy = get_global_id(1);\
    const int2 pos = { gx, gy };\
-   src_step /= sizeof(SCALAR);
+   src_step /= sizeof(SCALAR);\
+   source += get_global_id(2) * height * src_step;
 
 
-#define CONCATENATE(a, b) _CONCATENATE(a, b)
-#define _CONCATENATE(a, b) a ## b
+#define DST_INDEX(step) ((get_global_id(2) * height + get_global_id(1)) * step / sizeof(SCALAR) + get_global_id(0))
 
-#ifndef FLOAT
-#define CONVERT_SCALAR(val) CONCATENATE(CONCATENATE(convert_, SCALAR), _sat) (val)  // Example : convert_uchar_sat(val)
+#ifndef HALF
+#define READ_IMAGE_1C(img, step, pos) (float)(img[(pos).y * step + (pos).x])
+#define WRITE_IMAGE_1C(img, step, val) img[DST_INDEX(step)] = CONVERT_SCALAR(val)
 #else
-#define CONVERT_SCALAR(val) val
+#define READ_IMAGE_1C(img, step, pos) vload_half((pos).y * step + (pos).x, img)
+#define WRITE_IMAGE_1C(img, step, val) vstore_half(val, DST_INDEX(step), img)
 #endif
 
-#define READ_IMAGE_1C(img, step, pos) (float)(img[(pos).y * step + (pos).x])
-#define WRITE_IMAGE_1C(img, step, val) img[get_global_id(1) * step / sizeof(SCALAR) + get_global_id(0)] = CONVERT_SCALAR(val)
-
 
 
 #define TYPE2 CONCATENATE(SCALAR, 2)          // Example : uchar2
@@ -114,7 +82,7 @@
    {\
       for (int y = -size; y <= size; y++)\
          for (int x = -size; x <= size; x++)\
-            sum += matrix[Index++] * READ_IMAGE_1C(source, src_step, pos + (int2)(x, y));\
+            sum += matrix[Index++] * READ_IMAGE_1C(source, src_step, pos + (int2)(x * channels, y));\
    }\
    break;
 
@@ -154,7 +122,7 @@
    CONVOLUTION_CASE(31) /* 63*/\
    }
 
-float Convolution_1C(INPUT_SPACE const SCALAR * source, int src_step, int height, CONST_ARG float * matrix, private int matrix_width)
+float Convolution_1C(INPUT_SPACE const SCALAR * source, int src_step, int height, int channels, CONST_ARG float * matrix, private int matrix_width)
 {
    BEGIN
 
@@ -162,10 +130,10 @@ float Convolution_1C(INPUT_SPACE const SCALAR * source, int src_step, int height
    private float sum = 0;
    int Index = 0;
 
-   if (pos.x < mask_size || pos.y < mask_size)
+   if (pos.x < mask_size * channels || pos.y < mask_size)
       return 0;
 
-   if (pos.x >= src_step - mask_size || pos.y >= height - mask_size)
+   if (pos.x >= src_step - mask_size * channels || pos.y >= height - mask_size)
       return 0;
 
    CONVOLUTION_SWITCH
@@ -173,10 +141,10 @@ float Convolution_1C(INPUT_SPACE const SCALAR * source, int src_step, int height
    return sum;
 }
 
-void convolution_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height,
+void convolution_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels,
                     CONST_ARG float * matrix, private int matrix_width)
 {
-   float sum = Convolution_1C(source, src_step, height, matrix, matrix_width);
+   float sum = Convolution_1C(source, src_step, height, channels, matrix, matrix_width);
 
    WRITE_IMAGE_1C(dest, dst_step, sum);
 }
@@ -186,19 +154,19 @@ float Combine_1C(float color1, float color2)
    return sqrt(color1 * color1 + color2 * color2);
 }
 
-kernel void gaussian_blur_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, constant const float * matrix, private int mask_size)
+kernel void gaussian_blur_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels, constant const float * matrix, private int mask_size)
 {
-   // Does gaussian blur on first channel of image - receives a pre-calculated mask
+   // Does gaussian blur - receives a pre-calculated mask
 
    BEGIN
 
    private float sum = 0;
    int Index = 0;
 
-   if (pos.x < mask_size || pos.y < mask_size)
+   if (pos.x < mask_size * channels || pos.y < mask_size)
       return;
 
-   if (pos.x >= src_step - mask_size || pos.y >= height - mask_size)
+   if (pos.x >= src_step - mask_size * channels || pos.y >= height - mask_size)
       return;
 
    CONVOLUTION_SWITCH
@@ -206,17 +174,17 @@ kernel void gaussian_blur_1C(INPUT_SPACE const SCALAR * source, global SCALAR *
    WRITE_IMAGE_1C(dest, dst_step, sum);
 }
 
-kernel void gaussian3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void gaussian3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrix[9] = {
       1.f/16, 2.f/16, 1.f/16,
       2.f/16, 4.f/16, 2.f/16,
       1.f/16, 2.f/16, 1.f/16};
 
-   convolution_1C(source, dest, src_step, dst_step, height, matrix, 3);
+   convolution_1C(source, dest, src_step, dst_step, height, channels, matrix, 3);
 }
 
-kernel void gaussian5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void gaussian5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrix[25] = {
        2.f/571,  7.f/571,  12.f/571,  7.f/571,  2.f/571,
@@ -225,30 +193,30 @@ kernel void gaussian5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest
        7.f/571, 31.f/571,  52.f/571, 31.f/571,  7.f/571,
        2.f/571,  7.f/571,  12.f/571,  7.f/571,  2.f/571};
 
-   convolution_1C(source, dest, src_step, dst_step, height, matrix, 5);
+   convolution_1C(source, dest, src_step, dst_step, height, channels, matrix, 5);
 }
 
-kernel void sobelH3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void sobelH3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrix[9] = {
       -1, -2, -1,
        0,  0,  0,
        1,  2,  1};
 
-   convolution_1C(source, dest, src_step, dst_step, height, matrix, 3);
+   convolution_1C(source, dest, src_step, dst_step, height, channels, matrix, 3);
 }
 
-kernel void sobelV3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void sobelV3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrix[9] = {
       1, 0, -1,
       2, 0, -2,
       1, 0, -1};
 
-   convolution_1C(source, dest, src_step, dst_step, height, matrix, 3);
+   convolution_1C(source, dest, src_step, dst_step, height, channels, matrix, 3);
 }
 
-kernel void sobelH5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void sobelH5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrix[25] = {
       -1, -4,  -6, -4, -1,
@@ -257,10 +225,10 @@ kernel void sobelH5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest,
        2,  8,  12,  8,  2,
        1,  4,   6,  4,  1};
 
-   convolution_1C(source, dest, src_step, dst_step, height, matrix, 5);
+   convolution_1C(source, dest, src_step, dst_step, height, channels, matrix, 5);
 }
 
-kernel void sobelV5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void sobelV5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrix[25] = {
       1,  2, 0,  -2, -1,
@@ -269,20 +237,20 @@ kernel void sobelV5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest,
       4,  8, 0,  -8, -4,
       1,  2, 0,  -2, -1};
 
-   convolution_1C(source, dest, src_step, dst_step, height, matrix, 5);
+   convolution_1C(source, dest, src_step, dst_step, height, channels, matrix, 5);
 }
 
-kernel void sobelCross3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void sobelCross3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrix[9] = {
       -1, 0,  1,
        0, 0,  0,
        1, 0, -1};
 
-   convolution_1C(source, dest, src_step, dst_step, height, matrix, 3);
+   convolution_1C(source, dest, src_step, dst_step, height, channels, matrix, 3);
 }
 
-kernel void sobelCross5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void sobelCross5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrix[25] = {
       -1, -2, 0,  2,  1,
@@ -291,10 +259,10 @@ kernel void sobelCross5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * de
        2,  4, 0, -4, -2,
        1,  2, 0, -2, -1};
 
-   convolution_1C(source, dest, src_step, dst_step, height, matrix, 5);
+   convolution_1C(source, dest, src_step, dst_step, height, channels, matrix, 5);
 }
 
-kernel void sobel3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void sobel3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrixH[9] = {
       -1, -2, -1,
@@ -306,15 +274,15 @@ kernel void sobel3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, i
       2, 0, -2,
       1, 0, -1};
 
-   float sumH = Convolution_1C(source, src_step, height, matrixH, 3);
-   float sumV = Convolution_1C(source, src_step, height, matrixV, 3);
+   float sumH = Convolution_1C(source, src_step, height, channels, matrixH, 3);
+   float sumV = Convolution_1C(source, src_step, height, channels, matrixV, 3);
 
    float Result = Combine_1C(sumH, sumV);
 
    WRITE_IMAGE_1C(dest, dst_step, Result);
 }
 
-kernel void sobel5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void sobel5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrixH[25] = {
       -1, -4,  -6, -4, -1,
@@ -330,33 +298,33 @@ kernel void sobel5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, i
       4,  8, 0,  -8, -4,
       1,  2, 0,  -2, -1};
 
-   float sumH = Convolution_1C(source, src_step, height, matrixH, 5);
-   float sumV = Convolution_1C(source, src_step, height, matrixV, 5);
+   float sumH = Convolution_1C(source, src_step, height, channels, matrixH, 5);
+   float sumV = Convolution_1C(source, src_step, height, channels, matrixV, 5);
 
    WRITE_IMAGE_1C(dest, dst_step, Combine_1C(sumH, sumV));
 }
 
-kernel void prewittH3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void prewittH3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrix[9] = {
       -1, -1, -1,
        0,  0,  0,
        1,  1,  1};
 
-   convolution_1C(source, dest, src_step, dst_step, height, matrix, 3);
+   convolution_1C(source, dest, src_step, dst_step, height, channels, matrix, 3);
 }
 
-kernel void prewittV3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void prewittV3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrix[9] = {
       1, 0, -1,
       1, 0, -1,
       1, 0, -1};
 
-   convolution_1C(source, dest, src_step, dst_step, height, matrix, 3);
+   convolution_1C(source, dest, src_step, dst_step, height, channels, matrix, 3);
 }
 
-kernel void prewitt3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void prewitt3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrixH[9] = {
       -1, -1, -1,
@@ -368,33 +336,33 @@ kernel void prewitt3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest,
       1, 0, -1,
       1, 0, -1};
 
-   float sumH = Convolution_1C(source, src_step, height, matrixH, 3);
-   float sumV = Convolution_1C(source, src_step, height, matrixV, 3);
+   float sumH = Convolution_1C(source, src_step, height, channels, matrixH, 3);
+   float sumV = Convolution_1C(source, src_step, height, channels, matrixV, 3);
 
    WRITE_IMAGE_1C(dest, dst_step, Combine_1C(sumH, sumV));
 }
 
-kernel void scharrH3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void scharrH3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrix[9] = {
       -3, -10, -3,
        0,   0,  0,
        3,  10,  3};
 
-   convolution_1C(source, dest, src_step, dst_step, height, matrix, 3);
+   convolution_1C(source, dest, src_step, dst_step, height, channels, matrix, 3);
 }
 
-kernel void scharrV3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void scharrV3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrix[9] = {
        -3, 0,  3,
       -10, 0, 10,
        -3, 0,  3};
 
-   convolution_1C(source, dest, src_step, dst_step, height, matrix, 3);
+   convolution_1C(source, dest, src_step, dst_step, height, channels, matrix, 3);
 }
 
-kernel void scharr3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void scharr3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrixH[9] = {
       -3, -10, -3,
@@ -406,23 +374,23 @@ kernel void scharr3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest,
       -10, 0, 10,
        -3, 0,  3};
 
-   float sumH = Convolution_1C(source, src_step, height, matrixH, 3);
-   float sumV = Convolution_1C(source, src_step, height, matrixV, 3);
+   float sumH = Convolution_1C(source, src_step, height, channels, matrixH, 3);
+   float sumV = Convolution_1C(source, src_step, height, channels, matrixV, 3);
 
    WRITE_IMAGE_1C(dest, dst_step, Combine_1C(sumH, sumV));
 }
 
-kernel void hipass3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void hipass3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrix[9] = {
       -1, -1, -1,
       -1,  8, -1,
       -1, -1, -1};
 
-   convolution_1C(source, dest, src_step, dst_step, height, matrix, 3);
+   convolution_1C(source, dest, src_step, dst_step, height, channels, matrix, 3);
 }
 
-kernel void hipass5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void hipass5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrix[25] = {
       -1, -1, -1, -1, -1,
@@ -431,20 +399,20 @@ kernel void hipass5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest,
       -1, -1, -1, -1, -1,
       -1, -1, -1, -1, -1};
 
-   convolution_1C(source, dest, src_step, dst_step, height, matrix, 5);
+   convolution_1C(source, dest, src_step, dst_step, height, channels, matrix, 5);
 }
 
-kernel void laplace3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void laplace3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrix[9] = {
       -1, -1, -1,
       -1,  8, -1,
       -1, -1, -1};
 
-   convolution_1C(source, dest, src_step, dst_step, height, matrix, 3);
+   convolution_1C(source, dest, src_step, dst_step, height, channels, matrix, 3);
 }
 
-kernel void laplace5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void laplace5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrix[25] = {
       -1, -3, -4, -3, -1,
@@ -453,17 +421,17 @@ kernel void laplace5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest,
       -3,  0,  6,  0, -3,
       -1, -3, -4, -3, -1};
 
-   convolution_1C(source, dest, src_step, dst_step, height, matrix, 5);
+   convolution_1C(source, dest, src_step, dst_step, height, channels, matrix, 5);
 }
 
-kernel void sharpen3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void sharpen3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    CONST float matrix[9] = {
       -1.f/8, -1.f/8, -1.f/8,
       -1.f/8, 16.f/8, -1.f/8,
       -1.f/8, -1.f/8, -1.f/8};
 
-   convolution_1C(source, dest, src_step, dst_step, height, matrix, 3);
+   convolution_1C(source, dest, src_step, dst_step, height, channels, matrix, 3);
 }
 
 // Smooth convolution_1C (box filter - a convolution_1C matrix filled with 1/Nb)
@@ -473,11 +441,11 @@ kernel void sharpen3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest,
    {\
       for (int y = -size; y <= size; y++)\
          for (int x = -size; x <= size; x++)\
-            sum += factor * READ_IMAGE_1C(source, src_step, pos + (int2)(x, y));\
+            sum += factor * READ_IMAGE_1C(source, src_step, pos + (int2)(x * channels, y));\
    }\
    break;
 
-kernel void smooth_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int matrix_width)    // Box filter
+kernel void smooth_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels, int matrix_width)    // Box filter
 {
    BEGIN
 
@@ -485,10 +453,10 @@ kernel void smooth_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, i
    float sum = 0;
    float factor = 1.f / (matrix_width * matrix_width);
 
-   if (pos.x < mask_size || pos.y < mask_size)
+   if (pos.x < mask_size * channels || pos.y < mask_size)
       return;
 
-   if (pos.x >= src_step - mask_size || pos.y >= height - mask_size)
+   if (pos.x >= src_step - mask_size * channels || pos.y >= height - mask_size)
       return;
 
    CONVOLUTION_SWITCH
@@ -564,7 +532,7 @@ float calculate_median5(float * values)
 #define LW 16  // local width
 #define MW 3   // Matrix width
 __attribute__((reqd_work_group_size(LW, LW, 1)))
-kernel void median3_cached_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void median3_cached_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    BEGIN
 
@@ -585,10 +553,10 @@ kernel void median3_cached_1C(INPUT_SPACE const SCALAR * source, global SCALAR *
    const int matrix_width = MW;
    const int mask_size = matrix_width / 2;
 
-   if (pos.x < mask_size || pos.y < mask_size)
+   if (pos.x < mask_size * channels || pos.y < mask_size)
       return;
 
-   if (pos.x >= src_step - mask_size || pos.y >= height - mask_size)
+   if (pos.x >= src_step - mask_size * channels || pos.y >= height - mask_size)
       return;
 
    // Read values in a local array
@@ -601,13 +569,13 @@ kernel void median3_cached_1C(INPUT_SPACE const SCALAR * source, global SCALAR *
       if (py < y_cache_begin || py >= y_cache_end)
       {
          for (int x = -mask_size; x <= mask_size; x++)
-            values[Index++] = READ_IMAGE_1C(source, src_step, pos + (int2)(x, y));
+            values[Index++] = READ_IMAGE_1C(source, src_step, pos + (int2)(x * channels, y));
       }
       else
       {
          for (int x = -mask_size; x <= mask_size; x++)
          {
-            int px = gx + x;
+            int px = gx + x * channels;
             if (px < x_cache_begin || px >= x_cache_end)
                values[Index++] = READ_IMAGE_1C(source, src_step, (int2)(px, py));
             else
@@ -631,17 +599,17 @@ kernel void median3_cached_1C(INPUT_SPACE const SCALAR * source, global SCALAR *
    WRITE_IMAGE_1C(dest, dst_step, Result);
 }
 
-kernel void median3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void median3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    BEGIN
 
    const int matrix_width = MW;
    const int mask_size = matrix_width / 2;
 
-   if (pos.x < mask_size || pos.y < mask_size)
+   if (pos.x < mask_size * channels || pos.y < mask_size)
       return;
 
-   if (pos.x >= src_step - mask_size || pos.y >= height - mask_size)
+   if (pos.x >= src_step - mask_size * channels || pos.y >= height - mask_size)
       return;
 
    // Read values in a local array
@@ -650,7 +618,7 @@ kernel void median3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest,
    int Index = 0;
    for (int y = -mask_size; y <= mask_size; y++)
       for (int x = -mask_size; x <= mask_size; x++)
-         values[Index++] = READ_IMAGE_1C(source, src_step, pos + (int2)(x, y));
+         values[Index++] = READ_IMAGE_1C(source, src_step, pos + (int2)(x * channels, y));
 
    // Calculate median
    float Result = calculate_median3(values);
@@ -663,17 +631,17 @@ kernel void median3_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest,
 #undef MW
 #define MW 5   // Matrix width
 
-kernel void median5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height)
+kernel void median5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int height, int channels)
 {
    BEGIN
 
    const int matrix_width = MW;
    const int mask_size = matrix_width / 2;
 
-   if (pos.x < mask_size || pos.y < mask_size)
+   if (pos.x < mask_size * channels || pos.y < mask_size)
       return;
 
-   if (pos.x >= src_step - mask_size || pos.y >= height - mask_size)
+   if (pos.x >= src_step - mask_size * channels || pos.y >= height - mask_size)
       return;
 
    // Read values in a local array
@@ -682,7 +650,7 @@ kernel void median5_1C(INPUT_SPACE const SCALAR * source, global SCALAR * dest,
    int Index = 0;
    for (int y = -mask_size; y <= mask_size; y++)
       for (int x = -mask_size; x <= mask_size; x++)
-         values[Index++] = READ_IMAGE_1C(source, src_step, pos + (int2)(x, y));
+         values[Index++] = READ_IMAGE_1C(source, src_step, pos + (int2)(x * channels, y));
 
    // Calculate median
    float Result = calculate_median5(values);
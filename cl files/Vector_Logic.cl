@@ -24,54 +24,11 @@
 
 // Assumes vector size of VEC_WIDTH - must be called with img_type.VectorRange(VEC_WIDTH)
 // Type must be specified when compiling this file, example : for unsigned 8 bit "-D U8"
+// VEC_WIDTH is normally specified when compiling, from the preferred vector width of the device, example : "-D VEC_WIDTH=16"
 
 // Optimization note : On my GTX 680 - fastest version is with no WITH_PADDING and VEC_WIDTH==8
 
-#define VEC_WIDTH 8    // Number of items done in parralel per worker - Can be 4, 8 or 16
-
-#ifdef S8
-#define SCALAR char
-#endif
-
-#ifdef U8
-#define SCALAR uchar
-#endif
-
-#ifdef S16
-#define SCALAR short
-#endif
-
-#ifdef U16
-#define SCALAR ushort
-#endif
-
-#ifdef S32
-#define SCALAR int
-#endif
-
-#ifdef U32
-#define SCALAR uint
-#endif
-
-#ifdef F32
-#define SCALAR float
-#define FLOAT
-#endif
-
-#ifndef SCALAR
-#define SCALAR uchar
-#endif
-
-#define INPUT_SPACE global    // If input images are read only, they can be set to be in "constant" memory space, with possible speed improvements
-
-#define CONCATENATE(a, b) _CONCATENATE(a, b)
-#define _CONCATENATE(a, b) a ## b
-
-#define TYPE CONCATENATE(SCALAR, VEC_WIDTH)  // Example : uchar16
-
-#define CONVERT(val) CONCATENATE(CONCATENATE(convert_, TYPE), _sat) (val)           // Example : convert_uchar16_sat(val)
-#define CONVERT_SCALAR(val) CONCATENATE(CONCATENATE(convert_, SCALAR), _sat) (val)  // Example : convert_uchar_sat(val)
-#define CONVERT_FLOAT(val) CONCATENATE(convert_float, VEC_WIDTH) (val)              // Example : convert_float16(val)
+#include "Vector_Types.cl"
 
 #define BEGIN  \
    const int gx = get_global_id(0);	/* x divided by VEC_WIDTH */ \
@@ -95,27 +52,27 @@
 // If using a small ROI on a big image, this version will be faster
 
 #define PREPARE_SCALAR(i) \
-   const INPUT_SPACE SCALAR * src_scalar = (const INPUT_SPACE SCALAR *) source;\
-   global SCALAR * dst_scalar = (global SCALAR *)dest;\
+   const INPUT_SPACE SCALAR * src_scalar = (const INPUT_SPACE SCALAR *) source + src_offset;\
+   global SCALAR * dst_scalar = (global SCALAR *) dest + dst_offset;\
    const SCALAR src = src_scalar[(gy * src_step) + i];\
    global SCALAR * dst = dst_scalar + (gy * dst_step) + i;
 
 #define PREPARE_SCALAR2(i) \
-   const INPUT_SPACE SCALAR * src1_scalar = (const INPUT_SPACE SCALAR *) source1;\
-   const INPUT_SPACE SCALAR * src2_scalar = (const INPUT_SPACE SCALAR *) source2;\
-   global SCALAR * dst_scalar = (global SCALAR *) dest;\
+   const INPUT_SPACE SCALAR * src1_scalar = (const INPUT_SPACE SCALAR *) source1 + src1_offset;\
+   const INPUT_SPACE SCALAR * src2_scalar = (const INPUT_SPACE SCALAR *) source2 + src2_offset;\
+   global SCALAR * dst_scalar = (global SCALAR *) dest + dst_offset;\
    const SCALAR src1 = src1_scalar[(gy * src1_step) + i];\
    const SCALAR src2 = src2_scalar[(gy * src2_step) + i];\
    global SCALAR * dst = dst_scalar + (gy * dst_step) + i;
 
 #define PREPARE_VECTOR \
-   const TYPE src = source[(gy * src_step) / VEC_WIDTH + gx];\
-   global TYPE * dst = dest + (gy * dst_step) / VEC_WIDTH + gx;
+   const TYPE src = LOAD_TYPE_AT(source, src_offset, (gy * src_step) / VEC_WIDTH + gx);
 
 #define PREPARE_VECTOR2 \
-   const TYPE src1 = source1[(gy * src1_step) / VEC_WIDTH + gx];\
-   const TYPE src2 = source2[(gy * src2_step) / VEC_WIDTH + gx];\
-   global TYPE * dst = dest + (gy * dst_step) / VEC_WIDTH + gx;
+   const TYPE src1 = LOAD_TYPE_AT(source1, src1_offset, (gy * src1_step) / VEC_WIDTH + gx);\
+   const TYPE src2 = LOAD_TYPE_AT(source2, src2_offset, (gy * src2_step) / VEC_WIDTH + gx);
+
+#define VECTOR_OP(code) STORE_TYPE_AT(dest, dst_offset, (gy * dst_step) / VEC_WIDTH + gx, code)
 
 // TODO : Test performance with one worker per scalar instead of a loop
 #define LAST_WORKER(code) \
@@ -152,13 +109,13 @@
 // This version needs a 1D Range : cl::NDRange(Width * Height * Channels / VEC_WIDTH, 1, 1)
 
 #define PREPARE_VECTOR \
-   const TYPE src = source[gx];\
-   global TYPE * dst = dest + gx;
+   const TYPE src = LOAD_TYPE_AT(source, src_offset, gx);
 
 #define PREPARE_VECTOR2 \
-   const TYPE src1 = source1[gx];\
-   const TYPE src2 = source2[gx];\
-   global TYPE * dst = dest + gx;
+   const TYPE src1 = LOAD_TYPE_AT(source1, src1_offset, gx);\
+   const TYPE src2 = LOAD_TYPE_AT(source2, src2_offset, gx);
+
+#define VECTOR_OP(code) STORE_TYPE_AT(dest, dst_offset, gx, code)
 
 #define LAST_WORKER(code)
 #define LAST_WORKER2(code)
@@ -170,33 +127,36 @@
 #define BINARY_OP(name, code) \
 __attribute__(( vec_type_hint(TYPE) ))\
 kernel void name(INPUT_SPACE const TYPE * source1, INPUT_SPACE const TYPE * source2,\
-                global TYPE * dest, int src1_step, int src2_step, int dst_step, int width)\
+                global TYPE * dest, int src1_step, int src2_step, int dst_step,\
+                int src1_offset, int src2_offset, int dst_offset, int width)\
 {\
    BEGIN2\
    LAST_WORKER2(code)\
    PREPARE_VECTOR2\
-   *dst = code;\
+   VECTOR_OP(code);\
 }
 
 #define CONSTANT_OP(name, code) \
 __attribute__(( vec_type_hint(TYPE) ))\
-kernel void name(INPUT_SPACE const TYPE * source, global TYPE * dest, int src_step, int dst_step, int width, uint value_in)\
+kernel void name(INPUT_SPACE const TYPE * source, global TYPE * dest, int src_step, int dst_step, int src_offset, int dst_offset,\
+                 int width, uint value_in)\
 {\
    BEGIN\
    SCALAR value = CONVERT_SCALAR(value_in);\
    LAST_WORKER(code)\
    PREPARE_VECTOR\
-   *dst = code;\
+   VECTOR_OP(code);\
 }
 
 #define UNARY_OP(name, code) \
 __attribute__(( vec_type_hint(TYPE) ))\
-kernel void name(INPUT_SPACE const TYPE * source, global TYPE * dest, int src_step, int dst_step, int width)\
+kernel void name(INPUT_SPACE const TYPE * source, global TYPE * dest, int src_step, int dst_step, int src_offset, int dst_offset,\
+                 int width)\
 {\
    BEGIN\
    LAST_WORKER(code)\
    PREPARE_VECTOR\
-   *dst = code;\
+   VECTOR_OP(code);\
 }
 
 
@@ -24,52 +24,34 @@
 
 // Assumes vector size of VEC_WIDTH - must be called with img_type.VectorRange(VEC_WIDTH)
 // Type must be specified when compiling this file, example : for unsigned 8 bit "-D U8"
+// VEC_WIDTH is normally specified when compiling, from the preferred vector width of the device, example : "-D VEC_WIDTH=16"
 
-#define VEC_WIDTH 4
-
-#ifdef S8
-#define SCALAR char
-#endif
-
-#ifdef U8
-#define SCALAR uchar
-#endif
-
-#ifdef S16
-#define SCALAR short
-#endif
-
-#ifdef U16
-#define SCALAR ushort
-#endif
-
-#ifdef S32
-#define SCALAR int
-#endif
-
-#ifdef U32
-#define SCALAR uint
-#endif
-
-#ifdef F32
-#define SCALAR float
-#define FLOAT
-#endif
-
-#ifndef SCALAR
-#define SCALAR uchar
+#ifndef VEC_WIDTH
+#define VEC_WIDTH 4    // Number of items done per worker
 #endif
 
-#define INPUT_SPACE global    // If input images are read only, they can be set to be in "constant" memory space, with possible speed improvements
+#include "Vector_Types.cl"
 
 #define BEGIN  \
    const int gx = get_global_id(0) * VEC_WIDTH;\
    const int gy = get_global_id(1);\
    src_step /= sizeof(SCALAR);\
-   dst_step /= sizeof(SCALAR);
+   dst_step /= sizeof(SCALAR);\
+   source += src_offset;\
+   dest += dst_offset;
+
+#ifndef HALF
+#define VALUE SCALAR
+#define LOAD(ptr, index) ptr[index]
+#define STORE(ptr, index, val) ptr[index] = val
+#else
+#define VALUE float
+#define LOAD(ptr, index) vload_half(index, ptr)
+#define STORE(ptr, index, val) vstore_half(val, index, ptr)
+#endif
 
 
-SCALAR do_lut(SCALAR input, constant const uint * levels, constant const uint * values, int nb)
+VALUE do_lut(VALUE input, constant const uint * levels, constant const uint * values, int nb)
 {
    if (input < levels[0])
       return input;
@@ -84,7 +66,7 @@ SCALAR do_lut(SCALAR input, constant const uint * levels, constant const uint *
    return values[k];
 }
 
-SCALAR do_lut_linear(SCALAR input, constant const float * levels, constant const float * values, int nb)
+VALUE do_lut_linear(VALUE input, constant const float * levels, constant const float * values, int nb)
 {
    if (input < levels[0])
       return input;
@@ -107,7 +89,7 @@ SCALAR do_lut_linear(SCALAR input, constant const float * levels, constant const
    return values[k] + Diff;
 }
 
-kernel void lut(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int width,
+kernel void lut(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int src_offset, int dst_offset, int width,
                    constant const uint * levels, constant const uint * values, int nb)
 {
    BEGIN
@@ -115,16 +97,16 @@ kernel void lut(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src
    if (VEC_WIDTH > 1 && gx + VEC_WIDTH > width)
    {
       for (int x = gx; x < width; x++)
-         dest[gy * dst_step + x] = do_lut(source[gy * src_step + x], levels, values, nb);
+         STORE(dest, gy * dst_step + x, do_lut(LOAD(source, gy * src_step + x), levels, values, nb));
 
       return;
    }
 
    for (int x = gx; x < gx + VEC_WIDTH; x++)
-      dest[gy * dst_step + x] = do_lut(source[gy * src_step + x], levels, values, nb);
+      STORE(dest, gy * dst_step + x, do_lut(LOAD(source, gy * src_step + x), levels, values, nb));
 }
 
-kernel void lut_linear(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int width,
+kernel void lut_linear(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int src_offset, int dst_offset, int width,
                        constant const float * levels, constant const float * values, int nb)
 {
    BEGIN
@@ -132,18 +114,18 @@ kernel void lut_linear(INPUT_SPACE const SCALAR * source, global SCALAR * dest,
    if (VEC_WIDTH > 1 && gx + VEC_WIDTH > width)
    {
       for (int x = gx; x < width; x++)
-         dest[gy * dst_step + x] = do_lut_linear(source[gy * src_step + x], levels, values, nb);
+         STORE(dest, gy * dst_step + x, do_lut_linear(LOAD(source, gy * src_step + x), levels, values, nb));
 
       return;
    }
 
    for (int x = gx; x < gx + VEC_WIDTH; x++)
-      dest[gy * dst_step + x] = do_lut_linear(source[gy * src_step + x], levels, values, nb);
+      STORE(dest, gy * dst_step + x, do_lut_linear(LOAD(source, gy * src_step + x), levels, values, nb));
 }
 
 #ifndef FLOAT
 // Optimized LUT : All values in source image must be between 0 and 255, there must be excatly 256 levels
-kernel void lut_256(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int width,
+kernel void lut_256(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int src_offset, int dst_offset, int width,
                    constant const uchar * levels)
 {
    BEGIN
@@ -161,7 +143,7 @@ kernel void lut_256(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int
 }
 
 __attribute__((reqd_work_group_size(16, 16, 1)))
-kernel void lut_256_cached(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step,
+kernel void lut_256_cached(INPUT_SPACE const SCALAR * source, global SCALAR * dest, int src_step, int dst_step, int src_offset, int dst_offset,
                    constant const uchar * levels)
 {
    BEGIN
@@ -23,43 +23,15 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 
-#ifdef S8
-#define SCALAR char
-#endif
+#include "Vector_Types.cl"
 
-#ifdef U8
-#define SCALAR uchar
-#endif
-
-#ifdef S16
-#define SCALAR short
-#endif
-
-#ifdef U16
-#define SCALAR ushort
-#endif
-
-#ifdef S32
-#define SCALAR int
-#endif
-
-#ifdef U32
-#define SCALAR uint
-#endif
-
-#ifdef F32
-#define SCALAR float
-#define FLOAT
-#endif
-
-#ifndef SCALAR
-#define SCALAR uchar
-#endif
-
-#define INPUT_SPACE global    // If input images are read only, they can be set to be in "constant" memory space, with possible speed improvements
-
-#define CONCATENATE(a, b) _CONCATENATE(a, b)
-#define _CONCATENATE(a, b) a ## b
+#ifndef HALF
+   #define VALUE SCALAR
+   #define READ(ptr, index) ptr[index]
+#else  // HALF
+   #define VALUE float
+   #define READ(ptr, index) vload_half(index, ptr)
+#endif // HALF
 
 #ifdef FLOAT
    #define ABS fabs
@@ -67,9 +39,6 @@
    #define ABS abs
 #endif // FLOAT
 
-#define CONCATENATE(a, b) _CONCATENATE(a, b)
-#define _CONCATENATE(a, b) a ## b
-
 #define BUFFER_LENGTH 256
 
 #define DO_REDUCE(function, index1, index2) \
@@ -84,6 +53,9 @@
 #define WIDTH1_BITS 4   // Number of bits represented by WIDTH1 (8 -> 3, 16 -> 4, 32 -> 5)
 #define POSI(i) (int2)(gx + i, gy)
 
+// For batches of images (stacked one after the other), the third dimension of the range is the index of the image
+// and img_height is the height of each image - each image has its own results
+
 // This version handles images of any size - it will be a bit slower
 #define REDUCE(name, type, preop, fun1, postop1, fun2, postop2) \
 __attribute__((reqd_work_group_size(16, 16, 1)))\
@@ -96,16 +68,17 @@ kernel void name(INPUT_SPACE const SCALAR * source, global float * result, int s
    const int gy = get_global_id(1);\
    const int lid = get_local_id(1) * get_local_size(0) + get_local_id(0);\
    src_step /= sizeof(SCALAR);\
+   source += get_global_id(2) * img_height * src_step;\
    float Weight;\
    \
    if (gx < img_width && gy < img_height)\
    {\
-      type Res = preop(source[(gy * src_step) + gx + 0]);\
+      type Res = preop(READ(source, (gy * src_step) + gx + 0));\
       int Nb = 1;\
       for (int i = WIDTH1; i < WIDTH1 * WIDTH1; i += WIDTH1)\
          if (gx + i < img_width)\
          {\
-            Res = fun1(Res, (type) preop(source[(gy * src_step) + gx + i]));\
+            Res = fun1(Res, (type) preop(READ(source, (gy * src_step) + gx + i)));\
             Nb++;\
          }\
       \
@@ -170,10 +143,11 @@ kernel void name(INPUT_SPACE const SCALAR * source, global float * result, int s
    const int gy = get_global_id(1);\
    const int lid = get_local_id(1) * get_local_size(0) + get_local_id(0);\
    src_step /= sizeof(SCALAR);\
+   source += get_global_id(2) * img_height * src_step;\
    \
-   type Res = preop(source[(gy * src_step) + gx + 0]);\
+   type Res = preop(READ(source, (gy * src_step) + gx + 0));\
    for (int i = WIDTH1; i < WIDTH1 * WIDTH1; i += WIDTH1)\
-      Res = fun1(Res, (type) preop(source[(gy * src_step) + gx + i]));\
+      Res = fun1(Res, (type) preop(READ(source, (gy * src_step) + gx + i)));\
    \
    buffer[lid] = postop1(Res, WIDTH1);\
    \
@@ -243,6 +217,7 @@ REDUCE_FLUSH(CONCATENATE(name, _flush), type, preop, fun1, postop1, fun2, postop
 #define FLOAT_ATOMIC(name, fun) \
 void name(global float * result, float value, int nb_pixels)\
 {\
+   result += get_global_id(2);\
    global int * intPtr = (global int *) result;\
    bool ExchangeDone = false;\
    while (!ExchangeDone)\
@@ -261,18 +236,18 @@ FLOAT_ATOMIC(atomic_maxf, max)
 
 void store_value(global float * result_buffer, float value, int nb_pixels)
 {
-   const int gid = get_group_id(1) * get_num_groups(0) + get_group_id(0);
-   const int offset = get_num_groups(0) * get_num_groups(1);
+   const int gid = (get_group_id(2) * get_num_groups(1) + get_group_id(1)) * get_num_groups(0) + get_group_id(0);
+   const int offset = get_num_groups(0) * get_num_groups(1) * get_num_groups(2);
    result_buffer[gid] = value;
    result_buffer[offset + gid] = nb_pixels;
 }
 
 
 //            name             type    preop fun1  post1  fun2  postop2
-REDUCE_KERNEL(reduce_min,      SCALAR, NOOP, min,  NOOP2, MIN2,  atomic_minf)
-REDUCE_KERNEL(reduce_max,      SCALAR, NOOP, max,  NOOP2, MAX2,  atomic_maxf)
-REDUCE_KERNEL(reduce_minabs,   SCALAR, ABS,  min,  NOOP2, MIN2,  atomic_minf)
-REDUCE_KERNEL(reduce_maxabs,   SCALAR, ABS,  max,  NOOP2, MAX2,  atomic_maxf)
+REDUCE_KERNEL(reduce_min,      VALUE,  NOOP, min,  NOOP2, MIN2,  atomic_minf)
+REDUCE_KERNEL(reduce_max,      VALUE,  NOOP, max,  NOOP2, MAX2,  atomic_maxf)
+REDUCE_KERNEL(reduce_minabs,   VALUE,  ABS,  min,  NOOP2, MIN2,  atomic_minf)
+REDUCE_KERNEL(reduce_maxabs,   VALUE,  ABS,  max,  NOOP2, MAX2,  atomic_maxf)
 REDUCE_KERNEL(reduce_sum,      float,  NOOP, SUM,  NOOP2, SUM2,  store_value)
 REDUCE_KERNEL(reduce_count_nz, float,  NO_Z, SUM,  NOOP2, SUM2,  store_value)
 REDUCE_KERNEL(reduce_mean,     float,  NOOP, SUM,  DIV,   MEAN2, store_value)
@@ -282,10 +257,23 @@ REDUCE_KERNEL(reduce_mean_sqr, float,  SQR,  SUM,  DIV,   MEAN2, store_value)
 // Initialize result to a valid value
 kernel void init(INPUT_SPACE const SCALAR * source, global float * result)
 {
-   *result = (float) *source;
+   *result = (float) READ(source, 0);
 }
 
 kernel void init_abs(INPUT_SPACE const SCALAR * source, global float * result)
 {
-   *result = (float) ABS(*source);
+   *result = (float) ABS(READ(source, 0));
+}
+
+// Initialize the result of each image of a batch - image_step is the size of each image, in bytes
+kernel void init_batch(INPUT_SPACE const SCALAR * source, global float * result, int image_step)
+{
+   const int gid = get_global_id(0);
+   result[gid] = (float) READ(source, gid * (image_step / sizeof(SCALAR)));
+}
+
+kernel void init_abs_batch(INPUT_SPACE const SCALAR * source, global float * result, int image_step)
+{
+   const int gid = get_global_id(0);
+   result[gid] = (float) ABS(READ(source, gid * (image_step / sizeof(SCALAR))));
 }
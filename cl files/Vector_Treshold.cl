@@ -0,0 +1,166 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: Vector_Treshold.cl
+//! @date   : Oct 2026
+//!
+//! @brief  : Tresholding operations on image buffers
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+// Assumes vector size of VEC_WIDTH - must be called with img_type.VectorRange(VEC_WIDTH)
+// Type must be specified when compiling this file, example : for unsigned 8 bit "-D U8"
+// VEC_WIDTH is normally specified when compiling, from the preferred vector width of the device, example : "-D VEC_WIDTH=16"
+
+#include "Vector_Types.cl"
+
+#define BEGIN  \
+   const int gx = get_global_id(0);	/* x divided by VEC_WIDTH */ \
+   const int gy = get_global_id(1);\
+   src_step /= sizeof(SCALAR);\
+   dst_step /= sizeof(SCALAR);
+
+#define BEGIN2 \
+   const int gx = get_global_id(0);	/* x divided by VEC_WIDTH */ \
+   const int gy = get_global_id(1);\
+   src1_step /= sizeof(SCALAR);\
+   src2_step /= sizeof(SCALAR);\
+   dst_step /= sizeof(SCALAR);
+
+
+// The operations are written with the type T, which is float for the scalar version and FTYPE for the vector version
+// Comparisons of vectors give a vector condition, so the ?: operator selects each item separately
+
+#define PREPARE_SCALAR(i) \
+   typedef float T;\
+   const INPUT_SPACE SCALAR * src_scalar = (const INPUT_SPACE SCALAR *) source + src_offset;\
+   global SCALAR * dst_scalar = (global SCALAR *) dest + dst_offset;\
+   const T src = LOAD_SCALAR(src_scalar, (gy * src_step) + i);
+
+#define PREPARE_SCALAR2(i) \
+   typedef float T;\
+   const INPUT_SPACE SCALAR * src1_scalar = (const INPUT_SPACE SCALAR *) source1 + src1_offset;\
+   const INPUT_SPACE SCALAR * src2_scalar = (const INPUT_SPACE SCALAR *) source2 + src2_offset;\
+   global SCALAR * dst_scalar = (global SCALAR *) dest + dst_offset;\
+   const T src1 = LOAD_SCALAR(src1_scalar, (gy * src1_step) + i);\
+   const T src2 = LOAD_SCALAR(src2_scalar, (gy * src2_step) + i);
+
+#define SCALAR_OP(code) STORE_SCALAR(dst_scalar, (gy * dst_step) + i, code)
+
+#define PREPARE_VECTOR \
+   typedef FTYPE T;\
+   const T src = LOAD_VECTOR_AT(source, src_offset, (gy * src_step) / VEC_WIDTH + gx);
+
+#define PREPARE_VECTOR2 \
+   typedef FTYPE T;\
+   const T src1 = LOAD_VECTOR_AT(source1, src1_offset, (gy * src1_step) / VEC_WIDTH + gx);\
+   const T src2 = LOAD_VECTOR_AT(source2, src2_offset, (gy * src2_step) / VEC_WIDTH + gx);
+
+#define VECTOR_OP(code) STORE_VECTOR_AT(dest, dst_offset, (gy * dst_step) / VEC_WIDTH + gx, code)
+
+#define LAST_WORKER(code) \
+   if ((gx + 1) * VEC_WIDTH > width)\
+   {\
+      /* Last worker on the current row for an image that has a width that is not a multiple of VEC_WIDTH*/\
+      for (int i = gx * VEC_WIDTH; i < width; i++)\
+      {\
+         PREPARE_SCALAR(i)\
+         SCALAR_OP(code);\
+      }\
+      return;\
+   }
+
+#define LAST_WORKER2(code) \
+   if ((gx + 1) * VEC_WIDTH > width)\
+   {\
+      /* Last worker on the current row for an image that has a width that is not a multiple of VEC_WIDTH*/\
+      for (int i = gx * VEC_WIDTH; i < width; i++)\
+      {\
+         PREPARE_SCALAR2(i)\
+         SCALAR_OP(code);\
+      }\
+      return;\
+   }
+
+
+#define TRESHOLD_OP(name, code) \
+__attribute__(( vec_type_hint(HINT_TYPE) ))\
+kernel void name(INPUT_SPACE const TYPE * source, global TYPE * dest, int src_step, int dst_step, int src_offset, int dst_offset,\
+                 int width, float thresh, float value)\
+{\
+   BEGIN\
+   LAST_WORKER(code)\
+   PREPARE_VECTOR\
+   VECTOR_OP(code);\
+}
+
+#define BINARY_OP(name, code) \
+__attribute__(( vec_type_hint(HINT_TYPE) ))\
+kernel void name(INPUT_SPACE const TYPE * source1, INPUT_SPACE const TYPE * source2,\
+                global TYPE * dest, int src1_step, int src2_step, int dst_step,\
+                int src1_offset, int src2_offset, int dst_offset, int width)\
+{\
+   BEGIN2\
+   LAST_WORKER2(code)\
+   PREPARE_VECTOR2\
+   VECTOR_OP(code);\
+}
+
+#define CONSTANT_OP(name, code) \
+__attribute__(( vec_type_hint(HINT_TYPE) ))\
+kernel void name(INPUT_SPACE const TYPE * source, global TYPE * dest, int src_step, int dst_step, int src_offset, int dst_offset,\
+                 int width, float value)\
+{\
+   BEGIN\
+   LAST_WORKER(code)\
+   PREPARE_VECTOR\
+   VECTOR_OP(code);\
+}
+
+
+TRESHOLD_OP(tresholdLT, (src < thresh ? (T) value : src))
+TRESHOLD_OP(tresholdGT, (src > thresh ? (T) value : src))
+
+#define TRESHOLD_GTLT (src > treshGT ? (T) valueHigher : (src < threshLT ? (T) valueLower : src))
+
+__attribute__(( vec_type_hint(HINT_TYPE) ))
+kernel void tresholdGTLT(INPUT_SPACE const TYPE * source, global TYPE * dest, int src_step, int dst_step, int src_offset, int dst_offset, int width,
+                         float threshLT, float valueLower, float treshGT, float valueHigher)
+{
+   BEGIN
+   LAST_WORKER(TRESHOLD_GTLT)
+   PREPARE_VECTOR
+   VECTOR_OP(TRESHOLD_GTLT);
+}
+
+BINARY_OP(img_tresh_LT, (src1 < src2 ? src1 : src2))
+BINARY_OP(img_tresh_LQ, (src1 <= src2 ? src1 : src2))
+BINARY_OP(img_tresh_EQ, (src1 == src2 ? src1 : src2))
+BINARY_OP(img_tresh_GQ, (src1 >= src2 ? src1 : src2))
+BINARY_OP(img_tresh_GT, (src1 > src2 ? src1 : src2))
+
+BINARY_OP(img_compare_LT, (src1 < src2 ? (T) 1 : (T) 0))
+BINARY_OP(img_compare_LQ, (src1 <= src2 ? (T) 1 : (T) 0))
+BINARY_OP(img_compare_EQ, (src1 == src2 ? (T) 1 : (T) 0))
+BINARY_OP(img_compare_GQ, (src1 >= src2 ? (T) 1 : (T) 0))
+BINARY_OP(img_compare_GT, (src1 > src2 ? (T) 1 : (T) 0))
+
+CONSTANT_OP(compare_LT, (src < value ? (T) 1 : (T) 0))
+CONSTANT_OP(compare_LQ, (src <= value ? (T) 1 : (T) 0))
+CONSTANT_OP(compare_EQ, (src == value ? (T) 1 : (T) 0))
+CONSTANT_OP(compare_GQ, (src >= value ? (T) 1 : (T) 0))
+CONSTANT_OP(compare_GT, (src > value ? (T) 1 : (T) 0))
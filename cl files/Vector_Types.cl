@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: Vector_Types.cl
+//! @date   : Oct 2026
+//!
+//! @brief  : Pixel types, conversions and load/store macros shared by the image buffer programs
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+// Included by the programs that work on image buffers and by the expressions of ExpressionEvaluator, it is not a program by itself
+// Type must be specified when compiling, example : for unsigned 8 bit "-D U8"
+// VEC_WIDTH is normally specified when compiling, from the preferred vector width of the device, example : "-D VEC_WIDTH=16"
+// Values are loaded and stored with LOAD_VECTOR / STORE_VECTOR (or LOAD_SCALAR / STORE_SCALAR) and computed as float
+
+#ifndef VEC_WIDTH
+#define VEC_WIDTH 8    // Number of items done in parralel per worker - Can be 2, 4, 8 or 16
+#endif
+
+#ifdef S8
+#define SCALAR char
+#endif
+
+#ifdef U8
+#define SCALAR uchar
+#endif
+
+#ifdef S16
+#define SCALAR short
+#endif
+
+#ifdef U16
+#define SCALAR ushort
+#endif
+
+#ifdef S32
+#define SCALAR int
+#endif
+
+#ifdef U32
+#define SCALAR uint
+#endif
+
+#ifdef F32
+#define SCALAR float
+#define FLOAT
+#endif
+
+#ifdef F16
+#define SCALAR half
+#define FLOAT
+#define HALF      // half is only a storage format : values are read with vload_half and written with vstore_half, computations are done in float
+#endif
+
+#ifndef SCALAR
+#define SCALAR uchar
+#endif
+
+#define INPUT_SPACE global    // If input images are read only, they can be set to be in "constant" memory space, with possible speed improvements
+
+#define CONCATENATE(a, b) _CONCATENATE(a, b)
+#define _CONCATENATE(a, b) a ## b
+
+#ifndef HALF
+#define TYPE CONCATENATE(SCALAR, VEC_WIDTH)  // Example : uchar16
+#define HINT_TYPE TYPE
+#else
+#define TYPE SCALAR                          // half vectors can't be dereferenced, they are accessed with vload_halfN / vstore_halfN
+#define HINT_TYPE FTYPE
+#endif
+#define FTYPE CONCATENATE(float, VEC_WIDTH)  // Example : float16
+
+#ifndef FLOAT
+#define CONVERT(val) CONCATENATE(CONCATENATE(convert_, TYPE), _sat) (val)           // Example : convert_uchar16_sat(val)
+#define CONVERT_SCALAR(val) CONCATENATE(CONCATENATE(convert_, SCALAR), _sat) (val)  // Example : convert_uchar_sat(val)
+#define CONVERT_FLOAT(val) CONCATENATE(convert_float, VEC_WIDTH) (val)              // Example : convert_float16(val)
+#else
+#define CONVERT(val) val
+#define CONVERT_SCALAR(val) val
+#define CONVERT_FLOAT(val) val
+#endif
+
+#ifndef HALF
+#define LOAD_VECTOR(ptr, index) CONVERT_FLOAT(ptr[index])
+#define STORE_VECTOR(ptr, index, val) ptr[index] = CONVERT(val)
+#define LOAD_SCALAR(ptr, index) convert_float(ptr[index])
+#define STORE_SCALAR(ptr, index, val) ptr[index] = CONVERT_SCALAR(val)
+#else
+#define LOAD_VECTOR(ptr, index) CONCATENATE(vload_half, VEC_WIDTH) (index, ptr)            // Example : vload_half16(index, ptr)
+#define STORE_VECTOR(ptr, index, val) CONCATENATE(vstore_half, VEC_WIDTH) (val, index, ptr) // Example : vstore_half16(val, index, ptr)
+#define LOAD_SCALAR(ptr, index) vload_half(index, ptr)
+#define STORE_SCALAR(ptr, index, val) vstore_half(val, index, ptr)
+#endif
+
+// Image buffer views that don't start on a vector boundary are given to the kernels as the buffer that contains them
+// and the position of their first value (offset, in number of values) : their vectors are accessed with vloadN / vstoreN
+#define VLOADN CONCATENATE(vload, VEC_WIDTH)    // Example : vload16
+#define VSTOREN CONCATENATE(vstore, VEC_WIDTH)  // Example : vstore16
+
+#ifndef HALF
+#define LOAD_TYPE_AT(ptr, offset, index) ((offset) == 0 ? (ptr)[index] : VLOADN(index, (INPUT_SPACE const SCALAR *) (ptr) + (offset)))
+#define STORE_TYPE_AT(ptr, offset, index, val) \
+   do { if ((offset) == 0) (ptr)[index] = (val); else VSTOREN(val, index, (global SCALAR *) (ptr) + (offset)); } while (0)
+#define LOAD_VECTOR_AT(ptr, offset, index) CONVERT_FLOAT(LOAD_TYPE_AT(ptr, offset, index))
+#define STORE_VECTOR_AT(ptr, offset, index, val) STORE_TYPE_AT(ptr, offset, index, CONVERT(val))
+#else
+#define LOAD_VECTOR_AT(ptr, offset, index) LOAD_VECTOR((ptr) + (offset), index)
+#define STORE_VECTOR_AT(ptr, offset, index, val) STORE_VECTOR((ptr) + (offset), index, val)
+#endif
@@ -48,6 +48,11 @@ typedef unsigned int uint;    ///< Shortcut for the often used 'unsigend int'
 /// The SImage structure is used to tell the library the type and size of images when creating image objects.
 typedef struct SImage SImage;
 
+#include <SProfilingRecord.h>
+
+/// The SProfilingRecord structure receives the timing of an operation done by the device - see ocipGetProfilingRecords()
+typedef struct SProfilingRecord SProfilingRecord;
+
 
 /// Type used as return values of most ocip calls.
 /// Successful calls will return CL_SUCCESS (0) while
@@ -59,11 +64,12 @@ typedef struct _cl_context * ocipContext; ///< A handle to a context
 typedef struct _cl_image   * ocipImage;   ///< A handle to an image
 typedef struct _cl_buffer  * ocipBuffer;  ///< A handle to an image buffer
 typedef struct _cl_program * ocipProgram; ///< A handle to a program
+typedef struct _cl_graph   * ocipGraph;   ///< A handle to a recorded graph of operations
 
 
 /// Initialization.
 /// Initializes OpenCL, creates an execution context, sets the new context as the current context
-/// and returns the context handle.
+/// of the calling thread and returns the context handle.
 /// The handle must be closed by calling ocipUninitialize when the context (or the whole library) is no longer needed.
 /// ocipInitialize() can be called more than once, in that case, each context must be
 /// released individually by a call to ocipUninitialize(). Images, Buffers and Programs
@@ -89,9 +95,18 @@ ocipError ocip_API ocipUninitialize(ocipContext Context);
 /// Advanced users of the library can use multiple contexts to either :
 /// - Use multiple OpenCL devices (multi-GPU or CPU & GPU)
 /// - Run multiple operations at a time on the same GPU (to get 100% usage)
-/// \param Context : The context to use for the next library calls
+/// The current context is specific to each thread : calling ocipChangeContext() only changes
+/// the context used by the next library calls of the calling thread.
+/// So each thread of a multi-threaded program can use its own context (and its own device queue).
+/// A context must not be used by more than one thread at the same time.
+/// The functions that have an Ex suffix take the context as argument instead of using the current context.
+/// \param Context : The context to use for the next library calls of the calling thread
 ocipError ocip_API ocipChangeContext(ocipContext Context);
 
+/// Returns the current context of the calling thread.
+/// \param ContextPtr : Receives the handle of the current context, NULL if the thread has no current context
+ocipError ocip_API ocipGetCurrentContext(ocipContext * ContextPtr);
+
 
 /// Set the Path of .cl files.
 /// It is necessary to call this functione before creating any program
@@ -99,6 +114,24 @@ ocipError ocip_API ocipChangeContext(ocipContext Context);
 void ocip_API ocipSetCLFilesPath(const char * Path);
 
 
+/// Read the .cl files instead of using the sources compiled in the library.
+/// When the library is built with its makefile, the .cl files are compiled in the library
+/// and ocipSetCLFilesPath is not needed.
+/// Set Use to 1 to read the .cl files from the path given to ocipSetCLFilesPath instead,
+/// which is useful when modifying the .cl files. Default is 0.
+/// \param Use : 1 to read the .cl files, 0 to use the sources compiled in the library
+void ocip_API ocipUseCLFiles(ocipBool Use);
+
+
+/// Set the Path of the compiled program cache.
+/// When set, compiled programs are saved in this folder and are loaded from it
+/// by later runs instead of being compiled again, which greatly reduces the time
+/// needed to prepare programs at startup.
+/// The folder must exist. Set to NULL or "" to disable the cache (default).
+/// \param Path : Full path of the folder where compiled programs are stored
+void ocip_API ocipSetBinaryCachePath(const char * Path);
+
+
 /// Returns the name of the error code
 /// \param Error : An OpenCL error code
 /// \return the name of the given error code
@@ -110,11 +143,86 @@ ocip_API const char * ocipGetErrorName(ocipError Error);
 /// \param BufferLength : Number of elements in the Name buffer
 ocipError ocip_API ocipGetDeviceName(char * Name, uint BufferLength);
 
+/// Same as ocipGetDeviceName() but for the given context
+ocipError ocip_API ocipGetDeviceNameEx(ocipContext Context, char * Name, uint BufferLength);
+
 
 /// Waits until all queued operations of this context are done.
 /// When this function returns, the device will have finished all operations previously issued on this context.
 ocipError ocip_API ocipFinish();
 
+/// Same as ocipFinish() but for the given context
+ocipError ocip_API ocipFinishEx(ocipContext Context);
+
+
+/// Use a separate command queue for transfers in the current context.
+/// When enabled, ocipSend* and ocipRead* operations are done in a second queue
+/// so they can overlap with processing operations (for example, sending frame N+1 while
+/// frame N is being processed). Processing operations issued after a Send wait for it and
+/// a Read waits for the processing operations issued before it.
+/// A Send waits for the processing operations that still use the image it writes to,
+/// so use different images for the frames that are processed at the same time to get the most overlap.
+/// \param Use : 1 to use a separate queue for transfers, 0 to use a single queue (default)
+ocipError ocip_API ocipUseTransferQueue(ocipBool Use);
+
+/// Same as ocipUseTransferQueue() but for the given context
+ocipError ocip_API ocipUseTransferQueueEx(ocipContext Context, ocipBool Use);
+
+
+/// Enables profiling of the operations done by the device in the current context.
+/// When enabled, the device timings of every processing operation and of every
+/// Send and Read are recorded. Use ocipGetProfilingRecords() to retreive them.
+/// Profiling adds a small overhead to each operation, so it is disabled by default.
+/// \param Enable : 1 to enable profiling, 0 to disable it and discard the records
+ocipError ocip_API ocipEnableProfiling(ocipBool Enable);
+
+/// Same as ocipEnableProfiling() but for the given context
+ocipError ocip_API ocipEnableProfilingEx(ocipContext Context, ocipBool Enable);
+
+
+/// Enables automatic tuning of the work-group sizes of the kernels in the current context.
+/// When enabled, the first launches of each kernel try a few candidate work-group sizes
+/// and the fastest one is used for the following launches.
+/// When a binary cache path is set with ocipSetBinaryCachePath(), the results are saved
+/// in that folder and later runs on the same device use them directly.
+/// Disabled by default.
+/// \param Enable : 1 to enable tuning, 0 to let OpenCL choose the work-group sizes
+ocipError ocip_API ocipEnableWorkGroupTuning(ocipBool Enable);
+
+/// Same as ocipEnableWorkGroupTuning() but for the given context
+ocipError ocip_API ocipEnableWorkGroupTuningEx(ocipContext Context, ocipBool Enable);
+
+
+/// Retreives the profiling records of the current context.
+/// Waits for the recorded operations to be done and copies their timings, oldest first.
+/// The copied records are removed from the context.
+/// \param Records : Array that receives the records, can be NULL to get the number of records available
+/// \param NbRecords : On input : number of elements in the Records array.
+///         On output : number of records copied to Records, or number of records available if Records is NULL
+ocipError ocip_API ocipGetProfilingRecords(SProfilingRecord * Records, uint * NbRecords);
+
+/// Same as ocipGetProfilingRecords() but for the given context
+ocipError ocip_API ocipGetProfilingRecordsEx(ocipContext Context, SProfilingRecord * Records, uint * NbRecords);
+
+
+/// Allocates page-locked (pinned) host memory in the current context.
+/// Images and image buffers created with a pointer to pinned memory as ImageData
+/// transfer their data at full DMA bandwidth, without a staging copy by the driver.
+/// An image buffer created with pinned memory and CL_MEM_USE_HOST_PTR in its flags
+/// uses the pinned memory directly as device memory, ocipSendImageBuffer and ocipReadImageBuffer
+/// then only map and unmap the memory.
+/// \param HostPtr : Receives the pointer to the allocated memory
+/// \param Size : Size of the memory in bytes
+ocipError ocip_API ocipAllocHost(void ** HostPtr, size_t Size);
+
+/// Same as ocipAllocHost() but for the given context
+ocipError ocip_API ocipAllocHostEx(ocipContext Context, void ** HostPtr, size_t Size);
+
+/// Frees pinned memory allocated with ocipAllocHost().
+/// The memory stays valid until the images created with it are released.
+/// \param HostPtr : Pointer received from ocipAllocHost()
+ocipError ocip_API ocipFreeHost(void * HostPtr);
+
 
 // Images
 
@@ -139,6 +247,25 @@ ocipError ocip_API ocipFinish();
 /// \param flags : The type of device memory to use, allowed values : CL_MEM_READ_WRITE, CL_MEM_WRITE_ONLY, CL_MEM_READ_ONLY
 ocipError ocip_API ocipCreateImage( ocipImage * ImagePtr, SImage Image, void * ImageData, cl_mem_flags flags);
 
+/// Same as ocipCreateImage() but for the given context
+ocipError ocip_API ocipCreateImageEx(ocipContext Context, ocipImage * ImagePtr, SImage Image, void * ImageData, cl_mem_flags flags);
+
+/// Creates a view of a rectangular region of an image.
+/// The view uses the device memory of the parent, the processing functions given the view work only on the region
+/// and write directly in the parent. All images given to a function must have the same origin.
+/// Views are accepted by the arithmetic, logic, lut, tresholding, conversion, color, filter and morphology functions.
+/// The view can't be sent nor read, send and read the parent instead.
+/// The view must be released with ocipReleaseImage() before the parent is released.
+/// \param ImagePtr : The value pointed to by ImagePtr will be set to the handle of the new view
+/// \param Parent : The image that contains the region
+/// \param X, Y : Position of the region in the parent, in pixels
+/// \param Width, Height : Size of the region, in pixels - the region must be inside the parent
+ocipError ocip_API ocipCreateImageView(ocipImage * ImagePtr, ocipImage Parent, uint X, uint Y, uint Width, uint Height);
+
+/// Same as ocipCreateImageView() but for the given context
+ocipError ocip_API ocipCreateImageViewEx(ocipContext Context, ocipImage * ImagePtr, ocipImage Parent,
+                                          uint X, uint Y, uint Width, uint Height);
+
 /// Sends the image to the device.
 /// The image data will referenced by the pointer in the SImage structure given during image creation
 /// will be transferred to the device memory.
@@ -185,6 +312,44 @@ ocipError ocip_API ocipReleaseImage(ocipImage Image);
 /// \param flags : The type of device memory to use, allowed values : CL_MEM_READ_WRITE, CL_MEM_WRITE_ONLY, CL_MEM_READ_ONLY
 ocipError ocip_API ocipCreateImageBuffer( ocipBuffer * BufferPtr, SImage Image, void * ImageData, cl_mem_flags flags);
 
+/// Same as ocipCreateImageBuffer() but for the given context
+ocipError ocip_API ocipCreateImageBufferEx(ocipContext Context, ocipBuffer * BufferPtr, SImage Image, void * ImageData, cl_mem_flags flags);
+
+/// Creates a view of a rectangular region of an image buffer.
+/// The view can be used with all the functions that accept an image buffer, the processing is done
+/// only on the region. The pointwise functions (arithmetic, logic, LUT and tresholding) always use the memory
+/// of the parent directly. The other functions also do when the device alignment allows it,
+/// otherwise the region is copied in the device when needed.
+/// The view can't be sent nor read, send and read the parent instead.
+/// The view must be released with ocipReleaseImageBuffer() before the parent is released.
+/// \param BufferPtr : The value pointed to by BufferPtr will be set to the handle of the new view
+/// \param Parent : The image buffer that contains the region
+/// \param X, Y : Position of the region in the parent, in pixels
+/// \param Width, Height : Size of the region, in pixels - the region must be inside the parent
+ocipError ocip_API ocipCreateImageBufferView(ocipBuffer * BufferPtr, ocipBuffer Parent, uint X, uint Y, uint Width, uint Height);
+
+/// Same as ocipCreateImageBufferView() but for the given context
+ocipError ocip_API ocipCreateImageBufferViewEx(ocipContext Context, ocipBuffer * BufferPtr, ocipBuffer Parent,
+                                                uint X, uint Y, uint Width, uint Height);
+
+/// Creates a batch of images of the same size, stored one after the other in a single image buffer.
+/// The batch can be used with all the functions that accept an image buffer and is sent and read in a single transfer.
+/// Pointwise functions process the whole batch in one launch, like one tall image.
+/// Filters process each image of the batch separately, also in one launch.
+/// The reductions that end with Batch_V give one value per image of the batch.
+/// The batch must be released with ocipReleaseImageBuffer().
+/// \param BufferPtr : The value pointed to by BufferPtr will be set to the handle of the new batch
+/// \param Image : A SImage structure describing one image of the batch
+/// \param NbImages : Number of images in the batch
+/// \param ImageData : A pointer to where the images are located, one after the other
+///      (NbImages * Image.Height rows of Image.Step bytes) - can be NULL for a device-only batch
+/// \param flags : The type of device memory to use, allowed values : CL_MEM_READ_WRITE, CL_MEM_WRITE_ONLY, CL_MEM_READ_ONLY
+ocipError ocip_API ocipCreateImageBufferBatch(ocipBuffer * BufferPtr, SImage Image, uint NbImages, void * ImageData, cl_mem_flags flags);
+
+/// Same as ocipCreateImageBufferBatch() but for the given context
+ocipError ocip_API ocipCreateImageBufferBatchEx(ocipContext Context, ocipBuffer * BufferPtr, SImage Image, uint NbImages,
+                                                 void * ImageData, cl_mem_flags flags);
+
 
 /// Sends the image to the device.
 /// The image data will referenced by the pointer in the SImage structure given during image creation
@@ -209,6 +374,47 @@ ocipError ocip_API ocipReadImageBuffer(   ocipBuffer Buffer);
 ocipError ocip_API ocipReleaseImageBuffer(     ocipBuffer Buffer);
 
 
+// Recorded graphs
+
+/// Starts recording the processing operations of the current context.
+/// The processing functions called until ocipEndRecording() run normally and are also recorded,
+/// so that they can be executed again with ocipLaunchGraph() with much less overhead.
+/// Only processing operations are recorded, ocipSend* and ocipRead* are not.
+ocipError ocip_API ocipBeginRecording();
+
+/// Same as ocipBeginRecording() but for the given context
+ocipError ocip_API ocipBeginRecordingEx(ocipContext Context);
+
+/// Stops recording and returns the recorded graph.
+/// The graph must be released with ocipReleaseGraph() when it is no longer needed.
+/// \param GraphPtr : The value pointed to by GraphPtr will be set to the handle of the new graph
+ocipError ocip_API ocipEndRecording(ocipGraph * GraphPtr);
+
+/// Same as ocipEndRecording() but for the given context
+ocipError ocip_API ocipEndRecordingEx(ocipContext Context, ocipGraph * GraphPtr);
+
+/// Executes all the processing operations recorded in the graph.
+/// Like processing functions, this function executes asynchronously.
+/// \param Graph : A graph returned by ocipEndRecording()
+ocipError ocip_API ocipLaunchGraph(ocipGraph Graph);
+
+/// Makes later launches of the graph use Replacement where Recorded was used.
+/// \param Graph : A graph returned by ocipEndRecording()
+/// \param Recorded : An image used by the recorded operations
+/// \param Replacement : An image of the same size and type
+ocipError ocip_API ocipGraphReplaceImage(ocipGraph Graph, ocipImage Recorded, ocipImage Replacement);
+
+/// Makes later launches of the graph use Replacement where Recorded was used.
+/// \param Graph : A graph returned by ocipEndRecording()
+/// \param Recorded : An image buffer used by the recorded operations
+/// \param Replacement : An image buffer of the same size and type
+ocipError ocip_API ocipGraphReplaceImageBuffer(ocipGraph Graph, ocipBuffer Recorded, ocipBuffer Replacement);
+
+/// Releases a graph.
+/// The ocipGraph handle will no longer be valid.
+ocipError ocip_API ocipReleaseGraph(ocipGraph Graph);
+
+
 /// Prepare for executing processing operations.
 /// ocipPrepareExample() does nothing, it is a place holder for documentation about
 /// ocipPrepare* functions that have a single argument.\n
@@ -257,6 +463,19 @@ ocipError ocip_API ocipPrepareExample(ocipImage Image);
 ///                Temporary buffers will also be pre-allocated with the proper size for that image.
 ocipError ocip_API ocipPrepareExample2(ocipProgram * ProgramPtr, ocipBuffer Image);
 
+/// Prepare the shared programs in the background.
+/// Starts building, in background threads, all versions of the programs shared by the current context :
+/// the programs used by the ocipPrepare*(ocipImage Image) and ocipPrepare*(ocipBuffer Image) functions
+/// and the color conversion program used by 3 channel images.
+/// Returns immediately. Processing primitives can be called while the programs are being built,
+/// a call will only wait if the program version it needs is still being built.
+/// The programs of handles created by ocipPrepare*(ocipProgram * ProgramPtr, ...) (statistics, blob, integral
+/// and image buffer statistics) are not shared : each handle has its own, built by its ocipPrepare*() call.
+ocipError ocip_API ocipPrepareSharedProgramsAsync();
+
+/// Same as ocipPrepareSharedProgramsAsync() but for the given context
+ocipError ocip_API ocipPrepareSharedProgramsAsyncEx(ocipContext Context);
+
 /// Releases a program.
 /// Releases the program, the given program handle will no longer be valid.
 ocipError ocip_API ocipReleaseProgram(ocipProgram Program);
@@ -697,6 +916,29 @@ ocipError ocip_API ocipScale_V(     ocipBuffer Source, ocipBuffer Dest, float Sr
 
 
 
+// Tresholding on image buffers --------------------------------------------------------------------
+ocipError ocip_API ocipPrepareImageBufferTresholding(ocipBuffer Image); ///< See ocipPrepareExample
+
+/// D = (S > Tresh ? valueHigher : S)
+ocipError ocip_API ocipTresholdGT_V(  ocipBuffer Source, ocipBuffer Dest, float Tresh, float valueHigher);
+
+/// D = (S < Tresh ? valueLower : S)
+ocipError ocip_API ocipTresholdLT_V(  ocipBuffer Source, ocipBuffer Dest, float Tresh, float valueLower);
+
+/// D = (S > Tresh ? valueHigher : (S < Tresh ? valueLower : S) )
+ocipError ocip_API ocipTresholdGTLT_V(ocipBuffer Source, ocipBuffer Dest, float threshLT, float valueLower, float treshGT, float valueHigher);
+
+/// D = (S1 Op S2 ? S1 : S2)
+ocipError ocip_API ocipTreshold_Img_V(ocipBuffer Source1, ocipBuffer Source2, ocipBuffer Dest, enum ECompareOperation Op);
+
+/// D = (S1 Op S2) - D will be 0 or 1
+ocipError ocip_API ocipCompare_Img_V( ocipBuffer Source1, ocipBuffer Source2, ocipBuffer Dest, enum ECompareOperation Op);
+
+/// D = (S Op V)  - D will be 0 or 1
+ocipError ocip_API ocipCompare_V(     ocipBuffer Source, ocipBuffer Dest, float Value, enum ECompareOperation Op);
+
+
+
 // Morphology on image buffers ---------------------------------------------------------------------
 ocipError ocip_API ocipPrepareImageBufferMorphology(ocipBuffer Image);  ///< See ocipPrepareExample
 // Single iteration
@@ -800,6 +1042,16 @@ ocipError ocip_API ocipSum_V(    ocipProgram Program, ocipBuffer Source, double
 ocipError ocip_API ocipMean_V(   ocipProgram Program, ocipBuffer Source, double * Result); ///< Calculates the mean value of all pixel values
 ocipError ocip_API ocipMeanSqr_V(ocipProgram Program, ocipBuffer Source, double * Result); ///< Calculates the mean of the square of all pixel values
 
+// Statistics on batches of image buffers - Source must be a batch created with ocipCreateImageBufferBatch()
+// Results must be an array with one value per image of the batch
+ocipError ocip_API ocipMinBatch_V(    ocipProgram Program, ocipBuffer Source, double * Results); ///< Finds the minimum value in each image of the batch
+ocipError ocip_API ocipMaxBatch_V(    ocipProgram Program, ocipBuffer Source, double * Results); ///< Finds the maximum value in each image of the batch
+ocipError ocip_API ocipMinAbsBatch_V( ocipProgram Program, ocipBuffer Source, double * Results); ///< Finds the minimum of the absolute of the values in each image of the batch
+ocipError ocip_API ocipMaxAbsBatch_V( ocipProgram Program, ocipBuffer Source, double * Results); ///< Finds the maxumum of the absolute of the values in each image of the batch
+ocipError ocip_API ocipSumBatch_V(    ocipProgram Program, ocipBuffer Source, double * Results); ///< Calculates the sum of the pixel values of each image of the batch
+ocipError ocip_API ocipMeanBatch_V(   ocipProgram Program, ocipBuffer Source, double * Results); ///< Calculates the mean value of each image of the batch
+ocipError ocip_API ocipMeanSqrBatch_V(ocipProgram Program, ocipBuffer Source, double * Results); ///< Calculates the mean of the square of the pixel values of each image of the batch
+
 
 #ifdef __cplusplus
 }
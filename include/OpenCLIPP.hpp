@@ -25,13 +25,18 @@
 #include "c++/OpenCL.h"
 #include "c++/Buffer.h"
 #include "c++/Image.h"
+#include "c++/OperationGraph.h"
+#include "c++/TileExecutor.h"
+#include "c++/FramePipeline.h"
 #include "c++/Programs/Program.h"
 #include "c++/Programs/Arithmetic.h"
 #include "c++/Programs/ArithmeticVector.h"
 #include "c++/Programs/Blob.h"
+#include "c++/Programs/BufferExpression.h"
 #include "c++/Programs/Conversions.h"
 #include "c++/Programs/Filters.h"
 #include "c++/Programs/FiltersVector.h"
+#include "c++/Programs/Fusion.h"
 #include "c++/Programs/Histogram.h"
 #include "c++/Programs/Integral.h"
 #include "c++/Programs/Logic.h"
@@ -44,3 +49,4 @@
 #include "c++/Programs/StatisticsVector.h"
 #include "c++/Programs/Transform.h"
 #include "c++/Programs/Tresholding.h"
+#include "c++/Programs/TresholdingVector.h"
@@ -0,0 +1,42 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: SProfilingRecord.h 
+//! @date   : Oct 2026
+//!
+//! @brief  : Declaration of structure SProfilingRecord, used to describe the timing of an operation
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef __SPROFILINGRECORD__H
+#define __SPROFILINGRECORD__H
+
+/// Timing of an operation executed by the device, as measured by the OpenCL profiling counters.
+/// All times are in nanoseconds and come from the clock of the device.
+struct SProfilingRecord
+{
+   char Name[64];    ///< Name of the kernel, or "Send" / "Read" for transfers - null terminated
+   uint Width;       ///< Width of the image the operation worked on (size in bytes for buffers that are not images)
+   uint Height;      ///< Height of the image the operation worked on (1 for buffers that are not images)
+   cl_ulong Queued;  ///< Time when the operation was enqueued by the host
+   cl_ulong Submit;  ///< Time when the operation was submitted to the device
+   cl_ulong Start;   ///< Time when the device started executing the operation
+   cl_ulong End;     ///< Time when the device finished executing the operation
+};
+
+#endif   // __SPROFILINGRECORD__H
@@ -49,6 +49,47 @@ public:
    /// Sends the data to the device if IsInDevice() is false - only useful for objects that have a Send() method
    virtual void SendIfNeeded() { }           
 
+   /// Waits until the transfers and kernels enqueued on this memory are done.
+   /// Only operations that track their events (Send, Read and kernels called by the library) are waited for.
+   void WaitForEvents();
+
+   /// Adds to WaitList the events an operation that reads this memory must wait for (for internal use).
+   /// That is the last operation that wrote to this memory.
+   /// Events of operations done in Queue are not added because the queues of the library execute in-order.
+   /// \param WaitList : List that receives the events
+   /// \param Queue : Queue in which the operation will be enqueued
+   void AddReadDependencies(std::vector<cl::Event>& WaitList, const cl::CommandQueue& Queue) const;
+
+   /// Adds to WaitList the events an operation that writes this memory must wait for (for internal use).
+   /// That is the last operation that wrote to this memory and the operations that read it since then.
+   /// Events of operations done in Queue are not added because the queues of the library execute in-order.
+   /// \param WaitList : List that receives the events
+   /// \param Queue : Queue in which the operation will be enqueued
+   void AddWriteDependencies(std::vector<cl::Event>& WaitList, const cl::CommandQueue& Queue) const;
+
+   /// Records an operation that reads this memory (for internal use)
+   /// \param Event : Event of the operation
+   /// \param Queue : Queue in which the operation was enqueued
+   void SetReadEvent(const cl::Event& Event, const cl::CommandQueue& Queue);
+
+   /// Records an operation that writes this memory (for internal use)
+   /// \param Event : Event of the operation
+   /// \param Queue : Queue in which the operation was enqueued
+   virtual void SetWriteEvent(const cl::Event& Event, const cl::CommandQueue& Queue);
+
+   /// Adds to Events the events of all the tracked operations that use this memory, in any queue (for internal use)
+   /// \param Events : List that receives the events
+   void GetAllEvents(std::vector<cl::Event>& Events) const;
+
+   /// Adds operations that an operation writing this memory must wait for (for internal use).
+   /// Used for memory recycled from the MemoryPool, to wait for the operations of its previous owner.
+   /// \param Events : Events of the operations
+   void AddPendingEvents(const std::vector<cl::Event>& Events);
+
+   /// Returns an object that expires when this memory is destroyed (for internal use).
+   /// Used by OperationGraph to know which of the memory objects it has recorded still exist.
+   std::weak_ptr<void> GetLifetime();
+
 protected:
    Memory();   ///< Constructor - useable by derived classes only
 
@@ -56,12 +97,32 @@ protected:
    /// True when the memory in the device contains meaningful data
    /// (ie: true after an image has been sent to the device, false for an unitialised temporary image)
    bool m_isInDevice;   
+
+   /// An operation done on the memory
+   struct SOperation
+   {
+      cl::Event Event;           ///< Event signaled when the operation is done
+      cl::CommandQueue Queue;    ///< Queue the operation was enqueued in - retained so it stays valid when COpenCL replaces its queues
+   };
+
+   SOperation m_LastWrite;                   ///< Last operation that wrote to the memory
+   std::vector<SOperation> m_PendingReads;   ///< Operations that read the memory since the last write - the last one of each queue
+
+   std::shared_ptr<void> m_Lifetime;   ///< Destroyed with the memory, created by the first call to GetLifetime()
+
+   /// Memory this memory is a part of (like the parent of a sub-buffer), null if not part of another memory.
+   /// When set, the In device state and the operations are tracked by the container instead.
+   Memory * m_Container;
 };
 
 /// Base class for buffer objects - Wraps a cl::Buffer
 class CL_API IBuffer : public Memory
 {
 public:
+   /// Destructor.
+   /// Gives the device memory back to the MemoryPool
+   virtual ~IBuffer();
+
    /// Converts to a cl::Buffer
    operator cl::Buffer& () 
    {
@@ -89,9 +150,23 @@ protected:
    /// \param copy : If we want a copy of the data currently on the host (will use CL_MEM_COPY_HOST_PTR)
    IBuffer(COpenCL& CL, size_t size, cl_mem_flags flags, void * data = nullptr, bool copy = false);
 
+   /// Constructor that does not create the OpenCL buffer - useable by derived classes only.
+   /// The derived class must set m_Buffer, m_Size and m_Flags or call CreateInPool().
+   IBuffer();
+
+   /// Creates m_Buffer of m_Size bytes with m_Flags, taking device memory from the MemoryPool
+   void CreateInPool(COpenCL& CL);
+
    cl::Buffer m_Buffer;    ///< The encapsulated OpenCL buffer object
    size_t m_Size;          ///< The size of the buffer, in bytes
-   bool m_HostBuffer;      ///< true when using CL_MEM_USE_HOST_PTR and mapped memory for faster memory transfer
+   ETransferStrategy m_Transfer; ///< How the data is transferred - MapTransfer and NoCopyTransfer use CL_MEM_USE_HOST_PTR
+   cl_mem_flags m_Flags;   ///< Flags used to create the buffer
+
+   std::shared_ptr<MemoryPool> m_Pool; ///< Pool the buffer comes from - null when the buffer does not come from a pool
+
+private:
+   IBuffer(const IBuffer&);               // Not copyable
+   IBuffer& operator = (const IBuffer&);
 };
 
 /// Represents an in-device only memory buffer
@@ -125,7 +200,12 @@ public:
 
    virtual void SendIfNeeded();  ///< Sends the data to the device if IsInDevice() is false
 
+   COpenCL& GetCL() { return m_CL; }  ///< Returns a reference to the COpenCL object this buffer is assotiated to
+
 protected:
+   /// Constructor that does not create the OpenCL buffer and has no host data - see IBuffer()
+   Buffer(COpenCL& CL);
+
    COpenCL& m_CL;    ///< The COpenCL instance this image is assotiated to
    void * m_data;    ///< Pointer to the buffer data on the host
 
@@ -139,7 +219,7 @@ public:
    /// Constructor.
    /// Creates a buffer on the device to contain the data
    /// Copies the buffer on the host side
-   /// Issues a Send() from the copy to the device
+   /// Issues a non-blocking Send() from the copy to the device
    /// After the object is created, the array pointed to by data can be freed
    /// \param CL : A COpenCL instance
    /// \param data : Pointer to the array in host memory
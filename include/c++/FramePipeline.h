@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: FramePipeline.h
+//! @date   : Oct 2026
+//!
+//! @brief  : Double-buffered processing of streams of frames
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include "Image.h"
+#include "PinnedMemory.h"
+
+#include <functional>
+#include <chrono>
+
+namespace OpenCLIPP
+{
+
+/// Statistics of a FramePipeline.
+/// Stage times are measured on the device clock and are only available when profiling is enabled
+/// (see COpenCL::EnableProfiling()), they are 0 otherwise.
+struct SPipelineStats
+{
+   uint NbFrames;          ///< Number of frames completed - returned by Pop()
+   double FramesPerSecond; ///< Frames completed per second, from the first Push() to the last Pop()
+   double LatencyMs;       ///< Average time between the Push() and the Pop() of a frame, in ms
+   double UploadMs;        ///< Average time to send a frame to the device, in ms
+   double ComputeMs;       ///< Average time from the end of the upload to the end of the processing of a frame, in ms
+   double DownloadMs;      ///< Average time from the end of the processing to the end of the read of a frame, in ms
+};
+
+/// Processes a stream of frames, overlapping the upload, processing and download of successive frames.
+/// The pipeline keeps a ring of Depth slots, each with pinned host memory and device images for a source
+/// and a destination frame. Push() copies a frame to the pinned memory of the next slot and enqueues its upload,
+/// the processing done by Function and the download of the result, without waiting.
+/// Pop() returns the results in the order the frames were pushed.
+/// CL must use a separate transfer queue (see COpenCL::UseTransferQueue()) so that the transfers of
+/// a frame run while the kernels of another frame execute, it must stay enabled while the pipeline exists.
+/// Usage :
+///   CL.UseTransferQueue();
+///   FramePipeline Pipeline(CL, Frame, Result, [&](IImage& S, IImage& D) { Filters.Sobel(S, D); });
+///   while (Camera.Grab(FrameData))
+///   {
+///      if (Pipeline.IsFull())
+///         Pipeline.Pop(ResultData);
+///
+///      Pipeline.Push(FrameData);
+///   }
+///
+///   while (Pipeline.Pop(ResultData))
+///      ;
+/// Destroying the pipeline waits for the frames still in it, their results are discarded.
+/// 3 channel images are not supported.
+class CL_API FramePipeline
+{
+public:
+   /// Operation done on each frame - Source contains the frame, Function must write its result in Dest
+   typedef std::function<void(IImage& Source, IImage& Dest)> Operation;
+
+   /// Constructor.
+   /// Allocates the pinned memory and the device images of all the slots
+   /// \param CL : A COpenCL instance, its transfer queue must be enabled - throws otherwise
+   /// \param Source : Description of the frames given to Push()
+   /// \param Dest : Description of the results returned by Pop() - must have the same size as Source
+   /// \param Function : Processing done on each frame, with primitives of the library
+   /// \param Depth : Number of frames that can be in the pipeline at the same time - 2 or more for the stages to overlap
+   FramePipeline(COpenCL& CL, const SImage& Source, const SImage& Dest, const Operation& Function, uint Depth = 3);
+
+   /// Starts the processing of a frame.
+   /// Returns false, without taking the frame, when Depth frames are already in the pipeline - call Pop() first
+   /// \param Data : The frame, described by the Source given to the constructor - copied, can be re-used when Push() returns
+   bool Push(const void * Data);
+
+   /// Gets the result of the oldest frame in the pipeline.
+   /// Returns false if the pipeline is empty or if Wait is false and the oldest frame is not done
+   /// \param Data : Receives the result, described by the Dest given to the constructor
+   /// \param Wait : true to wait for the frame to be done
+   bool Pop(void * Data, bool Wait = true);
+
+   /// Returns the number of frames in the pipeline - pushed and not yet popped
+   uint GetNbPending() const;
+
+   /// Returns true when Push() can't take another frame
+   bool IsFull() const;
+
+   /// Returns the statistics of the frames completed since the creation of the pipeline or the last call to ResetStats()
+   SPipelineStats GetStats() const;
+
+   /// Discards the statistics
+   void ResetStats();
+
+private:
+   FramePipeline(const FramePipeline&);            // Not copyable
+   FramePipeline& operator = (const FramePipeline&);
+
+   typedef std::chrono::steady_clock Clock;
+
+   /// A frame being processed
+   struct SSlot
+   {
+      std::shared_ptr<PinnedMemory> SourceData;
+      std::shared_ptr<PinnedMemory> DestData;
+      std::unique_ptr<Image> Source;
+      std::unique_ptr<Image> Dest;
+      std::vector<cl::Event> Done;  // Operations that must be done before the result can be used
+      cl::Event Upload;             // Events of each stage, used for the statistics
+      cl::Event Compute;
+      cl::Event Download;
+      bool Profiled;                // Profiling was enabled when the frame was pushed
+      Clock::time_point PushTime;
+   };
+
+   void AddStats(SSlot& Slot);   // Adds the timings of a completed frame to the statistics
+
+   COpenCL& m_CL;
+   Operation m_Function;
+   std::vector<std::unique_ptr<SSlot>> m_Slots;
+   uint m_First;     // Slot of the oldest frame in the pipeline
+   uint m_NbPending; // Number of frames in the pipeline
+
+   // Statistics
+   bool m_Started;      // A frame has been pushed since the last reset
+   uint m_NbFrames;
+   uint m_NbProfiled;   // Number of frames that have stage times
+   double m_TotalLatency;
+   double m_TotalUpload;
+   double m_TotalCompute;
+   double m_TotalDownload;
+   Clock::time_point m_FirstPush;
+   Clock::time_point m_LastPop;
+};
+
+}
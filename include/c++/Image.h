@@ -47,12 +47,15 @@
 #pragma once
 
 #include "Buffer.h"
+#include "PinnedMemory.h"
 #include <SImage.h>
 
 
 namespace OpenCLIPP
 {
 
+template<class E> class BufferExpression;
+
 /// Structure containing the size of an image - in pixels
 struct CL_API SSize
 {
@@ -60,6 +63,22 @@ struct CL_API SSize
    uint Height;   ///< Height - in pixels
 };
 
+/// Structure containing the position of a pixel in an image
+struct CL_API SPoint
+{
+   uint X;        ///< Horizontal position - in pixels
+   uint Y;        ///< Vertical position - in pixels
+};
+
+/// Structure containing a rectangular region of an image - in pixels
+struct CL_API SRect
+{
+   uint X;        ///< Horizontal position of the first pixel of the region
+   uint Y;        ///< Vertical position of the first pixel of the region
+   uint Width;    ///< Width - in pixels
+   uint Height;   ///< Height - in pixels
+};
+
 
 /// Base class for all images - encapsulates a SImage
 class CL_API ImageBase
@@ -103,6 +122,42 @@ public:
    /// \param ImageData : A pointer to where the image data is located
    /// \param flags : Type of OpenCL memory to use, allowed values : CL_MEM_READ_WRITE, CL_MEM_WRITE_ONLY, CL_MEM_READ_ONLY
    ImageBuffer(COpenCL& CL, const SImage& Image, void * ImageData, cl_mem_flags flags = CL_MEM_READ_WRITE);
+
+   /// Constructor.
+   /// Allocates a buffer in the device memory that can store the image
+   /// The image data is in the given pinned memory, which the ImageBuffer keeps alive.
+   /// Send and Read operations run at full DMA bandwidth.
+   /// If flags contains CL_MEM_USE_HOST_PTR, the device uses the pinned memory directly and
+   /// Send and Read operations only map and unmap the memory.
+   /// \param CL : A COpenCL instance
+   /// \param Image : A SImage representing the host image
+   /// \param Data : Pinned memory that contains the image data - must be at least Image.Height * Image.Step bytes
+   /// \param flags : Type of OpenCL memory to use, allowed values : CL_MEM_READ_WRITE, CL_MEM_WRITE_ONLY, CL_MEM_READ_ONLY
+   ImageBuffer(COpenCL& CL, const SImage& Image, std::shared_ptr<PinnedMemory> Data, cl_mem_flags flags = CL_MEM_READ_WRITE);
+
+   /// Destructor.
+   /// Waits for the transfers that use the pinned memory, if any
+   virtual ~ImageBuffer();
+
+   /// Evaluates the expression into this image buffer, with a single kernel.
+   /// Example : Dest = Abs(A - B) * 0.5f + C;
+   /// Defined in Programs/BufferExpression.h, which must be included to use it.
+   template<class E>
+   ImageBuffer& operator = (const BufferExpression<E>& Expression);
+
+   /// Returns the image buffer to give to kernels that accept an element offset (for internal use).
+   /// This is the image itself, except for the views that have their own memory - see ImageBufferView
+   virtual ImageBuffer& Direct() { return *this; }
+
+   /// Position of the first value of the image in its OpenCL buffer, in number of values (for internal use)
+   uint Offset() const { return m_Offset; }
+
+protected:
+   /// Constructor that does not create the OpenCL buffer - see IBuffer()
+   ImageBuffer(COpenCL& CL, const SImage& Image);
+
+   std::shared_ptr<PinnedMemory> m_Pinned;   ///< Pinned memory adopted by the image, null if not using pinned memory
+   uint m_Offset;    ///< Position of the first value of the image in its OpenCL buffer, in number of values
 };
 
 
@@ -126,6 +181,8 @@ public:
    /// \param flags : Type of OpenCL memory to create, allowed values : CL_MEM_READ_WRITE, CL_MEM_WRITE_ONLY, CL_MEM_READ_ONLY
    TempImageBuffer(COpenCL& CL, SSize Size, SImage::EDataType Type, uint NbChannels = 1, cl_mem_flags flags = CL_MEM_READ_WRITE);
 
+   using ImageBuffer::operator =;
+
    virtual void SendIfNeeded() { }  ///< Does nothing - it is in-device only and can't be sent
 
 private:
@@ -135,10 +192,92 @@ private:
 };
 
 
+/// A rectangular region of an image buffer, useable by all programs that accept an ImageBuffer.
+/// When the start of the region is aligned as required by the device (CL_DEVICE_MEM_BASE_ADDR_ALIGN),
+/// the view is a sub-buffer of the parent : kernels work directly in the memory of the parent.
+/// Otherwise the pointwise programs (ArithmeticVector, LogicVector, LutVector and TresholdingVector)
+/// still work directly in the memory of the parent : their kernels receive the position of the region (see Direct()).
+/// For the other programs, the view has its own device memory : the region is copied from the parent (in the device)
+/// when a kernel reads the view and copied back to the parent after a kernel writes the view.
+/// Only the region is copied, never the whole image.
+/// Creating a view sends the parent to the device if needed.
+/// The parent must stay alive as long as the view is used.
+/// Send() and Read() do nothing on a view, use the ones of the parent.
+class CL_API ImageBufferView : public ImageBuffer
+{
+public:
+   /// Constructor.
+   /// \param CL : A COpenCL instance
+   /// \param Parent : The image buffer that contains the region, can be another view
+   /// \param Region : Region of the parent, in pixels - must be inside the parent
+   ImageBufferView(COpenCL& CL, ImageBuffer& Parent, const SRect& Region);
+
+   /// Returns true if the view is a sub-buffer of the parent, false if it uses copies of the region
+   bool IsSubBuffer() const { return m_Container != nullptr; }
+
+   /// Returns the region of the parent covered by the view
+   const SRect& Region() const { return m_Region; }
+
+   /// Returns the image buffer to give to kernels that accept an element offset (for internal use).
+   /// When the view is not a sub-buffer, that is the memory of the parent with the position of the region as offset.
+   virtual ImageBuffer& Direct();
+
+   /// Copies the region from the parent if the view is not a sub-buffer (for internal use)
+   virtual void SendIfNeeded();
+
+   /// Copies the region to the parent if the view is not a sub-buffer (for internal use)
+   virtual void SetWriteEvent(const cl::Event& Event, const cl::CommandQueue& Queue);
+
+protected:
+   ImageBuffer& m_Parent;  ///< The image buffer that contains the region
+   SRect m_Region;         ///< Region of the parent covered by the view
+   std::unique_ptr<ImageBuffer> m_Direct; ///< The region in the memory of the parent, null when the view is a sub-buffer
+
+   void CopyRegion(bool FromParent);   ///< Copies the region between the parent and the memory of the view
+};
+
+
+/// A batch of images of the same size, stored one after the other in a single image buffer.
+/// Image i of the batch starts at row i * ImageHeight() : the batch is also an image buffer
+/// of ImageHeight() * NbImages() rows, which is sent and read in a single transfer.
+/// Pointwise programs (like ArithmeticVector and TresholdingVector) process the whole batch in one launch.
+/// FiltersVector processes each image of the batch separately, also in one launch.
+/// StatisticsVector has reductions that return one value per image of the batch.
+class CL_API ImageBufferBatch : public ImageBuffer
+{
+public:
+   /// Constructor.
+   /// Allocates a buffer in the device memory that can store all the images of the batch
+   /// \param CL : A COpenCL instance
+   /// \param Image : A SImage representing one image of the batch
+   /// \param NbImages : Number of images in the batch
+   /// \param ImageData : A pointer to where the images are located, one after the other
+   ///      (NbImages * Image.Height rows of Image.Step bytes) - can be nullptr for an in-device only batch
+   /// \param flags : Type of OpenCL memory to use, allowed values : CL_MEM_READ_WRITE, CL_MEM_WRITE_ONLY, CL_MEM_READ_ONLY
+   ImageBufferBatch(COpenCL& CL, const SImage& Image, uint NbImages, void * ImageData = nullptr, cl_mem_flags flags = CL_MEM_READ_WRITE);
+
+   uint NbImages() const { return m_NbImages; }       ///< Returns the number of images in the batch
+   uint ImageHeight() const { return m_ImageHeight; } ///< Returns the height of each image of the batch, in pixels
+
+   /// Returns a range with 1 worker per pixel, the third dimension is the index of the image in the batch
+   cl::NDRange BatchRange();
+
+   using ImageBuffer::operator =;
+
+protected:
+   uint m_NbImages;     ///< Number of images in the batch
+   uint m_ImageHeight;  ///< Height of each image of the batch
+};
+
+
 /// Base class for Images (not including image buffers) - Wraps cl::Image2D - not useable directly
 class CL_API IImage : public ImageBase, public Memory
 {
 public:
+   /// Destructor.
+   /// Gives the device memory back to the MemoryPool
+   virtual ~IImage();
+
    /// Converts to a cl::Image2D
    operator cl::Image2D& ()   
    {
@@ -151,6 +290,12 @@ public:
       return (cl_mem) m_clImage();
    }
 
+   /// Returns the position, in the OpenCL image, of the first pixel of this image.
+   /// Always 0, 0 except for views (see ImageView)
+   SPoint Origin() const { return m_Origin; }
+
+   COpenCL& GetCL() { return m_CL; }  ///< Returns a reference to the COpenCL object this image is assotiated to
+
 protected:
 
    /// Constructor.
@@ -166,10 +311,21 @@ protected:
    /// \param data : A pointer to where the image data is located
    void Create(cl_mem_flags flags, void * data = nullptr);
 
+   /// Constructor.
+   /// Uses the OpenCL image of Parent instead of allocating one - used by ImageView
+   /// \param CL : A COpenCL instance
+   /// \param Parent : Image that contains the OpenCL image
+   /// \param Region : Region of Parent represented by this image
+   IImage(COpenCL& CL, IImage& Parent, const SRect& Region);
+
    cl::ImageFormat m_format;  ///< Format of the image
    cl::Image2D m_clImage;     ///< The encapsulated OpenCL image object
-   bool m_HostBuffer;         ///< true when using CL_MEM_USE_HOST_PTR and mapped image for faster image transfer
+   ETransferStrategy m_Transfer; ///< How the data is transferred - MapTransfer and NoCopyTransfer use CL_MEM_USE_HOST_PTR
    COpenCL& m_CL;             ///< The COpenCL instance this image is assotiated to
+   cl_mem_flags m_Flags;      ///< Flags used to create the image
+   SPoint m_Origin;           ///< Position of the first pixel in m_clImage
+
+   std::shared_ptr<MemoryPool> m_Pool; ///< Pool the image comes from - null when the image does not come from a pool
 
    void operator = (const IImage&) { }  ///< Not a copyable object
 };
@@ -212,6 +368,20 @@ public:
    /// \param flags : Type of OpenCL memory to create, allowed values : CL_MEM_READ_WRITE, CL_MEM_WRITE_ONLY, CL_MEM_READ_ONLY
    Image(COpenCL& CL, const SImage& Image, void * ImageData, cl_mem_flags flags = CL_MEM_READ_WRITE);
 
+   /// Constructor.
+   /// Allocates an image in the device memory
+   /// The image data is in the given pinned memory, which the Image keeps alive.
+   /// Send and Read operations run at full DMA bandwidth.
+   /// \param CL : A COpenCL instance
+   /// \param Image : A SImage representing the host image
+   /// \param Data : Pinned memory that contains the image data - must be at least Image.Height * Image.Step bytes
+   /// \param flags : Type of OpenCL memory to create, allowed values : CL_MEM_READ_WRITE, CL_MEM_WRITE_ONLY, CL_MEM_READ_ONLY
+   Image(COpenCL& CL, const SImage& Image, std::shared_ptr<PinnedMemory> Data, cl_mem_flags flags = CL_MEM_READ_WRITE);
+
+   /// Destructor.
+   /// Waits for the transfers that use the pinned memory, if any
+   virtual ~Image();
+
    /// Read the image from the device memory.
    /// If blocking is set to true, the Read operation is added to the queue
    /// and then the host waits until the device has finished all outstanding operations.
@@ -227,8 +397,8 @@ public:
    /// and then the host waits until the device has finished all outstanding operations.
    /// If blocking is set to false, the Send operation is added to the queue and no wait operation is performed
    /// blocking normally does not need to be set to true for the data to be available as input of later kernel execution
-   /// because OpenCL executes all operations in-order except if the queue has been created Out-of-Order
-   /// (which is currently not supported by this library).
+   /// because kernels enqueued after the Send wait for it to complete, also when a separate transfer queue
+   /// is used (see COpenCL::UseTransferQueue()).
    /// \param blocking : Blocking operation
    /// \param events : A list of events that need to be signaled before executing the Read operation
    /// \param event : An event that can be used to wait for the end of the Read operation
@@ -238,6 +408,7 @@ public:
 
 protected:
    void * m_data;    ///< Pointer to the image data on the host
+   std::shared_ptr<PinnedMemory> m_Pinned;   ///< Pinned memory adopted by the image, null if not using pinned memory
 };
 
 
@@ -265,23 +436,52 @@ public:
    /// If blocking is set to false, the Read operation is added to the queue and no wait operation is performed
    /// So if blocking is set to false, the image will not contain the result of the previous kernel execution
    /// \param blocking : Blocking operation
-   /// \param events : A list of events that need to be signaled before executing the Read operation
+   /// \param events : A list of events that need to be signaled before the conversion to the 3 channel image buffer
    /// \param event : An event that can be used to wait for the end of the Read operation
    void Read(bool blocking = false, std::vector<cl::Event> * events = nullptr, cl::Event * event = nullptr);
 
    /// Send the image to the device memory.
    /// The image will be sent to a 3 channel image buffer in the device and then
    /// converted to a 4 channel image.
-   /// Always non-blocking
-   void Send();
+   /// If blocking is set to true, the host waits until the conversion is done
+   /// \param blocking : Blocking operation
+   /// \param events : A list of events that need to be signaled before executing the Send operation
+   /// \param event : An event that can be used to wait for the end of the conversion to the 4 channel image
+   void Send(bool blocking = false, std::vector<cl::Event> * events = nullptr, cl::Event * event = nullptr);
 
    virtual void SendIfNeeded();  ///< Sends the data to the device if IsInDevice() is false
 
 protected:
    ImageBuffer m_Buffer;   ///< Buffer on the device that contains the 3 channel image
+};
 
-private:
-   void Send(bool, std::vector<cl::Event> * = nullptr, cl::Event * = nullptr);    // Only non-blocking non-synced send available for color images right now
+
+/// A rectangular region of an image, useable by the programs that process each pixel independently
+/// or from its neighborhood : Arithmetic, Logic, Lut, Tresholding, Conversions, Color, Filters, Morphology.
+/// The view uses the OpenCL image of the parent : no memory is allocated and no data is copied.
+/// Kernels are launched on the region only (using a global offset) and write directly in the parent.
+/// All images given to a primitive must have the same origin, like views of the same region of images of the same size.
+/// Filters and morphology read the pixels of the parent that surround the region.
+/// Programs that work on the image as a whole (Statistics, Histogram, Integral, Blob, Transform) don't accept views.
+/// Creating a view sends the parent to the device if needed.
+/// The parent must stay alive as long as the view is used.
+class CL_API ImageView : public IImage
+{
+public:
+   /// Constructor.
+   /// \param CL : A COpenCL instance
+   /// \param Parent : The image that contains the region, can be another view
+   /// \param Region : Region of the parent, in pixels - must be inside the parent
+   ImageView(COpenCL& CL, IImage& Parent, const SRect& Region);
+
+   /// Returns the region of the parent covered by the view
+   const SRect& Region() const { return m_Region; }
+
+   virtual void SendIfNeeded();  ///< Sends the parent to the device if needed
+
+protected:
+   IImage& m_Parent;    ///< The image that contains the region
+   SRect m_Region;      ///< Region of the parent covered by the view
 };
 
 }
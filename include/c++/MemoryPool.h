@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: MemoryPool.h
+//! @date   : Oct 2026
+//!
+//! @brief  : Pool of device memory used by temporary images and buffers
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include "Basic.h"
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <cl/cl.hpp>
+
+#include <map>
+#include <vector>
+#include <mutex>
+
+namespace OpenCLIPP
+{
+
+/// Statistics about the memory pool
+struct SMemoryPoolStats
+{
+   size_t NbRequests;      ///< Number of memory objects requested from the pool
+   size_t NbReused;        ///< Number of requests that received a recycled memory object
+   size_t NbCreated;       ///< Number of requests that needed a new memory object to be created in the device
+   size_t NbCached;        ///< Number of memory objects currently kept by the pool for later use
+   size_t CachedBytes;     ///< Size in bytes of the memory objects currently kept by the pool
+   size_t InUseBytes;      ///< Size in bytes of the memory objects currently in use
+   size_t PeakBytes;       ///< Highest value of CachedBytes + InUseBytes
+};
+
+/// Pool of device memory.
+/// Each COpenCL has a pool (see COpenCL::GetMemoryPool()) that is used by images and buffers
+/// that don't use host memory.
+/// When an image or buffer is destroyed, its device memory is kept by the pool and is given to the next
+/// image or buffer of the same size, format and flags, avoiding the cost of allocating device memory.
+/// Buffer sizes are rounded up so buffers of similar sizes can share the same memory.
+class CL_API MemoryPool
+{
+public:
+   /// Constructor.
+   /// \param Context : OpenCL context to allocate memory from
+   MemoryPool(const cl::Context& Context);
+
+   /// Returns a buffer of at least the given size.
+   /// \param Size : Size of the buffer in bytes
+   /// \param Flags : Flags used to create the buffer
+   /// \param PendingEvents : Receives the events of operations that may still use the recycled buffer
+   cl::Buffer CreateBuffer(size_t Size, cl_mem_flags Flags, std::vector<cl::Event>& PendingEvents);
+
+   /// Gives a buffer back to the pool.
+   /// \param Buffer : A buffer received from CreateBuffer()
+   /// \param Size : Size given to CreateBuffer()
+   /// \param Flags : Flags given to CreateBuffer()
+   /// \param PendingEvents : Events of the operations that use the buffer and that may not be done
+   void ReleaseBuffer(const cl::Buffer& Buffer, size_t Size, cl_mem_flags Flags, const std::vector<cl::Event>& PendingEvents);
+
+   /// Returns an image of the given format and size.
+   /// \param Format : Format of the image
+   /// \param Width : Width of the image in pixels
+   /// \param Height : Height of the image in pixels
+   /// \param Flags : Flags used to create the image
+   /// \param PendingEvents : Receives the events of operations that may still use the recycled image
+   cl::Image2D CreateImage(const cl::ImageFormat& Format, size_t Width, size_t Height, cl_mem_flags Flags,
+      std::vector<cl::Event>& PendingEvents);
+
+   /// Gives an image back to the pool.
+   /// \param Image : An image received from CreateImage()
+   /// \param Format : Format given to CreateImage()
+   /// \param Width : Width given to CreateImage()
+   /// \param Height : Height given to CreateImage()
+   /// \param Flags : Flags given to CreateImage()
+   /// \param PendingEvents : Events of the operations that use the image and that may not be done
+   void ReleaseImage(const cl::Image2D& Image, const cl::ImageFormat& Format, size_t Width, size_t Height,
+      cl_mem_flags Flags, const std::vector<cl::Event>& PendingEvents);
+
+   /// Sets the maximum amount of memory kept by the pool.
+   /// Memory objects released when the pool already keeps that amount of memory are freed.
+   /// Set to 0 to disable pooling. Default is 256MB.
+   /// \param MaxBytes : Maximum number of bytes kept by the pool
+   void SetMaxCachedBytes(size_t MaxBytes);
+
+   /// Frees all the memory kept by the pool
+   void Clear();
+
+   /// Returns statistics about the usage of the pool
+   SMemoryPoolStats GetStats() const;
+
+   /// Prevents the pool from recycling a memory object when it is released.
+   /// Used for memory that is still referenced elsewhere, like by the kernels of an OperationGraph.
+   /// Calls can be nested, the memory can be recycled again when Unreserve() has been called as many times.
+   /// \param Memory : The memory object
+   void Reserve(cl_mem Memory);
+
+   /// Allows the pool to recycle a memory object given to Reserve()
+   /// \param Memory : The memory object
+   void Unreserve(cl_mem Memory);
+
+private:
+   MemoryPool(const MemoryPool&);               // Not copyable
+   MemoryPool& operator = (const MemoryPool&);
+
+   struct SBufferKey
+   {
+      size_t Size;
+      cl_mem_flags Flags;
+      bool operator < (const SBufferKey& Other) const;
+   };
+
+   struct SImageKey
+   {
+      cl_channel_order Order;
+      cl_channel_type Type;
+      size_t Width;
+      size_t Height;
+      cl_mem_flags Flags;
+      bool operator < (const SImageKey& Other) const;
+   };
+
+   template<class T>
+   struct SEntry
+   {
+      T Memory;
+      std::vector<cl::Event> PendingEvents;
+   };
+
+   typedef std::map<SBufferKey, std::vector<SEntry<cl::Buffer>>> BufferMap;
+   typedef std::map<SImageKey, std::vector<SEntry<cl::Image2D>>> ImageMap;
+
+   template<class K, class T>
+   bool TakeCached(std::map<K, std::vector<SEntry<T>>>& Map, const K& Key, size_t NbBytes,
+      T& Memory, std::vector<cl::Event>& PendingEvents);    // Takes an object from the pool, if there is one
+
+   template<class K, class T>
+   void Keep(std::map<K, std::vector<SEntry<T>>>& Map, const K& Key, size_t NbBytes,
+      const T& Memory, const std::vector<cl::Event>& PendingEvents);   // Gives an object back to the pool
+
+   void AddCreated(size_t NbBytes);    // Records the creation of a new object
+
+   cl::Context m_Context;
+   std::map<cl_mem, uint> m_Reserved;  // Memory objects that must not be recycled, with the number of reservations
+   BufferMap m_Buffers;
+   ImageMap m_Images;
+   size_t m_MaxCachedBytes;
+   SMemoryPoolStats m_Stats;
+   mutable std::mutex m_Mutex;
+};
+
+}
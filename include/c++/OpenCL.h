@@ -33,12 +33,62 @@
 #include <cl/cl.hpp>
 
 
+#include <SProfilingRecord.h>
+
+#include "MemoryPool.h"
+
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace OpenCLIPP
 {
 
 class Color;
+class ThreadPool;
+class PinnedMemory;
+class WorkGroupTuner;
+class OperationGraph;
+class ExpressionEvaluator;
+
+/// How the data of an image or buffer is transferred between the host and the device.
+/// See COpenCL::GetTransferStrategy()
+enum ETransferStrategy
+{
+   CopyTransfer,     ///< The device has its own memory, Send and Read copy the data
+   MapTransfer,      ///< The device uses the host memory (CL_MEM_USE_HOST_PTR), Send and Read map and unmap it
+   NoCopyTransfer,   ///< The device uses the host memory directly, Send and Read only wait for the operations
+};
+
+/// Capabilities of an OpenCL device.
+/// Queried once when the COpenCL is created so that the library does not need to query the driver
+/// when processing images. See COpenCL::GetDeviceInfo().
+struct SDeviceInfo
+{
+   std::string PlatformName;        ///< CL_PLATFORM_NAME
+   std::string DeviceName;          ///< CL_DEVICE_NAME
+   std::string DeviceVersion;       ///< CL_DEVICE_VERSION
+   std::string DriverVersion;       ///< CL_DRIVER_VERSION
+   cl_device_type Type;             ///< CL_DEVICE_TYPE
+   bool IsOnIntelCPU;               ///< True for a CPU device of the Intel platform
+   bool HostUnifiedMemory;          ///< CL_DEVICE_HOST_UNIFIED_MEMORY - the device and the host share the same memory
+   cl_uint MemBaseAddrAlign;        ///< CL_DEVICE_MEM_BASE_ADDR_ALIGN - in bits
+   cl_uint ComputeUnits;            ///< CL_DEVICE_MAX_COMPUTE_UNITS
+   size_t MaxWorkGroupSize;         ///< CL_DEVICE_MAX_WORK_GROUP_SIZE
+   cl_ulong LocalMemSize;           ///< CL_DEVICE_LOCAL_MEM_SIZE - in bytes
+   cl_ulong GlobalMemSize;          ///< CL_DEVICE_GLOBAL_MEM_SIZE - in bytes
+   cl_ulong MaxMemAllocSize;        ///< CL_DEVICE_MAX_MEM_ALLOC_SIZE - in bytes
+   bool ImageSupport;               ///< CL_DEVICE_IMAGE_SUPPORT
+   size_t Image2DMaxWidth;          ///< CL_DEVICE_IMAGE2D_MAX_WIDTH
+   size_t Image2DMaxHeight;         ///< CL_DEVICE_IMAGE2D_MAX_HEIGHT
+   cl_uint PreferredVectorWidthChar;   ///< CL_DEVICE_PREFERRED_VECTOR_WIDTH_CHAR
+   cl_uint PreferredVectorWidthShort;  ///< CL_DEVICE_PREFERRED_VECTOR_WIDTH_SHORT
+   cl_uint PreferredVectorWidthInt;    ///< CL_DEVICE_PREFERRED_VECTOR_WIDTH_INT
+   cl_uint PreferredVectorWidthFloat;  ///< CL_DEVICE_PREFERRED_VECTOR_WIDTH_FLOAT
+   std::vector<cl::ImageFormat> ReadWriteFormats;  ///< 2D image formats supported with CL_MEM_READ_WRITE
+   std::vector<cl::ImageFormat> ReadOnlyFormats;   ///< 2D image formats supported with CL_MEM_READ_ONLY
+   std::vector<cl::ImageFormat> WriteOnlyFormats;  ///< 2D image formats supported with CL_MEM_WRITE_ONLY
+};
 
 /// Takes care of initializing OpenCL
 /// Contains an OpenCL Device, Context and CommandQueue
@@ -66,6 +116,8 @@ public:
    /// Tells COpenCL where the .cl files are located.
    /// It must be called with the full path of "CL/CL/cl files".
    /// .cl file location must be specified before creating any program.
+   /// When the library is built with its makefile, the .cl files are compiled in the library
+   /// and are only read from this path if SetUseClFiles(true) has been called.
    /// \param Path : Full path where the .cl files are located
    static void SetClFilesPath(const char * Path);
 
@@ -73,12 +125,147 @@ public:
    /// \return the path where the .cl files are located
    static const std::string& GetClFilePath();
 
-   /// Returns the OpenCL CommandQueue (for internal use)
+   /// Selects where the source of the programs comes from.
+   /// By default, the sources compiled in the library are used when available, so no file is read.
+   /// Set to true to read the .cl files from the path given to SetClFilesPath() instead,
+   /// which is useful when modifying the .cl files.
+   /// When the library does not contain the sources, the .cl files are always read.
+   /// \param Use : true to read the .cl files, false to use the sources compiled in the library
+   static void SetUseClFiles(bool Use);
+
+   /// Returns true if the .cl files must be read instead of using the sources compiled in the library (for internal use)
+   static bool GetUseClFiles();
+
+   /// Enables the on-disk cache of compiled programs.
+   /// When set, programs that are built are saved in this folder (as retreived with CL_PROGRAM_BINARIES)
+   /// and later builds of the same program, with the same options, for the same device and driver
+   /// will load the compiled binary instead of compiling the source again.
+   /// The folder must exist and be writable. Set to "" to disable the cache (default).
+   /// \param Path : Full path of the folder where the compiled programs are stored
+   static void SetBinaryCachePath(const char * Path);
+
+   /// Returns the path of the compiled program cache (for internal use)
+   /// \return the path where compiled programs are stored, empty if the cache is disabled
+   static const std::string& GetBinaryCachePath();
+
+   /// Returns the OpenCL CommandQueue (for internal use).
+   /// Kernels are executed in this queue.
    cl::CommandQueue& GetQueue();
 
+   /// Enables a separate command queue for transfers.
+   /// By default, transfers between the host and the device and kernel executions are done in the same queue,
+   /// so they are all serialized. When enabled, Send and Read operations of images and buffers
+   /// are done in a second queue, so a transfer can overlap with the execution of kernels
+   /// (for example, send frame N+1 while frame N is being processed).
+   /// Dependencies between the two queues are handled automatically with events :
+   ///  - Kernels enqueued after a Send wait for the end of that Send
+   ///  - A Read waits for the end of the kernels enqueued before it
+   ///  - A Send waits for the kernels that still use the image or buffer it writes to
+   /// Use different images for the frames that are processed at the same time to get the most overlap.
+   /// \param Use : true to use a separate queue for transfers, false to use a single queue (default)
+   void UseTransferQueue(bool Use = true);
+
+   /// Returns the OpenCL CommandQueue used for transfers (for internal use).
+   /// Returns the same queue as GetQueue() if UseTransferQueue() has not been called.
+   cl::CommandQueue& GetTransferQueue();
+
+   /// Returns true if a separate queue is used for transfers
+   bool HasTransferQueue() const;
+
+   /// Makes the commands later enqueued in the kernel queue wait for the given event (for internal use).
+   /// Does nothing if there is no separate transfer queue.
+   /// \param Event : Event of a transfer done in the transfer queue
+   void ComputeWaitsFor(const cl::Event& Event);
+
+   /// Adds to WaitList an event that signals the end of the commands already enqueued in the kernel queue (for internal use).
+   /// Used by transfers from the device so that they also wait for kernels that do not track their events.
+   /// Does nothing if there is no separate transfer queue.
+   /// \param WaitList : List of events a transfer will wait for
+   void WaitForKernels(std::vector<cl::Event>& WaitList);
+
+   /// Waits until all commands of all queues are done
+   void Finish();
+
+   /// Enables the profiling of device operations.
+   /// When enabled, the queues are created with CL_QUEUE_PROFILING_ENABLE and the timing of every kernel
+   /// called by the library and of every Send and Read of images and buffers is recorded.
+   /// Use GetProfilingRecords() to retreive the recorded timings.
+   /// Profiling adds a small overhead to each operation, so it is disabled by default.
+   /// Changing the profiling mode waits for all queued operations to be done.
+   /// \param Enable : true to enable profiling, false to disable it and discard the records
+   void EnableProfiling(bool Enable = true);
+
+   /// Returns true if profiling is enabled
+   bool IsProfiling() const;
+
+   /// Enables automatic tuning of work-group sizes.
+   /// When enabled, kernels of the library that are launched without a specific local range
+   /// are timed with a few candidate local ranges on their first launches, then the fastest
+   /// local range is used for each kernel, program version and image size.
+   /// When a binary cache path is set (see SetBinaryCachePath()), the results are saved
+   /// in that folder and loaded by later runs, so tuning is only done once per device.
+   /// Timing needs profiling to be enabled on the queues, they are recreated as needed.
+   /// Changing the tuning mode waits for all queued operations to be done.
+   /// \param Enable : true to enable tuning, false to let OpenCL choose the local ranges
+   void EnableWorkGroupTuning(bool Enable = true);
+
+   /// Returns true if work-group sizes are tuned automatically
+   bool IsTuningWorkGroups() const;
+
+   /// Returns the work-group tuner (for internal use) - only valid when IsTuningWorkGroups() is true
+   WorkGroupTuner& GetWorkGroupTuner();
+
+   /// Starts recording the kernels launched by the primitives of the library.
+   /// The primitives still run normally while recording.
+   /// Call EndRecording() to get the recorded OperationGraph.
+   void BeginRecording();
+
+   /// Stops recording and returns the recorded graph
+   /// \return a graph that can be launched many times, see OperationGraph
+   std::shared_ptr<OperationGraph> EndRecording();
+
+   /// Returns true between BeginRecording() and EndRecording()
+   bool IsRecording() const;
+
+   /// Returns the graph being recorded (for internal use) - only valid when IsRecording() is true
+   OperationGraph& GetRecordingGraph();
+
+   /// Records the event of an operation for profiling (for internal use).
+   /// \param Name : Name of the kernel or of the transfer
+   /// \param Width : Width of the image the operation works on
+   /// \param Height : Height of the image the operation works on
+   /// \param Event : Event of the operation
+   void AddProfilingRecord(const std::string& Name, uint Width, uint Height, const cl::Event& Event);
+
+   /// Returns the number of operations recorded and not yet retreived
+   size_t GetNbProfilingRecords() const;
+
+   /// Returns the timings of the recorded operations, oldest first.
+   /// Waits for the recorded operations to be done.
+   /// The returned records are removed from the list of recorded operations.
+   /// \param MaxRecords : Maximum number of records to return
+   std::vector<SProfilingRecord> GetProfilingRecords(size_t MaxRecords = size_t(-1));
+
    /// Returns the color image converter program (for internal use)
    Color& GetColorConverter();
 
+   /// Returns the program cache used to evaluate image buffer expressions (for internal use).
+   /// It is created on first use.
+   ExpressionEvaluator& GetExpressionEvaluator();
+
+   /// Returns the pool of threads used to build programs in the background (for internal use).
+   /// The threads are started on first use.
+   ThreadPool& GetBuildThreads();
+
+   /// Returns the pool of device memory used by images and buffers that don't use host memory.
+   /// Can be used to read statistics on device memory usage or to limit the amount of memory kept by the pool.
+   const std::shared_ptr<MemoryPool>& GetMemoryPool() const;
+
+   /// Allocates page-locked (pinned) host memory.
+   /// Images and image buffers that adopt pinned memory transfer their data at full DMA bandwidth.
+   /// \param Size : Size of the memory in bytes
+   std::shared_ptr<PinnedMemory> AllocHost(size_t Size);
+
    operator cl::Context& ();        ///< Converts to a cl::Context
    operator cl::CommandQueue& ();   ///< Converts to a cl::CommandQueue
    operator cl::Device& ();         ///< Converts to a cl::Device
@@ -95,6 +282,24 @@ public:
    /// When true, image transfers to the device are instantaneous.
    bool SupportsNoCopy() const;
 
+   /// Returns the capabilities of the device, queried when the COpenCL was created
+   const SDeviceInfo& GetDeviceInfo() const;
+
+   /// Selects how the data of an image or buffer is transferred (for internal use).
+   /// Host memory is used directly (NoCopyTransfer or MapTransfer) when the device shares its memory
+   /// with the host and when HostPtr (and RowPitch for images) are aligned as the device requires
+   /// (CL_DEVICE_MEM_BASE_ADDR_ALIGN). Otherwise the data is copied.
+   /// MapTransfer is always used when flags contains CL_MEM_USE_HOST_PTR.
+   /// \param HostPtr : Pointer to the data in host memory, CopyTransfer is used when null
+   /// \param flags : Flags requested for the image or buffer
+   /// \param RowPitch : Size in bytes of a line of the image, 0 for buffers
+   ETransferStrategy GetTransferStrategy(const void * HostPtr, cl_mem_flags flags, size_t RowPitch = 0) const;
+
+   /// True when 2D images of the given format can be created with the given flags
+   /// \param Format : Format of the image
+   /// \param flags : Type of OpenCL memory, only the access flags (CL_MEM_READ_WRITE, CL_MEM_WRITE_ONLY, CL_MEM_READ_ONLY) are used
+   bool IsSupportedFormat(const cl::ImageFormat& Format, cl_mem_flags flags) const;
+
    /* Running custom kernels :
 
    COpenCL CL;
@@ -113,10 +318,43 @@ protected:
    cl::Device m_Device;          ///< The OpenCL device (like GTX 680)
    cl::Context m_Context;        ///< The OpenCL context for the device
    cl::CommandQueue m_Queue;     ///< The OpenCL command queue for the context
+   cl::CommandQueue m_TransferQueue;   ///< Separate queue used for transfers, null if not used
+
+   cl_command_queue_properties m_QueueProperties;   ///< Properties used to create the queues
+
+   bool m_Profiling;             ///< true when profiling is enabled
+
+   /// Recreates the queues when profiling or work-group tuning is enabled or disabled
+   void UpdateQueueProperties();
+
+   SDeviceInfo m_DeviceInfo;     ///< Capabilities of the device
+
+   /// An operation recorded for profiling
+   struct SProfiledOperation
+   {
+      std::string Name;
+      uint Width;
+      uint Height;
+      cl::Event Event;
+   };
+
+   std::vector<SProfiledOperation> m_ProfiledOperations;   ///< Operations recorded since the last call to GetProfilingRecords()
 
    std::shared_ptr<Color> m_ColorConverter;  ///< Instance of the color converter program used to automatically convert 3 channel images to 4 channel images
 
+   std::shared_ptr<MemoryPool> m_MemoryPool; ///< Device memory recycled by images and buffers - shared with them so it outlives the COpenCL
+
+   std::shared_ptr<WorkGroupTuner> m_WorkGroupTuner;  ///< Selects the local ranges of kernels, null when tuning is disabled
+
+   std::shared_ptr<OperationGraph> m_RecordingGraph;  ///< Graph being recorded, null when not recording
+
+   std::shared_ptr<ExpressionEvaluator> m_ExpressionEvaluator; ///< Programs generated for image buffer expressions, null until first used
+
+   std::shared_ptr<ThreadPool> m_BuildThreads;  ///< Threads used by background program builds - must stay the last member so it is destroyed first
+
    static std::string m_ClFilesPath;   ///< Path to the .cl files
+   static bool m_UseClFiles;           ///< true to read .cl files instead of using the sources compiled in the library
+   static std::string m_BinaryCachePath;  ///< Path to the compiled program cache
 };
 
 }  // End of namespace
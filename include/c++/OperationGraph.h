@@ -0,0 +1,195 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: OperationGraph.h
+//! @date   : Oct 2026
+//!
+//! @brief  : Recording and replay of sequences of kernel launches
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include "Image.h"
+
+#include <type_traits>
+
+namespace OpenCLIPP
+{
+
+/// A sequence of kernel launches that can be replayed.
+/// A graph is recorded by calling primitives of the library between COpenCL::BeginRecording()
+/// and COpenCL::EndRecording(). The primitives run normally while recording, and each kernel they launch
+/// is added to the graph with its arguments and ranges.
+/// Launch() then enqueues the same kernels again without checking the arguments, selecting programs
+/// or setting kernel arguments, which removes most of the host overhead of a fixed per-frame sequence of primitives.
+/// The images used by the graph can be replaced by other images of the same size and type with Replace().
+/// Only kernel launches are recorded : Send(), Read() and the work primitives do on the host (like the final
+/// step of reductions in Statistics) are not part of the graph.
+/// Temporary images and buffers created by the recorded primitives are kept by the graph.
+/// Usage :
+///   CL.BeginRecording();
+///   Arithmetic.Add(Source1, Source2, Temp);
+///   Filters.Gauss(Temp, Dest, 3);
+///   std::shared_ptr<OperationGraph> Graph = CL.EndRecording();
+///
+///   Graph->Replace(Source1, NextFrame);
+///   Graph->Launch();
+///   Dest.Read(true);
+class CL_API OperationGraph
+{
+public:
+   /// Constructor - use COpenCL::BeginRecording() and COpenCL::EndRecording() to create a graph
+   /// \param CL : A COpenCL instance
+   OperationGraph(COpenCL& CL);
+
+   /// Destructor - allows the MemoryPool to recycle the memory used by the graph
+   ~OperationGraph();
+
+   /// Enqueues all the recorded kernels, in the order they were recorded.
+   /// Inputs that are not in the device are sent and each kernel waits for the operations
+   /// of other queues on its images, like when the primitives are called.
+   void Launch();
+
+   /// Makes later launches use Replacement where Recorded was used.
+   /// \param Recorded : An image used by the recorded primitives
+   /// \param Replacement : An image of the same size, type and origin
+   void Replace(IImage& Recorded, IImage& Replacement);
+
+   /// Makes later launches use Replacement where Recorded was used.
+   /// \param Recorded : An image buffer used by the recorded primitives
+   /// \param Replacement : An image buffer of the same size and type
+   void Replace(ImageBuffer& Recorded, ImageBuffer& Replacement);
+
+   /// Makes later launches use Replacement where Recorded was used.
+   /// \param Recorded : A buffer used by the recorded primitives
+   /// \param Replacement : A buffer of the same size
+   void Replace(IBuffer& Recorded, IBuffer& Replacement);
+
+   /// Returns the number of recorded kernel launches
+   size_t GetNbSteps() const;
+
+
+   // For internal use - used by the Kernel_ macro to record kernel launches
+
+   /// How a kernel argument is used
+   enum EArgRole
+   {
+      Input,   ///< Source image - read by the kernel
+      Output,  ///< Destination image - written by the kernel
+      Value,   ///< Other argument
+   };
+
+   /// Starts recording a kernel launch (for internal use).
+   /// \param Program : Program that contains the kernel
+   /// \param Name : Name of the kernel
+   /// \param Args : Ranges of the launch
+   /// \param Width : Width of the first source, used for profiling
+   /// \param Height : Height of the first source, used for profiling
+   void AddStep(const cl::Program& Program, const std::string& Name, const cl::EnqueueArgs& Args, uint Width, uint Height);
+
+   /// Sets the next argument of the kernel added by the last call to AddStep() (for internal use).
+   /// \param Value : Value of the argument
+   /// \param Object : The image or buffer given as argument, nullptr for other arguments
+   /// \param Role : How the argument is used
+   template<class T>
+   void AddArg(const T& Value, Memory * Object, EArgRole Role);
+
+private:
+   OperationGraph(const OperationGraph&);             // Not copyable
+   OperationGraph& operator = (const OperationGraph&);
+
+   /// An image or buffer used by a kernel
+   struct SMemoryArg
+   {
+      cl_uint Index;                // Index of the argument
+      Memory * Object;              // The object that was given as argument
+      std::weak_ptr<void> Lifetime; // Expired when Object has been destroyed - like temporary images of the primitives
+      cl::Memory Handle;            // Keeps the memory alive
+      EArgRole Role;
+   };
+
+   /// A recorded kernel launch
+   struct SStep
+   {
+      cl::Kernel Kernel;            // Kernel object that belongs to the step - its arguments are set when recording
+      cl::NDRange Offset;           // Origin of the images when they are views
+      cl::NDRange Global;
+      cl::NDRange Local;
+      std::string Name;             // For profiling
+      uint Width;
+      uint Height;
+      cl_uint NbArgs;
+      std::vector<SMemoryArg> MemoryArgs;
+   };
+
+   void KeepHandle(SMemoryArg& Arg, const cl::Memory * Handle);   // Keeps the memory of an image or buffer argument
+   void KeepHandle(SMemoryArg&, const void *) { }                // Other arguments
+
+   void ReplaceHandle(Memory& Recorded, Memory& Replacement, const cl::Memory& Handle);
+
+   COpenCL * m_CL;
+   std::shared_ptr<MemoryPool> m_Pool; // Kept so the reservations can be removed after the COpenCL is destroyed
+   std::vector<SStep> m_Steps;
+};
+
+
+template<class T>
+inline void OperationGraph::AddArg(const T& Value, Memory * Object, EArgRole Role)
+{
+   SStep& Step = m_Steps.back();
+   Step.Kernel.setArg(Step.NbArgs, Value);
+
+   if (Object != nullptr)
+   {
+      SMemoryArg Arg;
+      Arg.Index = Step.NbArgs;
+      Arg.Object = Object;
+      Arg.Lifetime = Object->GetLifetime();
+      Arg.Role = Role;
+      KeepHandle(Arg, &Value);
+      Step.MemoryArgs.push_back(Arg);
+   }
+
+   Step.NbArgs++;
+}
+
+
+// Helpers for the Kernel_ macro
+
+/// Returns the Memory of an image or buffer argument, nullptr for other arguments (for internal use)
+template<class T>
+inline typename std::enable_if<std::is_base_of<Memory, T>::value, Memory *>::type _MemoryOf(T& Object)
+{
+   return &Object;
+}
+
+template<class T>
+inline typename std::enable_if<!std::is_base_of<Memory, T>::value, Memory *>::type _MemoryOf(const T&)
+{
+   return nullptr;
+}
+
+/// Converts a kernel argument to the type used by cl::make_kernel (for internal use)
+template<class T>
+inline T _ClArg(T Value)
+{
+   return Value;
+}
+
+}
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: PinnedMemory.h
+//! @date   : Oct 2026
+//!
+//! @brief  : Page-locked host memory for fast transfers
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include "OpenCL.h"
+
+namespace OpenCLIPP
+{
+
+/// Page-locked (pinned) host memory.
+/// Allocated by the OpenCL driver with CL_MEM_ALLOC_HOST_PTR and kept mapped for the host to use.
+/// Transfers between pinned memory and the device don't need a staging copy by the driver
+/// so they run at the full DMA bandwidth of the device.
+/// Usually created with COpenCL::AllocHost() and given to an Image or ImageBuffer that adopts it.
+class CL_API PinnedMemory
+{
+public:
+   /// Constructor.
+   /// Allocates and maps the memory
+   /// \param CL : A COpenCL instance
+   /// \param Size : Size of the memory in bytes
+   PinnedMemory(COpenCL& CL, size_t Size);
+
+   /// Destructor.
+   /// Unmaps the memory, the memory is freed by the driver when the unmap is done
+   ~PinnedMemory();
+
+   /// Returns the host pointer to the memory
+   void * Data() const
+   {
+      return m_Data;
+   }
+
+   /// Returns the size in bytes
+   size_t Size() const
+   {
+      return m_Size;
+   }
+
+private:
+   PinnedMemory(const PinnedMemory&);              // Not copyable
+   PinnedMemory& operator = (const PinnedMemory&);
+
+   cl::CommandQueue m_Queue;  // Queue used to map and unmap the memory
+   cl::Buffer m_Buffer;       // The buffer that owns the memory
+   void * m_Data;             // Mapped pointer
+   size_t m_Size;             // Size in bytes
+};
+
+}
@@ -30,11 +30,12 @@ namespace OpenCLIPP
 {
 
 /// A program that does Arithmetic operations on image buffers
+/// A batch of images (see ImageBufferBatch) is processed with a single launch, like one tall image
 class CL_API ArithmeticVector : public ImageBufferProgram
 {
 public:
    ArithmeticVector(COpenCL& CL)
-      :  ImageBufferProgram(CL, "Vector_Arithmetic.cl")
+      :  ImageBufferProgram(CL, "Vector_Arithmetic.cl", 8)
    { }
 
 
@@ -0,0 +1,312 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: BufferExpression.h
+//! @date   : Oct 2026
+//!
+//! @brief  : Lazy arithmetic expressions on image buffers
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include "Program.h"
+
+#include <type_traits>
+
+/*
+
+Arithmetic on ImageBuffer objects can be written as expressions :
+
+   ImageBuffer A(CL, Img, DataA), B(CL, Img, DataB), C(CL, Img, DataC), Dest(CL, Img, DataDest);
+
+   Dest = Abs(A - B) * 0.5f + C;
+
+The expression is not calculated by the operators, they build an object that describes it.
+Assigning that object to an ImageBuffer generates a single kernel that calculates the whole
+expression, without temporary images and with a single pass on the data.
+Generated kernels are kept by COpenCL and reused when an expression of the same shape
+is evaluated again, values (like 0.5f above) are given to the kernel as arguments.
+
+All image buffers of an expression must have the same size, type and number of channels.
+An expression can use up to ExpressionBuilder::MaxBuffers image buffers and
+up to ExpressionBuilder::MaxValues values.
+Calculations are done in float, the result is converted with saturation to the type of the destination.
+
+*/
+
+namespace OpenCLIPP
+{
+
+/// Collects the image buffers and values used by an expression while its code is generated
+class CL_API ExpressionBuilder
+{
+public:
+   enum
+   {
+      MaxBuffers = 4,   ///< Maximum number of image buffers in an expression
+      MaxValues = 16,   ///< Maximum number of values in an expression
+   };
+
+   /// Adds an image buffer to the expression, returns the code to access its value
+   std::string Buffer(ImageBuffer& Image);
+
+   /// Adds a value to the expression, returns the code to access it
+   std::string Value(float value);
+
+   const std::vector<ImageBuffer *>& GetBuffers() const { return m_Buffers; }  ///< Image buffers used by the expression
+   const std::vector<float>& GetValues() const { return m_Values; }            ///< Values used by the expression
+
+private:
+   std::vector<ImageBuffer *> m_Buffers;
+   std::vector<float> m_Values;
+};
+
+
+/// Runs the kernels generated for expressions (for internal use - use ImageBuffer::operator = instead)
+class CL_API ExpressionEvaluator
+{
+public:
+   ExpressionEvaluator(COpenCL& CL);   ///< Constructor
+
+   /// Calculates the expression described by Code into Dest
+   void Evaluate(const std::string& Code, const ExpressionBuilder& Builder, ImageBuffer& Dest);
+
+   /// Returns the number of different expression shapes that have been generated so far
+   size_t GetNbKernels() const { return m_Programs.size(); }
+
+   /// Generates the OpenCL C source of the kernel for an expression
+   static std::string GenerateSource(const std::string& Code, uint NbBuffers);
+
+protected:
+   COpenCL * m_CL;   ///< Pointer to the COpenCL object the kernels are built for
+
+   /// Generated programs, by expression code - each program has a version per data type
+   std::map<std::string, std::shared_ptr<ImageBufferProgram>> m_Programs;
+   std::mutex m_Mutex;  ///< Protects m_Programs
+
+   /// Returns the program for the expression, generating it if needed
+   ImageBufferProgram& SelectProgram(const std::string& Code, uint NbBuffers);
+};
+
+
+/// Base class of all expressions - E is the actual expression class
+template<class E>
+class BufferExpression
+{
+public:
+   const E& Derived() const { return static_cast<const E&>(*this); }
+};
+
+
+/// An image buffer used in an expression
+class BufferTerm : public BufferExpression<BufferTerm>
+{
+public:
+   BufferTerm(const ImageBuffer& Image)
+   :  m_Image(const_cast<ImageBuffer *>(&Image))   // Expressions only read their image buffers
+   { }
+
+   std::string Generate(ExpressionBuilder& Builder) const
+   {
+      return Builder.Buffer(*m_Image);
+   }
+
+private:
+   ImageBuffer * m_Image;
+};
+
+/// A value used in an expression
+class ValueTerm : public BufferExpression<ValueTerm>
+{
+public:
+   ValueTerm(float value)
+   :  m_Value(value)
+   { }
+
+   std::string Generate(ExpressionBuilder& Builder) const
+   {
+      return Builder.Value(m_Value);
+   }
+
+private:
+   float m_Value;
+};
+
+/// An operation on the result of an expression
+template<class Op, class T>
+class UnaryExpression : public BufferExpression<UnaryExpression<Op, T> >
+{
+public:
+   UnaryExpression(const T& Operand)
+   :  m_Operand(Operand)
+   { }
+
+   std::string Generate(ExpressionBuilder& Builder) const
+   {
+      return Op::Code(m_Operand.Generate(Builder));
+   }
+
+private:
+   T m_Operand;
+};
+
+/// An operation on the results of two expressions
+template<class Op, class L, class R>
+class BinaryExpression : public BufferExpression<BinaryExpression<Op, L, R> >
+{
+public:
+   BinaryExpression(const L& Left, const R& Right)
+   :  m_Left(Left),
+      m_Right(Right)
+   { }
+
+   std::string Generate(ExpressionBuilder& Builder) const
+   {
+      // Left is generated first so that the code of an expression does not depend on the compiler
+      std::string Left = m_Left.Generate(Builder);
+      return Op::Code(Left, m_Right.Generate(Builder));
+   }
+
+private:
+   L m_Left;
+   R m_Right;
+};
+
+
+// Operations - generate the OpenCL C code of the operation
+struct _AddOp  { static std::string Code(const std::string& A, const std::string& B) { return "(" + A + " + " + B + ")"; } };
+struct _SubOp  { static std::string Code(const std::string& A, const std::string& B) { return "(" + A + " - " + B + ")"; } };
+struct _MulOp  { static std::string Code(const std::string& A, const std::string& B) { return "(" + A + " * " + B + ")"; } };
+struct _DivOp  { static std::string Code(const std::string& A, const std::string& B) { return "(" + A + " / " + B + ")"; } };
+struct _MinOp  { static std::string Code(const std::string& A, const std::string& B) { return "min(" + A + ", " + B + ")"; } };
+struct _MaxOp  { static std::string Code(const std::string& A, const std::string& B) { return "max(" + A + ", " + B + ")"; } };
+struct _NegOp  { static std::string Code(const std::string& A) { return "(-" + A + ")"; } };
+struct _AbsOp  { static std::string Code(const std::string& A) { return "fabs(" + A + ")"; } };
+struct _InvertOp { static std::string Code(const std::string& A) { return "(255.f - " + A + ")"; } };
+struct _SqrOp  { static std::string Code(const std::string& A) { return "(" + A + " * " + A + ")"; } };
+struct _SqrtOp { static std::string Code(const std::string& A) { return "sqrt(" + A + ")"; } };
+struct _ExpOp  { static std::string Code(const std::string& A) { return "exp(" + A + ")"; } };
+struct _LogOp  { static std::string Code(const std::string& A) { return "log(" + A + ")"; } };
+struct _SinOp  { static std::string Code(const std::string& A) { return "sin(" + A + ")"; } };
+struct _CosOp  { static std::string Code(const std::string& A) { return "cos(" + A + ")"; } };
+
+
+// _Operand<T> gives the expression class to use for an operand of type T
+template<class T, class Enable = void>
+struct _Operand
+{
+   static const bool IsOperand = false;
+};
+
+template<class T>
+struct _Operand<T, typename std::enable_if<std::is_base_of<ImageBuffer, T>::value>::type>
+{
+   static const bool IsOperand = true;
+   typedef BufferTerm Type;
+   static BufferTerm Make(const T& Image) { return BufferTerm(Image); }
+};
+
+template<class T>
+struct _Operand<T, typename std::enable_if<std::is_arithmetic<T>::value>::type>
+{
+   static const bool IsOperand = true;
+   typedef ValueTerm Type;
+   static ValueTerm Make(T value) { return ValueTerm(float(value)); }
+};
+
+template<class T>
+struct _Operand<T, typename std::enable_if<std::is_base_of<BufferExpression<T>, T>::value>::type>
+{
+   static const bool IsOperand = true;
+   typedef T Type;
+   static const T& Make(const T& Expression) { return Expression; }
+};
+
+// _Unary and _Binary give the expression class of an operation, they have no Type when the operands
+// are not valid, so that the operators below are only used for expressions
+template<class Op, class T, class Enable = void>
+struct _Unary { };
+
+template<class Op, class T>
+struct _Unary<Op, T, typename std::enable_if<_Operand<T>::IsOperand && !std::is_arithmetic<T>::value>::type>
+{
+   typedef UnaryExpression<Op, typename _Operand<T>::Type> Type;
+   static Type Make(const T& Operand) { return Type(_Operand<T>::Make(Operand)); }
+};
+
+template<class Op, class L, class R, class Enable = void>
+struct _Binary { };
+
+template<class Op, class L, class R>
+struct _Binary<Op, L, R, typename std::enable_if<_Operand<L>::IsOperand && _Operand<R>::IsOperand &&
+   !(std::is_arithmetic<L>::value && std::is_arithmetic<R>::value)>::type>
+{
+   typedef BinaryExpression<Op, typename _Operand<L>::Type, typename _Operand<R>::Type> Type;
+   static Type Make(const L& Left, const R& Right) { return Type(_Operand<L>::Make(Left), _Operand<R>::Make(Right)); }
+};
+
+
+// Operators and functions - operands can be ImageBuffer objects, expressions or values
+#define _BINARY_OPERATION(name, op)\
+   template<class L, class R>\
+   typename _Binary<op, L, R>::Type name(const L& Left, const R& Right)\
+   {\
+      return _Binary<op, L, R>::Make(Left, Right);\
+   }
+
+#define _UNARY_OPERATION(name, op)\
+   template<class T>\
+   typename _Unary<op, T>::Type name(const T& Operand)\
+   {\
+      return _Unary<op, T>::Make(Operand);\
+   }
+
+_BINARY_OPERATION(operator +, _AddOp)  ///< A + B
+_BINARY_OPERATION(operator -, _SubOp)  ///< A - B
+_BINARY_OPERATION(operator *, _MulOp)  ///< A * B
+_BINARY_OPERATION(operator /, _DivOp)  ///< A / B
+_BINARY_OPERATION(Min, _MinOp)         ///< min(A, B)
+_BINARY_OPERATION(Max, _MaxOp)         ///< max(A, B)
+
+_UNARY_OPERATION(operator -, _NegOp)   ///< -A
+_UNARY_OPERATION(Abs, _AbsOp)          ///< abs(A)
+_UNARY_OPERATION(Invert, _InvertOp)    ///< 255 - A
+_UNARY_OPERATION(Sqr, _SqrOp)          ///< A * A
+_UNARY_OPERATION(Sqrt, _SqrtOp)        ///< sqrt(A)
+_UNARY_OPERATION(Exp, _ExpOp)          ///< exp(A)
+_UNARY_OPERATION(Log, _LogOp)          ///< log(A)
+_UNARY_OPERATION(Sin, _SinOp)          ///< sin(A)
+_UNARY_OPERATION(Cos, _CosOp)          ///< cos(A)
+
+#undef _BINARY_OPERATION
+#undef _UNARY_OPERATION
+
+
+template<class E>
+ImageBuffer& ImageBuffer::operator = (const BufferExpression<E>& Expression)
+{
+   ExpressionBuilder Builder;
+   std::string Code = Expression.Derived().Generate(Builder);
+
+   m_CL.GetExpressionEvaluator().Evaluate(Code, Builder, *this);
+
+   return *this;
+}
+
+}
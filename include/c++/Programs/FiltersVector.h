@@ -30,6 +30,8 @@ namespace OpenCLIPP
 {
 
 /// A program for convolution-type filters on images
+/// Each channel of packed images with more than 1 channel (like RGB) is filtered separately, without conversion to 4 channels
+/// Each image of a batch (see ImageBufferBatch) is filtered separately, with a single launch for the batch
 class CL_API FiltersVector : public ImageBufferProgram
 {
 public:
@@ -0,0 +1,195 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: Fusion.h
+//! @date   : Oct 2026
+//!
+//! @brief  : Fusion of pointwise operations into single kernels
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include "Program.h"
+#include "Tresholding.h"
+
+namespace OpenCLIPP
+{
+
+/// A sequence of pointwise operations, to be run as a single kernel by Fusion.
+/// Each operation works on the result of the previous one, the first one works on the source image.
+/// Operations mirror the pointwise primitives of Arithmetic, Logic, Lut, Tresholding and Conversions.
+/// Intermediate results of arithmetic, Lut and Tresholding operations are kept as float, conversion
+/// to the type of the destination image (with saturation) happens only when the result is written.
+/// So results can differ slightly from the separate primitives when an intermediate result
+/// would have been rounded or saturated.
+/// Logic operations work on integers masked to the depth of the source image, like Logic does,
+/// consecutive logic operations keep all the bits of the pixels.
+/// A chain can use up to MaxValues values and up to MaxImages additional images,
+/// methods throw a cl::Error when these limits are exceeded.
+/// Additional images must stay alive until the chain has been run.
+class CL_API PointwiseChain
+{
+public:
+   PointwiseChain();    ///< Constructor - creates an empty chain
+
+   enum
+   {
+      MaxValues = 16,   ///< Maximum number of values a chain can use
+      MaxImages = 3,    ///< Maximum number of additional images a chain can use
+   };
+
+   // Arithmetic
+   PointwiseChain& Add(IImage& Image);       ///< P = P + I
+   PointwiseChain& AddSquare(IImage& Image); ///< P = P + I * I
+   PointwiseChain& Sub(IImage& Image);       ///< P = P - I
+   PointwiseChain& AbsDiff(IImage& Image);   ///< P = abs(P - I)
+   PointwiseChain& Mul(IImage& Image);       ///< P = P * I
+   PointwiseChain& Div(IImage& Image);       ///< P = P / I
+   PointwiseChain& Min(IImage& Image);       ///< P = min(P, I)
+   PointwiseChain& Max(IImage& Image);       ///< P = max(P, I)
+   PointwiseChain& Mean(IImage& Image);      ///< P = (P + I) / 2
+   PointwiseChain& Combine(IImage& Image);   ///< P = sqrt(P * P + I * I)
+
+   PointwiseChain& Add(float value);      ///< P = P + v
+   PointwiseChain& Sub(float value);      ///< P = P - v
+   PointwiseChain& AbsDiff(float value);  ///< P = abs(P - v)
+   PointwiseChain& Mul(float value);      ///< P = P * v
+   PointwiseChain& Div(float value);      ///< P = P / v
+   PointwiseChain& RevDiv(float value);   ///< P = v / P
+   PointwiseChain& Min(float value);      ///< P = min(P, v)
+   PointwiseChain& Max(float value);      ///< P = max(P, v)
+   PointwiseChain& Mean(float value);     ///< P = (P + v) / 2
+
+   PointwiseChain& Abs();     ///< P = abs(P)
+   PointwiseChain& Invert();  ///< P = 255 - P
+   PointwiseChain& Exp();     ///< P = exp(P)
+   PointwiseChain& Log();     ///< P = log(P)
+   PointwiseChain& Sqr();     ///< P = P * P
+   PointwiseChain& Sqrt();    ///< P = sqrt(P)
+   PointwiseChain& Sin();     ///< P = sin(P)
+   PointwiseChain& Cos();     ///< P = cos(P)
+
+   // Logic - the source image must not be float
+   PointwiseChain& And(IImage& Image);    ///< P = P & I
+   PointwiseChain& Or(IImage& Image);     ///< P = P | I
+   PointwiseChain& Xor(IImage& Image);    ///< P = P ^ I
+   PointwiseChain& And(uint value);       ///< P = P & v
+   PointwiseChain& Or(uint value);        ///< P = P | v
+   PointwiseChain& Xor(uint value);       ///< P = P ^ v
+   PointwiseChain& Not();                 ///< P = ~P
+
+   // Lut
+   /// Discrete LUT, same as Lut::LUT() - uses 2 * NbValues values.
+   PointwiseChain& LUT(const uint * levels, const uint * values, uint NbValues);
+
+   /// Linear LUT, same as Lut::LUTLinear() - uses 2 * NbValues values.
+   PointwiseChain& LUTLinear(const float * levels, const float * values, uint NbValues);
+
+   /// Linear scaling of the range SrcMin..SrcMax to DstMin..DstMax, same as Lut::Scale()
+   PointwiseChain& Scale(float SrcMin, float SrcMax, float DstMin, float DstMax);
+
+   // Tresholding
+   PointwiseChain& TresholdGT(float Tresh, float valueHigher = 255);    ///< P = (P > T ? VH : P)
+   PointwiseChain& TresholdLT(float Tresh, float valueLower = 0);       ///< P = (P < T ? VL : P)
+
+   /// P = (P > TH ? VH : (P < TL ? VL : P))
+   PointwiseChain& TresholdGTLT(float threshLT, float valueLower, float treshGT, float valueHigher);
+
+   /// P = (P Op v) - P will be 0 or 1
+   PointwiseChain& Compare(float value, Tresholding::ECompareOperation Op = Tresholding::GT);
+
+   /// P = (P Op I) - P will be 0 or 1
+   PointwiseChain& Compare(IImage& Image, Tresholding::ECompareOperation Op = Tresholding::GT);
+
+   // Conversions
+   /// P = P * Ratio + Offset, same as Conversions::Scale()
+   PointwiseChain& Scale(int Offset, float Ratio);
+
+   /// Removes all operations from the chain
+   void Clear();
+
+   /// Returns true if the chain contains no operations
+   bool IsEmpty() const { return m_NbOperations == 0; }
+
+   /// Returns true if the chain contains logic operations, which need an integer source image
+   bool UsesLogic() const { return m_UsesLogic; }
+
+   /// Returns true if the result of the chain is the integer result of a logic operation
+   bool HasLogicResult() const { return !m_InFloat; }
+
+   const std::string& GetCode() const { return m_Code; }                ///< OpenCL C code of the operations
+   const std::vector<float>& GetValues() const { return m_Values; }     ///< Values used by the operations
+   const std::vector<IImage *>& GetImages() const { return m_Images; }  ///< Additional images used by the operations
+
+private:
+   std::string m_Code;              ///< Code of the operations, works on P (float) and L (integer, for logic operations)
+   std::vector<float> m_Values;     ///< Values given to the kernel
+   std::vector<IImage *> m_Images;  ///< Additional images given to the kernel
+   uint m_NbOperations;             ///< Number of operations in the chain
+   bool m_UsesLogic;                ///< true if the chain contains logic operations
+   bool m_InFloat;                  ///< true if P contains the current result
+   bool m_InLogic;                  ///< true if L contains the current result
+
+   PointwiseChain& Operation(const std::string& Code);   ///< Adds the given code to the chain
+   PointwiseChain& LogicOperation(const std::string& Code); ///< Adds a logic operation, Code is the new value of L
+   PointwiseChain& AddCode(const std::string& Code);     ///< Adds a line of code to the chain
+   std::string Value(float value);                       ///< Adds a value, returns the code to access it
+   std::string LogicValue(uint value);                   ///< Adds a value for logic operations, returns the code to access it
+   std::string ImageValue(IImage& Image);                ///< Adds an image, returns the code to access its pixel
+};
+
+
+/// Runs sequences of pointwise operations as single kernels.
+/// Each distinct chain (and combination of image types) gets its own generated kernel,
+/// generated kernels are kept so that running the same chain again does not build anything.
+/// Values used by the chain are given to the kernel as arguments, so chains that differ
+/// only by their values share the same kernel.
+/// Running a chain reads each image once and writes the destination once, instead of
+/// a full round-trip to global memory for each operation.
+/// Generated programs use the binary cache of COpenCL, if enabled.
+class CL_API Fusion
+{
+public:
+   Fusion(COpenCL& CL);    ///< Constructor
+
+   /// Runs the chain on Source, writing the result in Dest.
+   /// All images must have the same size, the type of the images can be different.
+   void Run(const PointwiseChain& Chain, IImage& Source, IImage& Dest);
+
+   /// Generates and builds the kernel needed to run the chain with images of these types.
+   /// Allows preparing kernels in advance, as building can take a significant amount of time.
+   void PrepareFor(const PointwiseChain& Chain, const ImageBase& Source, const ImageBase& Dest);
+
+   /// Returns the number of kernels generated so far
+   size_t GetNbKernels() const { return m_Programs.size(); }
+
+   /// Generates the OpenCL C source of the kernel that runs the chain on images of these types.
+   static std::string GenerateSource(const PointwiseChain& Chain, const ImageBase& Source, const ImageBase& Dest);
+
+protected:
+   COpenCL * m_CL;   ///< Pointer to the COpenCL object the kernels are built for
+
+   std::map<std::string, std::shared_ptr<Program>> m_Programs; ///< Generated programs, by source
+   std::mutex m_Mutex;  ///< Protects m_Programs
+
+   /// Returns the program for the chain, generating it if needed
+   Program& SelectProgram(const PointwiseChain& Chain, const ImageBase& Source, const ImageBase& Dest);
+};
+
+}
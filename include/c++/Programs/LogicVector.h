@@ -34,7 +34,7 @@ class CL_API LogicVector : public ImageBufferProgram
 {
 public:
    LogicVector(COpenCL& CL)
-      :  ImageBufferProgram(CL, "Vector_Logic.cl")
+      :  ImageBufferProgram(CL, "Vector_Logic.cl", 8)
    { }
 
    // Bitwise operations - float images not allowed
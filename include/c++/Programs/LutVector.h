@@ -30,11 +30,12 @@ namespace OpenCLIPP
 {
 
 /// A program that does LUT (Look Up Table) transformation of image buffers
+/// The same LUT is applied to every channel of packed images with more than 1 channel (like RGB)
 class CL_API LutVector : public ImageBufferProgram
 {
 public:
    LutVector(COpenCL& CL)
-   :  ImageBufferProgram(CL, "Vector_Lut.cl")
+   :  ImageBufferProgram(CL, "Vector_Lut.cl", 4)
    { }
 
    /// Performs a LUT operation.
@@ -30,6 +30,7 @@ namespace OpenCLIPP
 {
 
 /// A program that does morphological operations
+/// Each channel of packed images with more than 1 channel (like RGB) is processed separately, without conversion to 4 channels
 class CL_API MorphologyBuffer : public ImageBufferProgram
 {
 public:
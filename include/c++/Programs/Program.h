@@ -31,6 +31,12 @@
 #include "../OpenCL.h"
 #include "../Image.h"
 
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <thread>
+
 namespace OpenCLIPP
 {
 
@@ -65,9 +71,26 @@ public:
    ///  - Build messages are sent to std::cerr
    /// Take note that building an OpenCL C program can be long (sometimes >100ms).
    /// So build the program in advance if a result is desired quickly.
+   /// Can be called from multiple threads, if the program is being built by another thread,
+   /// the call waits for that build to finish.
    /// \return true if build operation is succesful
    bool Build();
 
+   /// Returns the kernel with the given name.
+   /// The kernel object is created on first use and then kept for later calls,
+   /// so that repeated calls do not pay the cost of creating a new kernel object.
+   /// Each thread gets its own kernel object, as setting the arguments of a kernel is not thread-safe.
+   /// Builds the program if it was not already built.
+   /// \param Name : Name of the kernel in the program
+   cl::Kernel& GetKernel(const std::string& Name);
+
+   /// Returns a string that identifies the program and its options.
+   /// Used to store the work-group sizes tuned for the kernels of this version of the program.
+   const std::string& GetIdentifier() const
+   {
+      return m_Identifier;
+   }
+
    operator cl::Program& ()
    {
       return m_Program;
@@ -78,10 +101,18 @@ protected:
    std::string m_Path;        ///< Path of the .cl file
    std::string m_Source;      ///< Given source of the program
    std::string m_Options;     ///< Options to give to the OpenCL C compiler
+   std::string m_Identifier;  ///< Identifies the program and its options, see GetIdentifier()
    cl::Program m_Program;     ///< The ecapsulated program object
-   bool m_Built;              ///< true when the program has been successfully built
+   std::atomic<bool> m_Built; ///< true when the program has been successfully built
+   std::mutex m_BuildMutex;   ///< Held while the program is being built
+
+   typedef std::pair<std::thread::id, std::string> KernelKey;   ///< Thread that uses the kernel and name of the kernel
+   std::map<KernelKey, cl::Kernel> m_Kernels; ///< Kernel objects already created for this program, by thread and name
+   std::mutex m_KernelsMutex; ///< Protects m_Kernels, kernels can be requested from multiple threads
 
    static std::string LoadClFile(const std::string& Path);   ///< Reads the content of the given file
+   static std::string LoadClSource(const std::string& Name); ///< Gets the source of a .cl file, embedded in the library or read from the .cl files folder
+   static std::string ExpandIncludes(const std::string& Source);  ///< Replaces the #include "file.cl" lines with the source of these files
 };
 
 
@@ -93,6 +124,14 @@ public:
 
    COpenCL& GetCL() { return *m_CL; }  ///< Returns a reference to the COpenCL object this program is assotiated to
 
+   /// Builds all versions of the program in background threads.
+   /// Returns immediately, the versions are built in parallel by the threads of COpenCL::GetBuildThreads().
+   /// The program can be used while it is being built, a call will only wait if the
+   /// version it needs is still being built.
+   /// \return a future that becomes ready when all versions are built.
+   ///   Its get() method rethrows the cl::Error of a version that failed to build.
+   std::shared_future<void> PrepareAllAsync();
+
 protected:
    MultiProgram(COpenCL& CL);    ///< Constructor
 
@@ -118,6 +157,8 @@ protected:
 
    void PrepareProgram(uint Id);    ///< Builds the program specified by Id
 
+   std::shared_future<void> PrepareProgramAsync(uint Id);   ///< Builds the program specified by Id in a background thread
+
    COpenCL * m_CL;   ///< Pointer to the COpenCL object this program is assotiated to
 
 private:
@@ -152,7 +193,7 @@ public:
    {
       Signed,        ///< Signed integer
       Unsigned,      ///< Unsigned integer
-      Float,         ///< float (32-bit only)
+      Float,         ///< float (32-bit, 16-bit images are read and written as float)
       NbPixelTypes,
    };
 
@@ -161,14 +202,26 @@ public:
    /// the program during when starting so it will be ready when needed.
    void PrepareFor(ImageBase& Source);
 
+   /// Build the version of the program appropriate for this image in a background thread.
+   /// Returns immediately, using the program with this type of image before
+   /// the build is finished will wait for the build to finish.
+   /// \return a future that becomes ready when the version is built
+   std::shared_future<void> PrepareForAsync(ImageBase& Source);
+
    /// Selects the appropriate program version for this image.
    /// Also builds the program version if it was not already built.
    Program& SelectProgram(ImageBase& Source);
+
+protected:
+   uint SelectId(const ImageBase& Source);   ///< Returns the Id of the program version appropriate for this image
 };
 
 
 /// A program that operates on ImageBuffers.
-/// Contains a program version for each data type : S8, U8, S16, U16, S32, U32, F32
+/// Contains a program version for each data type : S8, U8, S16, U16, S32, U32, F32, F16
+/// Programs that process several values per work-item receive the number of values
+/// to process in the VEC_WIDTH define. It is selected for each data type from the
+/// preferred vector width of the device, see VectorWidth().
 class CL_API ImageBufferProgram : public MultiProgram
 {
 public:
@@ -178,7 +231,9 @@ public:
    /// Call PrepareFor() to have the program ready for later use.
    /// \param CL : A COpenCL instance
    /// \param Path : Path of the .cl file - must be relative to the path given by COpenCL::SetClFilesPath()
-   ImageBufferProgram(COpenCL& CL, const char * Path);
+   /// \param DefaultVectorWidth : 0 if the program processes one value per work-item, otherwise
+   ///   the VEC_WIDTH to use on devices that prefer scalar operations (like most GPUs)
+   ImageBufferProgram(COpenCL& CL, const char * Path, uint DefaultVectorWidth = 0);
 
    /// Initialize the program with source code.
    /// Program is not built by the constructor, it will be built when needed.
@@ -186,18 +241,39 @@ public:
    /// \param CL : A COpenCL instance
    /// \param fromSource : Indicates that source code is directly specified (instead of using a .cl file)
    /// \param Source : OpenCL C source code of the program
-   ImageBufferProgram(COpenCL& CL, bool fromSource, const char * Source);
+   /// \param DefaultVectorWidth : 0 if the program processes one value per work-item, otherwise
+   ///   the VEC_WIDTH to use on devices that prefer scalar operations (like most GPUs)
+   ImageBufferProgram(COpenCL& CL, bool fromSource, const char * Source, uint DefaultVectorWidth = 0);
 
    /// Build the version of the program appropriate for this image.
    /// Building can take a lot of time (100+ms) so it is better to build
    /// the program during when starting so it will be ready when needed.
    void PrepareFor(ImageBase& Source);
 
+   /// Build the version of the program appropriate for this image in a background thread.
+   /// Returns immediately, using the program with this type of image before
+   /// the build is finished will wait for the build to finish.
+   /// \return a future that becomes ready when the version is built
+   std::shared_future<void> PrepareForAsync(ImageBase& Source);
+
    /// Selects the appropriate program version for this image.
    /// Also builds the program version if it was not already built.
    Program& SelectProgram(ImageBase& Source);
 
+   /// Returns the number of values processed by each work-item for this image (VEC_WIDTH).
+   /// The preferred vector width of the device for the data type is used (CL_DEVICE_PREFERRED_VECTOR_WIDTH_*),
+   /// limited to 16. Devices that prefer scalar operations use the default vector width of the program.
+   /// Returns 1 for programs that process one value per work-item.
+   uint VectorWidth(const ImageBase& Source);
+
+protected:
+   uint SelectId(const ImageBase& Source);   ///< Returns the Id of the program version appropriate for this image
+
+   void Init(const char * Source, const char * Path, uint DefaultVectorWidth);   ///< Selects the vector widths and sets the program info
+
    const static int NbPixelTypes = SImage::NbDataTypes;  ///< Number of possible pixel types
+
+   uint m_VectorWidths[NbPixelTypes];  ///< VEC_WIDTH of each version of the program
 };
 
 // Helper functions for programs
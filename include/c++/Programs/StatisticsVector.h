@@ -30,6 +30,7 @@ namespace OpenCLIPP
 {
 
 /// A program that does statistical reductions
+/// The reductions of a batch of images (see ImageBufferBatch) give one value per image, with a single launch for the batch
 class CL_API StatisticsVector : public ImageBufferProgram
 {
 public:
@@ -47,11 +48,20 @@ public:
    double Mean(ImageBuffer& Source);          ///< Calculates the mean value of all pixel values
    double MeanSqr(ImageBuffer& Source);       ///< Calculates the mean of the square of all pixel values
 
+   std::vector<double> Min(ImageBufferBatch& Source);          ///< Finds the minimum value in each image of the batch
+   std::vector<double> Max(ImageBufferBatch& Source);          ///< Finds the maximum value in each image of the batch
+   std::vector<double> MinAbs(ImageBufferBatch& Source);       ///< Finds the minimum of the absolute of the values in each image of the batch
+   std::vector<double> MaxAbs(ImageBufferBatch& Source);       ///< Finds the maxumum of the absolute of the values in each image of the batch
+   std::vector<double> Sum(ImageBufferBatch& Source);          ///< Calculates the sum of the pixel values of each image of the batch
+   std::vector<uint>   CountNonZero(ImageBufferBatch& Source); ///< Calculates the number of non zero pixels in each image of the batch
+   std::vector<double> Mean(ImageBufferBatch& Source);         ///< Calculates the mean value of each image of the batch
+   std::vector<double> MeanSqr(ImageBufferBatch& Source);      ///< Calculates the mean of the square of the pixel values of each image of the batch
+
 protected:
    float m_Result;
    Buffer m_ResultBuffer;
 
-   void PrepareBuffer(const ImageBase& Image);
+   void PrepareBuffer(const ImageBase& Image, uint NbImages = 1);
 
    std::vector<float> m_PartialResult;
    std::shared_ptr<Buffer> m_PartialResultBuffer;
@@ -59,6 +69,13 @@ protected:
    void Init(ImageBuffer& Source);
    void InitAbs(ImageBuffer& Source);
 
+   std::vector<float> m_BatchResult;
+   std::shared_ptr<Buffer> m_BatchResultBuffer;
+
+   void Init(ImageBufferBatch& Source);
+   void InitAbs(ImageBufferBatch& Source);
+   void InitBatch(ImageBufferBatch& Source, const char * Name);
+
    StatisticsVector& operator = (StatisticsVector&);   // Not a copyable object
 };
 
@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: TresholdingVector.h
+//! @date   : Oct 2026
+//!
+//! @brief  : Tresholding operations on image buffers
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Program.h"
+#include "Tresholding.h"
+
+namespace OpenCLIPP
+{
+
+/// A program that does tresholding and comparisons on image buffers
+/// A batch of images (see ImageBufferBatch) is processed with a single launch, like one tall image
+class CL_API TresholdingVector : public ImageBufferProgram
+{
+public:
+   TresholdingVector(COpenCL& CL)
+   :  ImageBufferProgram(CL, "Vector_Treshold.cl", 8)
+   { }
+
+   typedef Tresholding::ECompareOperation ECompareOperation;
+
+   /// D = (S > Tresh ? valueHigher : S)
+   void TresholdGT(ImageBuffer& Source, ImageBuffer& Dest, float Tresh, float valueHigher = 255);
+
+   /// D = (S < Tresh ? valueLower : S)
+   void TresholdLT(ImageBuffer& Source, ImageBuffer& Dest, float Tresh, float valueLower = 0);
+
+   /// D = (S > Tresh ? valueHigher : (S < Tresh ? valueLower : S) )
+   void TresholdGTLT(ImageBuffer& Source, ImageBuffer& Dest, float threshLT, float valueLower, float treshGT, float valueHigher);
+
+   /// D = (S1 Op S2 ? S1 : S2)
+   void treshold(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuffer& Dest, ECompareOperation Op = Tresholding::GT);
+
+   /// D = (S Op V)  - D will be 0 or 1
+   void Compare(ImageBuffer& Source, ImageBuffer& Dest, float Value, ECompareOperation Op = Tresholding::GT);
+
+   /// D = (S1 Op S2) - D will be 0 or 1
+   void Compare(ImageBuffer& Source1, ImageBuffer& Source2, ImageBuffer& Dest, ECompareOperation Op = Tresholding::GT);
+};
+
+}
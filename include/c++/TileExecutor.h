@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: TileExecutor.h
+//! @date   : Oct 2026
+//!
+//! @brief  : Processing of images larger than the device limits, in tiles
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include "Image.h"
+
+#include <functional>
+
+namespace OpenCLIPP
+{
+
+/// Processes host images that are too large for the device, in tiles.
+/// The image is split in tiles that fit the device limits (CL_DEVICE_IMAGE2D_MAX_WIDTH, CL_DEVICE_IMAGE2D_MAX_HEIGHT
+/// and CL_DEVICE_MAX_MEM_ALLOC_SIZE). Each tile covers a part of the image (its core) plus a border of
+/// Halo pixels of the surrounding image, so that primitives that read neighboring pixels (filters, morphology)
+/// give the same result as on the whole image. Only the core of each tile is written to the destination.
+/// The operation is given device images of the tile and calls the primitives normally.
+/// Tiles are double buffered : the next tile is sent while the current one is processed
+/// (with a separate transfer queue, see COpenCL::UseTransferQueue(), the transfers overlap the processing).
+/// Usage :
+///   TileExecutor Tiles(CL);
+///   Tiles.Run(Source, SourceData, Dest, DestData, 2, [&](IImage& S, IImage& D) { Filters.Gauss(S, D, 5); });
+/// 3 channel images are not supported.
+class CL_API TileExecutor
+{
+public:
+   /// Operation done on each tile - Source and Dest have the size of the tile, including the halo
+   typedef std::function<void(IImage& Source, IImage& Dest)> Operation;
+
+   /// Default maximum size of the tiles, in pixels
+   static const uint DefaultTileSize = 4096;
+
+   /// Constructor.
+   /// \param CL : A COpenCL instance
+   TileExecutor(COpenCL& CL);
+
+   /// Sets the maximum size of the tiles, including their halo.
+   /// The tiles are also limited by the device limits. Smaller tiles use less device memory.
+   /// \param Size : Maximum size, in pixels
+   void SetMaxTileSize(SSize Size);
+
+   /// Returns the size of the tiles that will be used for an image, including their halo
+   /// \param Image : The host image to process
+   /// \param Halo : Number of pixels needed around each pixel by the operation
+   SSize GetTileSize(const SImage& Image, uint Halo) const;
+
+   /// Processes the image, tile by tile.
+   /// Returns when all the results have been written in DestData.
+   /// \param Source : The host image to process
+   /// \param SourceData : A pointer to where the source image data is located
+   /// \param Dest : The host image that receives the result - must have the same size as Source
+   /// \param DestData : A pointer to where the result will be written
+   /// \param Halo : Number of pixels needed around each pixel by the operation - Width / 2 for filters of Width x Width,
+   ///      Iterations * (Width / 2) for morphology, the sum of the halos for a sequence of primitives
+   /// \param Function : Operation done on each tile, must write its result in Dest
+   void Run(const SImage& Source, void * SourceData, const SImage& Dest, void * DestData,
+      uint Halo, const Operation& Function);
+
+private:
+   TileExecutor(const TileExecutor&);              // Not copyable
+   TileExecutor& operator = (const TileExecutor&);
+
+   /// A tile of the image
+   struct STile
+   {
+      SRect Region;  // Part of the image sent to the device, including the halo
+      SRect Core;    // Part of the image written by the tile
+   };
+
+   /// Device images of a tile being processed
+   struct SSlot
+   {
+      std::unique_ptr<Image> Source;
+      std::unique_ptr<TempImage> Dest;
+      std::unique_ptr<Image> Result;   // Core of the tile, read to the destination data
+   };
+
+   std::vector<STile> MakeTiles(const SImage& Image, uint Halo) const;
+   void SendTile(SSlot& Slot, const STile& Tile, const SImage& Source, void * SourceData);
+   void ProcessTile(SSlot& Slot, const STile& Tile, const SImage& Dest, void * DestData, const Operation& Function);
+   void WaitForSlot(SSlot& Slot);   // Waits until the previous tile of the slot has been read
+
+   COpenCL& m_CL;
+   SSize m_MaxTileSize;
+};
+
+}
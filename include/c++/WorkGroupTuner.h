@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////
+//! @file	: WorkGroupTuner.h
+//! @date   : Oct 2026
+//!
+//! @brief  : Automatic selection of the work-group size of kernels
+//! 
+//! Copyright (C) 2026 - CRVI
+//!
+//! This file is part of OpenCLIPP.
+//! 
+//! OpenCLIPP is free software: you can redistribute it and/or modify
+//! it under the terms of the GNU Lesser General Public License version 3
+//! as published by the Free Software Foundation.
+//! 
+//! OpenCLIPP is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//! GNU Lesser General Public License for more details.
+//! 
+//! You should have received a copy of the GNU Lesser General Public License
+//! along with OpenCLIPP.  If not, see <http://www.gnu.org/licenses/>.
+//! 
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include "Basic.h"
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <cl/cl.hpp>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace OpenCLIPP
+{
+
+class COpenCL;
+
+/// A kernel launch done with a local range selected by the tuner - see WorkGroupTuner::SelectLocalRange()
+struct SWorkGroupTrial
+{
+   SWorkGroupTrial() : Candidate(-1) { }
+
+   std::string Key;  ///< Key of the (kernel, program version, image size class)
+   int Candidate;    ///< Index of the candidate local range being timed, -1 if the launch is not timed
+};
+
+/// Automatic tuning of work-group sizes.
+/// For kernels that are launched without a specific local range, the tuner times
+/// candidate local ranges on the first launches of each (kernel, program version, image size class)
+/// and then uses the fastest one for the following launches.
+/// The launches being timed are normal launches that process the images given by the caller,
+/// so tuning does not run the kernels more often than the application does.
+/// The tuner never waits for the launches : their timings are collected by later launches, once they are complete.
+/// The fastest local ranges are saved in the binary cache folder (see COpenCL::SetBinaryCachePath())
+/// and are loaded by later runs, so tuning only needs to be done once per device.
+/// Used by COpenCL, see COpenCL::EnableWorkGroupTuning().
+class CL_API WorkGroupTuner
+{
+public:
+   /// Constructor.
+   /// Loads the results of previous tuning runs from the binary cache folder, if it is set
+   /// \param CL : The COpenCL instance of the device the kernels run on
+   WorkGroupTuner(COpenCL& CL);
+
+   /// Selects the local range for a kernel launch.
+   /// \param ProgramId : Identifies the program and its build options (see Program::GetIdentifier())
+   /// \param Kernel : The kernel to launch
+   /// \param Name : Name of the kernel
+   /// \param Global : Global range of the launch
+   /// \param Trial : Receives information to give to AddTrialResult() after the launch
+   /// \return the local range to use - cl::NullRange to let OpenCL choose
+   cl::NDRange SelectLocalRange(const std::string& ProgramId, const cl::Kernel& Kernel, const std::string& Name,
+      const cl::NDRange& Global, SWorkGroupTrial& Trial);
+
+   /// Records the event of a launch done with a local range selected by SelectLocalRange().
+   /// The events are timed once all candidates have been tried and their launches are complete,
+   /// they must come from a queue that has profiling enabled.
+   /// \param Trial : Trial filled by SelectLocalRange()
+   /// \param Event : Event of the launch
+   void AddTrialResult(const SWorkGroupTrial& Trial, const cl::Event& Event);
+
+   static const uint NbRunsPerCandidate = 3;   ///< Number of times each candidate is timed, the fastest time is kept
+
+private:
+   WorkGroupTuner(const WorkGroupTuner&);             // Not copyable
+   WorkGroupTuner& operator = (const WorkGroupTuner&);
+
+   struct STuning
+   {
+      std::vector<cl::NDRange> Candidates;   // Local ranges to try
+      uint NbLaunched;                       // Number of timed launches done so far
+      std::vector<std::pair<int, cl::Event>> Events; // Events of the timed launches, with the index of their candidate
+      bool Done;                             // true when Best is known
+      bool Measured;                         // true when Best comes from timings, from this run or from a previous one
+      cl::NDRange Best;                      // Fastest local range
+   };
+
+   void GenerateCandidates(const cl::Kernel& Kernel, const cl::NDRange& Global, STuning& Tuning) const;
+   void TryFinish(STuning& Tuning);  // Selects the best candidate if all the timed launches are complete - m_Mutex must be locked
+   void Load();
+   void Save() const;                // Rewrites the file with all the measured tunings - m_Mutex must be locked
+
+   COpenCL * m_CL;
+   cl::Device m_Device;
+   std::string m_DeviceKey;
+   std::string m_FileName;
+   std::vector<std::string> m_OtherDevices;  // Lines of the file that are for other devices, kept when saving
+   std::map<std::string, STuning> m_Tunings;
+   std::mutex m_Mutex;
+};
+
+}